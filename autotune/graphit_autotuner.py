@@ -13,7 +13,7 @@ from opentuner import Result
 from sys import exit
 import argparse
 
-py_graphitc_file = "../build/bin/graphitc.py"
+graphitc_binary = "../build/bin/graphitc"
 serial_compiler = "icc"
 par_compiler = "icpc"
 
@@ -59,6 +59,9 @@ class GraphItTuner(MeasurementInterface):
             manipulator.add_parameter(EnumParameter('parallelization', ['serial']))
 
         manipulator.add_parameter(IntegerParameter('numSSG', 1, self.args.max_num_segments))
+
+        # switch point of the hybrid directions, a fixed numEdges / threshold or the measured costs
+        manipulator.add_parameter(EnumParameter('directionThreshold', ['10', '20', '50', 'adaptive']))
         
         if self.enable_NUMA_tuning:
             manipulator.add_parameter(EnumParameter('NUMA',['serial','static-parallel']))
@@ -95,8 +98,14 @@ class GraphItTuner(MeasurementInterface):
 
                 new_schedule = new_schedule + "\n    program->configApplyParallelization(\"s1\", \"dynamic-vertex-parallel\",1024,  \"SparsePush\");"
 
+            elif direction == "DensePush-SparsePush":
+                # the DensePush direction chunks the sources by out edges, SparsePush stays vertex-parallel
+                new_schedule = new_schedule + "\n    program->configApplyParallelization(\"s1\", \"edge-aware-dynamic-vertex-parallel\",1024,  \"DensePush\");"
+
+                new_schedule = new_schedule + "\n    program->configApplyParallelization(\"s1\", \"dynamic-vertex-parallel\",1024,  \"SparsePush\");"
+
             else:
-                #use_evp for SparsePush, DensePush-SparsePush should not make a difference
+                #use_evp for SparsePush should not make a difference
                 new_schedule = new_schedule + "\n    program->configApplyParallelization(\"s1\", \"dynamic-vertex-parallel\");"
         else:
             print ("Error in writing parallel schedule")
@@ -112,6 +121,17 @@ class GraphItTuner(MeasurementInterface):
             new_schedule = new_schedule + "\n    program->configApplyNumSSG(\"s1\", \"fixed-vertex-count\", " + str(numSSG) + ", \"DensePull\");"
         return new_schedule
 
+    def write_direction_threshold_schedule(self, threshold, new_schedule, direction):
+        # only the hybrid directions switch, 20 is the default threshold
+        if threshold == '20':
+            return new_schedule
+        if direction == "SparsePush-DensePull" or direction == "DensePush-SparsePush":
+            if threshold == 'adaptive':
+                new_schedule = new_schedule + "\n    program->configApplyDirectionThreshold(\"s1\", \"adaptive\");"
+            else:
+                new_schedule = new_schedule + "\n    program->configApplyDirectionThreshold(\"s1\", " + threshold + ");"
+        return new_schedule
+
     def write_NUMA_schedule(self,  new_schedule, direction):
         # configuring NUMA optimization for DensePull direction
         if self.use_NUMA:
@@ -147,6 +167,7 @@ class GraphItTuner(MeasurementInterface):
         new_schedule = self.write_par_schedule(cfg, new_schedule, direction)
         new_schedule = self.write_numSSG_schedule(numSSG, new_schedule, direction)
         new_schedule = self.write_NUMA_schedule(new_schedule, direction)
+        new_schedule = self.write_direction_threshold_schedule(cfg['directionThreshold'], new_schedule, direction)
 
         use_bitvector = False
         if cfg['DenseVertexSet'] == 'bitvector':
@@ -170,7 +191,8 @@ class GraphItTuner(MeasurementInterface):
 
 
         #compile the schedule file along with the original algorithm file
-        compile_graphit_cmd = 'python ' + py_graphitc_file +  ' -a  {algo_file} -f {schedule_file} -i ../include/ -l ../build/lib/libgraphitlib.a  -o test.cpp'.format(algo_file=self.args.algo_file, schedule_file=self.new_schedule_file_name) 
+        #graphitc interprets the schedule file directly, no compiler rebuild per configuration
+        compile_graphit_cmd = graphitc_binary + ' -f {algo_file} -s {schedule_file} -o test.cpp'.format(algo_file=self.args.algo_file, schedule_file=self.new_schedule_file_name) 
 
         if not self.use_NUMA:
             if not self.enable_parallel_tuning:
@@ -16,7 +16,8 @@ namespace graphit {
 
         }
 
-        int emitCPP(std::ostream &oss = std::cout, std::string module_name="");
+        int emitCPP(std::ostream &oss = std::cout, std::string module_name="", bool instrument_applies = false,
+                    bool work_stealing = false);
     	int emitPython(std::ostream &oss = std::cout, std::string module_name="", std::string module_path="");
 
     private:
@@ -9,16 +9,20 @@
 #include <graphit/midend/mir_visitor.h>
 #include <graphit/midend/mir_context.h>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <graphit/backend/gen_edge_apply_func_decl.h>
 
 namespace graphit {
     class CodeGenCPP : mir::MIRVisitor{
     public:
-        CodeGenCPP(std::ostream &input_oss, MIRContext *mir_context, std::string module_name_):
-                oss(input_oss), mir_context_(mir_context), module_name(module_name_) {
+        CodeGenCPP(std::ostream &input_oss, MIRContext *mir_context, std::string module_name_,
+                   bool instrument_applies = false, bool work_stealing = false):
+                oss(input_oss), mir_context_(mir_context), module_name(module_name_),
+                instrument_applies_(instrument_applies), work_stealing_(work_stealing) {
             indentLevel = 0;
-            edgeset_apply_func_gen_ = new EdgesetApplyFunctionDeclGenerator(mir_context_, oss);
+            edgeset_apply_func_gen_ = new EdgesetApplyFunctionDeclGenerator(mir_context_, oss, instrument_applies_,
+                                                                            work_stealing_);
         }
 
         int genCPP();
@@ -106,6 +110,12 @@ namespace graphit {
 
         MIRContext * mir_context_;
         EdgesetApplyFunctionDeclGenerator* edgeset_apply_func_gen_;
+        // record performance counters around labeled edgeset applies (graphitc -c)
+        bool instrument_applies_;
+        // parallel vertexset applies run on the work-stealing scheduler (graphitc -w)
+        bool work_stealing_;
+        // element type the vector reads are gathered into while the SIMD value of a pull reduction is printed
+        std::string simd_value_type_;
 
         void genElementData();
 
@@ -116,6 +126,14 @@ namespace graphit {
         // generate the call to the right edgeset apply function with all the arguments
         void genEdgesetApplyFunctionCall(mir::EdgeSetApplyExpr::Ptr apply);
 
+        // start and stop the performance counters of a labeled edgeset apply,
+        // result is the variable holding the returned frontier ("" if there is none)
+        void genApplyCounterBegin(mir::EdgeSetApplyExpr::Ptr apply, std::string label);
+        void genApplyCounterEnd(mir::EdgeSetApplyExpr::Ptr apply, std::string label, std::string result);
+
+        // the pullValue and pullReduce members of an apply function reduced with the SIMD pull kernel
+        void genSimdPullReduce(mir::FuncDecl::Ptr func_decl);
+
         void genPropertyArrayDecl(mir::VarDecl::Ptr shared_ptr);
 
         void genPropertyArrayAlloc(mir::VarDecl::Ptr shared_ptr);
@@ -126,6 +144,19 @@ namespace graphit {
 
         void genTypesRequiringTypeDefs();
 	
+	    bool hasExportedFunction();
+
+	    std::vector<mir::VarDecl::Ptr> getInitializedScalarConstants();
+
+	    // fields with a copy per socket: the merge fields of the NUMA aware applies and the fields they replicate
+	    std::map<std::string, mir::ScalarType::Ptr> getNumaLocalFields();
+
+	    // the fields replicated on every socket (configVectorNUMA replicated) for a NUMA aware apply
+	    std::set<std::string> getNumaReplicatedFields();
+
+	    // marks the copies of a replicated field as stale after a statement writes the field (lhs)
+	    void genReplicaStaleMark(mir::Expr::Ptr lhs);
+
 	    void generatePyBindWrapper(mir::FuncDecl::Ptr);
 
     	void generatePyBindModule();
@@ -11,6 +11,8 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <set>
+#include <algorithm>
 
 namespace graphit {
 
@@ -24,8 +26,10 @@ namespace graphit {
         virtual void visit (mir::HybridDenseEdgeSetApplyExpr::Ptr hybrid_dense_apply);
         virtual void visit (mir::HybridDenseForwardEdgeSetApplyExpr::Ptr hybrid_dense_forward_apply);
 
-        EdgesetApplyFunctionDeclGenerator(MIRContext* mir_context, std::ostream& oss)
-                : mir_context_(mir_context), oss_ (oss){
+        EdgesetApplyFunctionDeclGenerator(MIRContext* mir_context, std::ostream& oss,
+                                          bool instrument_applies = false, bool work_stealing = false)
+                : mir_context_(mir_context), oss_ (oss), instrument_applies_(instrument_applies),
+                  work_stealing_(work_stealing){
             indentLevel = 0;
         }
 
@@ -47,11 +51,22 @@ namespace graphit {
     private:
         MIRContext* mir_context_;
         std::ostream &oss_;
+        // hybrid applies report the direction they pick to the performance counters
+        bool instrument_applies_;
+        // the parallel loops over vertices run on the work-stealing scheduler (graphitc -w)
+        bool work_stealing_;
+        // names of the edgeset apply functions already declared
+        std::set<std::string> generated_func_names_;
 
         void genEdgeApplyFunctionSignature(mir::EdgeSetApplyExpr::Ptr apply);
         void genEdgeApplyFunctionDeclaration(mir::EdgeSetApplyExpr::Ptr apply);
         void genEdgeApplyFunctionDeclBody(mir::EdgeSetApplyExpr::Ptr apply);
 
+        // header of the loop over [begin, end), a builtin_parallelFor lambda for parallel loops with graphitc -w
+        std::string genLoopBegin(bool parallel, std::string type, std::string var, std::string begin, std::string end);
+        // closes a loop of genLoopBegin, grain is the grain size of builtin_parallelFor if not the default
+        std::string genLoopEnd(bool parallel, std::string grain = "");
+
         void indent() { ++indentLevel; }
         void dedent() { --indentLevel; }
         void printIndent() { oss_ << std::string(2 * indentLevel, ' '); }
@@ -63,6 +78,8 @@ namespace graphit {
         void genEdgePushApplyFunctionDeclBody(mir::EdgeSetApplyExpr::Ptr apply);
         void genEdgeHybridDenseApplyFunctionDeclBody(mir::EdgeSetApplyExpr::Ptr apply);
         void genEdgeHybridDenseForwardApplyFunctionDeclBody(mir::EdgeSetApplyExpr::Ptr apply);
+
+        void genEdgeOrderedApplyFunctionDeclBody(mir::EdgeSetApplyExpr::Ptr apply);
         void setupGlobalVariables(mir::EdgeSetApplyExpr::Ptr apply,
                                   bool apply_expr_gen_frontier,
                                   bool from_vertexset_specified);
@@ -91,6 +108,9 @@ namespace graphit {
                                                          bool apply_expr_gen_frontier,
                                                          std::string dst_type);
 
+        // opens the branch of the dense direction of a hybrid apply, dense_work is the work of that direction
+        void printHybridDirectionSwitch(mir::EdgeSetApplyExpr::Ptr apply, std::string dense_work);
+
         void printDenseForwardEdgeTraversalReturnFrontier(mir::EdgeSetApplyExpr::Ptr apply,
                                                                 bool from_vertexset_specified,
                                                                 bool apply_expr_gen_frontier,
@@ -109,6 +129,12 @@ namespace graphit {
 
         void printNumaScatter(mir::EdgeSetApplyExpr::Ptr apply);
 
+        // the apply traverses the segments built for its label (cache optimization)
+        bool isCacheAware(mir::EdgeSetApplyExpr::Ptr apply);
+
+        // neighbors of vertex in the edge layout chosen by the schedule
+        std::string genNeighborhood(mir::EdgeSetApplyExpr::Ptr apply, bool in_neighbors, std::string vertex);
+
     };
 }
 
@@ -1647,6 +1647,8 @@ namespace graphit {
             ToExpr::Ptr                to_expr;
             Identifier::Ptr            change_tracking_field;
             bool disable_deduplication = false;
+            // applyUpdatePriority: process the from vertexset in the order of change_tracking_field
+            bool is_ordered = false;
 
             typedef std::shared_ptr<ApplyExpr> Ptr;
 
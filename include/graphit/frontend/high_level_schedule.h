@@ -43,7 +43,8 @@ namespace graphit {
                     parallelCompatibilityMap_ = {
                             {"dynamic-vertex-parallel", "parallel"},
                             {"static-vertex-parallel", "parallel"},
-                            {"edge-aware-dynamic-vertex-parallel", "parallel"}
+                            {"edge-aware-dynamic-vertex-parallel", "parallel"},
+                            {"edge-parallel", "parallel"}
                     };
 
                 }
@@ -63,6 +64,12 @@ namespace graphit {
                 // High level API for fusing together multiple fields / system vectors as ArrayOfStructs
                 ProgramScheduleNode::Ptr fuseFields(std::vector<std::string> fields);
 
+                // High level API for placing a field / system vector on the NUMA nodes
+                // Configs: first-touch (default), interleaved, partitioned (blocks of vertices on the nodes that
+                // own them in a static partition), replicated (a copy per socket for fields the NUMA aware applies
+                // only read)
+                ProgramScheduleNode::Ptr configVectorNUMA(string vector_name, string config);
+
                 // High level API for splitting one loop into two loops
                 ProgramScheduleNode::Ptr splitForLoop(string original_loop_label,
                                                       string split_loop1_label,
@@ -96,8 +103,11 @@ namespace graphit {
                 // High lvel API for speicifying parallelization scheduling options for apply
                 // A wrapper around setApply for now.
                 // Scheduling Options include VertexParallel, EdgeAwareVertexParallel
+                // and EdgeParallel (push only, grain_size is then the number of edges per chunk)
+                // EdgeAwareVertexParallel for the DensePush direction chunks the sources by out edges (grain_size per chunk)
+                // grain_size -1 keeps the default grain size of the strategy
                 high_level_schedule::ProgramScheduleNode::Ptr
-                configApplyParallelization(std::string apply_label, std::string apply_schedule, int grain_size=1024, std::string direction = "all");
+                configApplyParallelization(std::string apply_label, std::string apply_schedule, int grain_size=-1, std::string direction = "all");
 
                 // High lvel API for speicifying deduplication scheduling options for apply
                 // A wrapper around setApply for now.
@@ -132,6 +142,9 @@ namespace graphit {
                 }
 
                 // High level API for specifying the number of segments for a particular direction
+                // DensePull segments the sources of the in edges, DensePush the destinations of the out edges
+                // config is fixed-vertex-count (same number of vertices per segment) or edge-aware-vertex-count
+                // (segment boundaries chosen so that every segment gets about the same number of edges)
                 high_level_schedule::ProgramScheduleNode::Ptr
                 configApplyNumSSG(std::string apply_label, std::string config, int num_segment, std::string direction="all");
 
@@ -140,6 +153,49 @@ namespace graphit {
                 high_level_schedule::ProgramScheduleNode::Ptr
                 configApplyNumSSG(std::string apply_label, std::string config, string num_segment_argv, std::string direction="all");
 
+                // High level API for specifying the bucket width (delta) of the priority queue
+                // used by an ordered apply (applyUpdatePriority). Vertices whose priorities fall
+                // in the same bucket are processed together, larger deltas expose more parallelism
+                // at the cost of redundant updates
+                high_level_schedule::ProgramScheduleNode::Ptr
+                configApplyPriorityUpdateDelta(std::string apply_label, int delta);
+
+                // High level API for the switch of the hybrid directions (SparsePush-DensePull and
+                // SparsePush-DensePush). The dense direction is used once the frontier and its out edges
+                // exceed numEdges / threshold (default 20). "adaptive" picks the direction of every round
+                // from the measured push and dense costs of the previous rounds, "fixed" uses the threshold only
+                high_level_schedule::ProgramScheduleNode::Ptr
+                configApplyDirectionThreshold(std::string apply_label, int threshold);
+
+                high_level_schedule::ProgramScheduleNode::Ptr
+                configApplyDirectionThreshold(std::string apply_label, std::string config);
+
+                // High level API for how the SparsePush direction builds the next frontier
+                // Options are edge-array (default, one slot per frontier edge filtered afterwards)
+                // and thread-local-buffers (per thread buffers merged with a prefix sum)
+                high_level_schedule::ProgramScheduleNode::Ptr
+                configApplyFrontierOutput(std::string apply_label, std::string config);
+
+                // High level API for specifying the physical layout of the edges traversed by an apply
+                // Options are csr (default), byte-compressed and nibble-compressed. The compressed layouts
+                // store the sorted neighbors delta coded and the traversal decodes them in place
+                high_level_schedule::ProgramScheduleNode::Ptr
+                configApplyEdgeLayout(std::string apply_label, std::string config);
+
+                // High level API for the inner loop of the DensePull direction
+                // Options are scalar (default, one apply function call per in-neighbor) and simd, which
+                // gathers the values of the in-neighbors with AVX2/AVX-512 and reduces them into the
+                // destination. simd needs an apply function that only does dst_field[dst] += (or min=)
+                // an expression read from src
+                high_level_schedule::ProgramScheduleNode::Ptr
+                configApplyPullKernel(std::string apply_label, std::string config);
+
+                // High level API for relabeling the vertices of the edgeset traversed by an apply when it is loaded
+                // Options are original (default), degree-sort, hub-cluster and rcm. Vertex ids of the input
+                // (argv, literals) used in the main function are translated, so the program sees the original ids
+                high_level_schedule::ProgramScheduleNode::Ptr
+                configApplyVertexOrder(std::string apply_label, std::string config);
+
                 // High level API for enabling NUMA optimization
                 // Deprecated, to be replaced with configApplyNUMA
                 high_level_schedule::ProgramScheduleNode::Ptr
@@ -157,7 +213,7 @@ namespace graphit {
 
 
                 // High lvel API for speicifying scheduling options for apply
-                // Scheduling Options include load balance with edge grain size
+                // Scheduling Options include load balance with edge grain size, num_segment and delta
                 high_level_schedule::ProgramScheduleNode::Ptr
                 setApply(std::string apply_label, std::string apply_schedule, int param);
 
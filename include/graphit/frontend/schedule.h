@@ -28,6 +28,18 @@ namespace graphit {
         std::string fused_struct_name;
     };
 
+    // placement of the pages of a field vector on the NUMA nodes
+    enum class FieldVectorNumaPlacement {
+        // pages land on the node of the thread that first writes them (the default)
+        FIRST_TOUCH,
+        // pages are spread round robin over the nodes
+        INTERLEAVED,
+        // contiguous blocks of vertices live on the node that owns them in a static vertex partition
+        PARTITIONED,
+        // read only fields get a copy per socket, read by the NUMA aware applies
+        REPLICATED
+    };
+
     struct VertexsetPhysicalLayout {
         enum class DataLayout {
             SPARSE,
@@ -51,7 +63,9 @@ namespace graphit {
             // partitioning the graph with a fixed number of vertices
                     FixedVertexCount,
             //partitioning the graph with a flexible number of vertices, but similar number of edges
-                    EdgeAwareVertexCount
+                    EdgeAwareVertexCount,
+            //partitioning the edges of the frontier into chunks with a fixed number of edges
+                    FixedEdgeCount
         };
         enum class FT_Tag {
             //Dense Bitvector
@@ -175,6 +189,39 @@ namespace graphit {
                 EDGE_BASED
             };
 
+            enum class PushLoadBalance {
+                VERTEX_BASED,
+                EDGE_BASED
+            };
+
+            enum class EdgeLayout {
+                CSR,
+                BYTE_COMPRESSED,
+                NIBBLE_COMPRESSED
+            };
+
+            enum class VertexOrder {
+                ORIGINAL,
+                DEGREE_SORT,
+                HUB_CLUSTER,
+                RCM
+            };
+
+            enum class SegmentPartition {
+                FIXED_VERTEX_COUNT,
+                EDGE_AWARE_VERTEX_COUNT
+            };
+
+            enum class FrontierOutput {
+                EDGE_ARRAY,
+                THREAD_LOCAL_BUFFERS
+            };
+
+            enum class PullKernel {
+                SCALAR,
+                SIMD
+            };
+
             std::string scope_label_name;
             DirectionType direction_type;
             ParType parallel_type;
@@ -189,6 +236,30 @@ namespace graphit {
             int pull_load_balance_edge_grain_size;
             int num_segment;
             bool numa_aware;
+            // bucket width of the priority queue used by ordered applies (applyUpdatePriority)
+            int delta;
+            PushLoadBalance push_load_balance_type;
+            // number of frontier edges in each chunk for the edge based push schedule,
+            // 0 keeps the default (4096)
+            int push_load_balance_edge_grain_size;
+            // physical layout of the neighbor lists traversed by the apply
+            EdgeLayout edge_layout;
+            // order the vertices of the traversed edgeset are relabeled in when it is loaded
+            VertexOrder vertex_order;
+            // how the vertices are split into the segments of num_segment
+            SegmentPartition segment_partition;
+            // hybrid applies go dense once the frontier touches more than numEdges / direction_threshold edges
+            int direction_threshold;
+            // hybrid applies pick the direction from the measured cost of the previous rounds
+            bool adaptive_direction;
+            PushLoadBalance dense_push_load_balance_type;
+            // number of out edges in each chunk of sources for the edge based dense push schedule,
+            // 0 keeps the default (4096)
+            int dense_push_load_balance_edge_grain_size;
+            // how the sparse push direction collects the vertices of the next frontier
+            FrontierOutput frontier_output;
+            // how the pull direction reduces the in-neighbors of a vertex
+            PullKernel pull_kernel;
         };
 
         /**
@@ -217,7 +288,7 @@ namespace graphit {
             // this is a vector of graph iteration spaces because we can have up to two graph iteration spaces (for hybrid directions)
             std::map<std::string, std::vector<GraphIterationSpace> *> *graph_iter_spaces;
             std::map<std::string, VertexsetPhysicalLayout> vertexset_data_layout;
-
+            std::map<std::string, FieldVectorNumaPlacement> vector_numa_placements;
 
         };
     }
@@ -0,0 +1,65 @@
+#ifndef GRAPHIT_SCHEDULE_INTERPRETER_H
+#define GRAPHIT_SCHEDULE_INTERPRETER_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <graphit/frontend/high_level_schedule.h>
+#include <graphit/frontend/error.h>
+
+namespace graphit {
+
+    // Splits a .gt program at its "schedule:" line, the same way graphitc.py does.
+    // Returns the line number of the "schedule:" line, or 0 if there is no schedule block.
+    int splitScheduleBlock(std::istream &input, std::string &algorithm, std::string &schedule);
+
+    // Interprets the body of a schedule block (program->configApplyDirection("s1", "DensePull")->...;)
+    // against a ProgramScheduleNode, so that schedules can be changed without rebuilding graphitc.
+    // Accepts the subset of C++ used by schedules: chained calls on "program" with string literal,
+    // integer and {string, ...} arguments, terminated by ';'. Comments are ignored.
+    class ScheduleInterpreter {
+    public:
+        ScheduleInterpreter(fir::high_level_schedule::ProgramScheduleNode::Ptr program,
+                            std::vector<ParseError> *errors)
+                : program_(program), errors_(errors) {}
+
+        // first_line is the line number of the schedule text inside its file, used for error messages
+        // Returns false if the schedule could not be interpreted, the reasons are added to errors
+        bool interpret(const std::string &schedule, int first_line = 1);
+
+    private:
+        struct Token {
+            enum class Type {IDENT, STRING, INT, ARROW, LPAREN, RPAREN, LBRACE, RBRACE, COMMA, SEMICOLON, END};
+            Type type;
+            std::string str;
+            int line;
+            int column;
+        };
+
+        struct Argument {
+            enum class Type {STRING, INT, STRING_LIST};
+            Type type;
+            std::string str;
+            int num;
+            std::vector<std::string> list;
+        };
+
+        fir::high_level_schedule::ProgramScheduleNode::Ptr program_;
+        std::vector<ParseError> *errors_;
+        std::vector<Token> tokens_;
+        unsigned current_;
+
+        bool tokenize(const std::string &schedule, int first_line);
+        bool parseStatement();
+        bool parseCall();
+        bool parseArgument(Argument &arg);
+        bool expect(Token::Type type, const std::string &what);
+        void reportError(const Token &token, const std::string &msg);
+
+        // Calls the ProgramScheduleNode method matching the name and argument types
+        bool apply(const std::string &method, const std::vector<Argument> &args);
+        static bool matches(const std::vector<Argument> &args, const std::string &signature);
+    };
+}
+
+#endif //GRAPHIT_SCHEDULE_INTERPRETER_H
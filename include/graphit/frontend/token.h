@@ -42,6 +42,7 @@ namespace graphit {
             INOUT,
             APPLY,
             APPLYMODIFIED,
+            APPLYUPDATEPRIORITY,
             MAP,
             TO,
             WITH,
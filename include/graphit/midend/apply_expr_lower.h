@@ -36,6 +36,10 @@ namespace graphit {
             //Lowers edgeset apply expressions
             virtual void visit(mir::EdgeSetApplyExpr::Ptr edgeset_apply_expr);
             virtual void visit(mir::VertexSetApplyExpr::Ptr vertexset_apply_expr);
+            //Records the edgesets passed to builtins that read the CSR arrays
+            virtual void visit(mir::Call::Ptr call);
+
+            void lowerEdgeSetApply(mir::EdgeSetApplyExpr::Ptr edgeset_apply_expr);
 
             Schedule * schedule_;
             MIRContext* mir_context_;
@@ -32,6 +32,36 @@ namespace graphit {
             mir::MergeReduceField::Ptr merge_reduce_ = nullptr;
         };
 
+        // collects the field vectors the apply function writes
+        struct WrittenFieldVisitor : public mir::MIRVisitor {
+            virtual void visit(mir::AssignStmt::Ptr assign_stmt);
+
+            virtual void visit(mir::ReduceStmt::Ptr reduce_stmt);
+
+            virtual void visit(mir::CompareAndSwapStmt::Ptr cas_stmt);
+
+            std::set<std::string> written_fields;
+
+        private:
+            void addWrittenField(mir::Expr::Ptr lhs);
+        };
+
+        // redirects the reads of the replicated fields to the copy on the socket
+        struct ReplicatedReadVisitor : public mir::MIRVisitor {
+            ReplicatedReadVisitor(MIRContext *mir_context, Schedule *schedule, std::set<std::string> written_fields,
+                                  mir::MergeReduceField::Ptr merge_reduce)
+                    : mir_context_(mir_context), schedule_(schedule), written_fields_(written_fields),
+                      merge_reduce_(merge_reduce) {}
+
+            virtual void visit(mir::TensorArrayReadExpr::Ptr tensor_read);
+
+        private:
+            MIRContext *mir_context_ = nullptr;
+            Schedule *schedule_ = nullptr;
+            std::set<std::string> written_fields_;
+            mir::MergeReduceField::Ptr merge_reduce_ = nullptr;
+        };
+
         struct ApplyExprVisitor : public mir::MIRVisitor {
 
             ApplyExprVisitor(MIRContext *mir_context, Schedule *schedule) :
@@ -747,6 +747,8 @@ namespace graphit {
             typedef std::shared_ptr<VertexSetApplyExpr> Ptr;
             //default to parallel
             bool is_parallel = true;
+            // relabeled edgeset whose original vertex order a serial apply over all vertices follows
+            std::string relabeled_edgeset = "";
 
             virtual void accept(MIRVisitor *visitor) {
                 visitor->visit(self<VertexSetApplyExpr>());
@@ -776,10 +778,25 @@ namespace graphit {
             ScalarType::Ptr scalar_type;
             ReduceStmt::ReductionOp reduce_op;
             bool numa_aware;
+            // fields the apply function only reads, read from their copy on the socket (configVectorNUMA replicated)
+            std::vector<std::string> replicated_fields;
 
             typedef std::shared_ptr<MergeReduceField> Ptr;
         };
 
+        // pull apply function of the form target[dst] += value (or min=), where value only reads src,
+        // so the values of the in-neighbors can be gathered and reduced with SIMD (configApplyPullKernel)
+        struct SimdPullReduce {
+            TensorReadExpr::Ptr target;
+            Expr::Ptr value;
+            ScalarType::Ptr scalar_type;
+            // SUM or MIN
+            ReduceStmt::ReductionOp reduce_op;
+            std::string src_name;
+
+            typedef std::shared_ptr<SimdPullReduce> Ptr;
+        };
+
         struct EdgeSetApplyExpr : public ApplyExpr {
             std::string from_func = "";
             std::string to_func = "";
@@ -791,6 +808,25 @@ namespace graphit {
             bool use_pull_edge_based_load_balance = false;
             //hard coded default value for grain size
             int pull_edge_based_load_balance_grain_size = 4096;
+            // push splits the edges of the frontier into chunks of this many edges
+            bool use_push_edge_based_load_balance = false;
+            int push_edge_based_load_balance_grain_size = 4096;
+            // dense push walks the sources in chunks of vertices covering this many out edges
+            bool use_dense_push_edge_based_load_balance = false;
+            int dense_push_edge_based_load_balance_grain_size = 4096;
+            // sparse push collects the next frontier in per thread buffers instead of one slot per frontier edge
+            bool use_thread_local_frontier = false;
+            // dense pull reduces the in-neighbors with the SIMD kernel of the apply function (SimdPullReduce)
+            bool use_simd_pull = false;
+            // runtime code of the compressed edge layout (ByteCode or NibbleCode), empty for CSR
+            std::string compressed_edge_code = "";
+            // applyUpdatePriority: the from vertexset is processed in buckets of tracking_field values
+            bool is_ordered = false;
+            int priority_update_delta = 1;
+            // hybrid applies go dense once the frontier touches more than numEdges / direction_threshold edges,
+            // adaptive ones once the measured costs of the previous rounds favor the dense direction
+            int direction_threshold = 20;
+            bool adaptive_direction = false;
             std::string scope_label_name;
 	        MergeReduceField::Ptr merge_reduce;
             typedef std::shared_ptr<EdgeSetApplyExpr> Ptr;
@@ -818,6 +854,7 @@ namespace graphit {
                 tracking_field = edgeset_apply->tracking_field;
                 is_weighted = edgeset_apply->is_weighted;
                 is_parallel = edgeset_apply->is_parallel;
+                is_ordered = edgeset_apply->is_ordered;
             }
 
             virtual void accept(MIRVisitor *visitor) {
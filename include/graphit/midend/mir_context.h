@@ -10,6 +10,7 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <set>
 #include <utility>
 
 #include <graphit/utils/scopedmap.h>
@@ -361,9 +362,32 @@ namespace graphit {
             // used by cache/numa optimization
 	        std::map<std::string, std::map<std::string, int>> edgeset_to_label_to_num_segment;
 
+            // labels whose segments partition the out edges by destination (DensePush),
+            // the segments of the other labels partition the in edges by source (DensePull)
+            std::map<std::string, std::set<std::string>> edgeset_to_push_segment_labels;
+            // labels whose segment boundaries balance the number of edges instead of the number of vertices
+            std::map<std::string, std::set<std::string>> edgeset_to_edge_aware_segment_labels;
+
             // used by numa optimization
             std::map<std::string, std::map<std::string, mir::MergeReduceField::Ptr>> edgeset_to_label_to_merge_reduce;
 
+            // apply functions reduced with the SIMD pull kernel, by name
+            std::map<std::string, mir::SimdPullReduce::Ptr> function_to_simd_pull_reduce;
+
+            // runtime function that places a field vector on the NUMA nodes after its allocation
+            // (builtin_numaInterleave or builtin_numaPartition)
+            std::map<std::string, std::string> vector_to_numa_placement;
+
+            // runtime code of the compressed copy built for an edgeset (ByteCode or NibbleCode)
+            std::map<std::string, std::string> edgeset_to_compressed_edge_code;
+
+            // edgesets whose CSR arrays are read by an uncompressed apply or a builtin (transpose, random
+            // neighbors, spanning tree), the others free them once their compressed copy is built
+            std::set<std::string> edgesets_with_csr_uses;
+
+            // runtime vertex order (VertexOrder::...) an edgeset is relabeled in when it is loaded
+            std::map<std::string, std::string> edgeset_to_vertex_order;
+
             std::set<std::string> defined_types;
 
             std::vector<mir::Type::Ptr> types_requiring_typedef;
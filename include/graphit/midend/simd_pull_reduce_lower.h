@@ -0,0 +1,52 @@
+#ifndef GRAPHIT_SIMD_PULL_REDUCE_LOWER_H
+#define GRAPHIT_SIMD_PULL_REDUCE_LOWER_H
+
+#include <graphit/midend/mir_context.h>
+#include <graphit/midend/mir_visitor.h>
+
+namespace graphit {
+
+    /**
+     * Checks the applies scheduled with the SIMD pull kernel (configApplyPullKernel) and extracts the reduction
+     * of their apply functions into the mir context. The apply function has to be a single side effect free
+     * reduction target[dst] += value or target[dst] min= value, where value is arithmetic (+, -, *, /) on
+     * literals, global scalars and vectors read at src. The value is computed in the type of the target, so
+     * the vectors read have that type or int, and integer divisions are not vectorized.
+     */
+    class SimdPullReduceLower {
+    public:
+        SimdPullReduceLower(MIRContext *mir_context) : mir_context_(mir_context) {}
+
+        void lower();
+
+        struct ApplyExprVisitor : public mir::MIRVisitor {
+            ApplyExprVisitor(MIRContext *mir_context) : mir_context_(mir_context) {}
+
+            virtual void visit(mir::PullEdgeSetApplyExpr::Ptr apply_expr);
+
+            virtual void visit(mir::PushEdgeSetApplyExpr::Ptr apply_expr);
+
+            virtual void visit(mir::HybridDenseEdgeSetApplyExpr::Ptr apply_expr);
+
+            virtual void visit(mir::HybridDenseForwardEdgeSetApplyExpr::Ptr apply_expr);
+
+        private:
+            MIRContext *mir_context_ = nullptr;
+
+            void rejectSimdPull(mir::EdgeSetApplyExpr::Ptr apply_expr);
+
+            mir::SimdPullReduce::Ptr analyzeApplyFunction(mir::FuncDecl::Ptr apply_func);
+
+            // the scalar type the expression is computed in by C++, nullptr if it can not be vectorized
+            mir::ScalarType::Ptr valueType(mir::Expr::Ptr expr, mir::SimdPullReduce::Ptr reduce, std::string dst_name);
+
+            // name and element type of a vector read at index_name, empty name if expr is not such a read
+            std::string readVector(mir::Expr::Ptr expr, std::string index_name, mir::ScalarType::Ptr &scalar_type);
+        };
+
+    private:
+        MIRContext *mir_context_ = nullptr;
+    };
+}
+
+#endif //GRAPHIT_SIMD_PULL_REDUCE_LOWER_H
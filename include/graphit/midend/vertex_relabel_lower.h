@@ -0,0 +1,47 @@
+#ifndef GRAPHIT_VERTEX_RELABEL_LOWER_H
+#define GRAPHIT_VERTEX_RELABEL_LOWER_H
+
+#include <graphit/midend/mir_context.h>
+#include <graphit/midend/mir_visitor.h>
+
+namespace graphit {
+
+    /**
+     * Translates the vertex ids that enter the program as integers (argv, literals) when an edgeset
+     * is relabeled at load time. In functions that do not take vertices or edges as arguments (main),
+     * integer indices of vectors of the element, integer arguments of addVertex and integers assigned
+     * to vertex variables are mapped to the relabeled ids, and serial applies over all vertices visit
+     * them in the original order, so the program observes the ids of the input.
+     */
+    class VertexRelabelLower {
+    public:
+        VertexRelabelLower(MIRContext *mir_context) : mir_context_(mir_context) {}
+
+        void lower();
+
+        struct VertexIdTranslator : public mir::MIRVisitor {
+            VertexIdTranslator(MIRContext *mir_context, std::string element, std::string edgeset)
+                    : mir_context_(mir_context), element_(element), edgeset_(edgeset) {}
+
+            virtual void visit(mir::TensorReadExpr::Ptr tensor_read);
+            virtual void visit(mir::Call::Ptr call);
+            virtual void visit(mir::VarDecl::Ptr var_decl);
+            virtual void visit(mir::AssignStmt::Ptr assign_stmt);
+            virtual void visit(mir::VertexSetApplyExpr::Ptr apply_expr);
+
+        private:
+            MIRContext *mir_context_;
+            // the element whose ids are relabeled and the edgeset that holds the permutation
+            std::string element_;
+            std::string edgeset_;
+
+            bool isElement(mir::Type::Ptr type);
+            mir::Expr::Ptr translate(mir::Expr::Ptr vertex);
+        };
+
+    private:
+        MIRContext *mir_context_;
+    };
+}
+
+#endif //GRAPHIT_VERTEX_RELABEL_LOWER_H
@@ -23,12 +23,15 @@ protected:
     char** argv_;
     std::string name_;
     // f: means -f flag requires a follow on name,
-    std::string get_args_ = "f:o:p:m:h";
+    std::string get_args_ = "f:o:p:m:s:cwh";
     std::vector<std::string> help_strings_;
     std::string input_filename_ = "";
     std::string output_filename_ = "";
     std::string python_module_path_ = "";
     std::string python_module_name_ = ""; 
+    std::string schedule_filename_ = "";
+    bool instrument_applies_ = false;
+    bool work_stealing_ = false;
 
 
     void AddHelpLine(char opt, std::string opt_arg, std::string text,
@@ -52,6 +55,9 @@ public:
         AddHelpLine('o', "", "output file");
 	AddHelpLine('p', "", "Python module path");
 	AddHelpLine('m', "", "Python module name");
+        AddHelpLine('s', "file", "schedule file, replaces the schedule block of the input file");
+        AddHelpLine('c', "", "record performance counters of labeled edgeset applies");
+        AddHelpLine('w', "", "run parallel vertex loops on the work-stealing scheduler");
     }
 
     bool ParseArgs() {
@@ -78,6 +84,9 @@ public:
             case 'o': output_filename_ = std::string(opt_arg);                     break;
 	    case 'm': python_module_name_ = std::string(opt_arg); break;
 	    case 'p': python_module_path_ = std::string(opt_arg); break;
+            case 's': schedule_filename_ = std::string(opt_arg); break;
+            case 'c': instrument_applies_ = true; break;
+            case 'w': work_stealing_ = true; break;
             case 'h': PrintUsage();                               break;
         }
     }
@@ -94,6 +103,9 @@ public:
     std::string output_filename() const { return output_filename_; }
     std::string python_module_path() const { return python_module_path_; }
     std::string python_module_name() const { return python_module_name_; }
+    std::string schedule_filename() const { return schedule_filename_; }
+    bool instrument_applies() const { return instrument_applies_; }
+    bool work_stealing() const { return work_stealing_; }
 };
 
 
@@ -5,8 +5,8 @@
 #include <graphit/backend/backend.h>
 
 namespace graphit{
-    int Backend::emitCPP(std::ostream &oss, std::string module_name) {
-        CodeGenCPP* codegen_cpp = new CodeGenCPP(oss, mir_context_, module_name);
+    int Backend::emitCPP(std::ostream &oss, std::string module_name, bool instrument_applies, bool work_stealing) {
+        CodeGenCPP* codegen_cpp = new CodeGenCPP(oss, mir_context_, module_name, instrument_applies, work_stealing);
         int flag = codegen_cpp->genCPP();
         delete codegen_cpp;
         return flag;
@@ -39,19 +39,26 @@ namespace graphit {
             }
         }
 
+        // Exported functions share the globals of the module, constants are initialized by the first call only,
+        // so vectors and scalars keep their values across calls (incremental recomputation from python)
+        if (hasExportedFunction() && !getInitializedScalarConstants().empty()) {
+            oss << "bool __constants_initialized = false;" << std::endl;
+        }
+
         // Generate global declarations for socket-local buffers used by NUMA optimization
-        for (auto iter : mir_context_->edgeset_to_label_to_merge_reduce) {
-            for (auto inner_iter : iter.second) {
-                if (inner_iter.second->numa_aware) {
-                    inner_iter.second->scalar_type->accept(this);
-                    oss << " **local_" << inner_iter.second->field_name << ";" << std::endl;
-                }
-            }
+        for (auto local_field : getNumaLocalFields()) {
+            local_field.second->accept(this);
+            oss << " **local_" << local_field.first << ";" << std::endl;
+        }
+        // the copies of a replicated field are refreshed by the next apply only after the field was written
+        for (auto replicated_field : getNumaReplicatedFields()) {
+            oss << "std::atomic<bool> local_" << replicated_field << "_stale(false);" << std::endl;
         }
 
         //Generates function declarations for various edgeset apply operations with different schedules
         // TODO: actually complete the generation, fow now we will use libraries to test a few schedules
-        auto gen_edge_apply_function_visitor = EdgesetApplyFunctionDeclGenerator(mir_context_, oss);
+        auto gen_edge_apply_function_visitor = EdgesetApplyFunctionDeclGenerator(mir_context_, oss, instrument_applies_,
+                                                                                 work_stealing_);
         gen_edge_apply_function_visitor.genEdgeApplyFuncDecls();
 
         //Processing the functions
@@ -71,6 +78,64 @@ namespace graphit {
         oss << std::endl;
         return 0;
     };
+    bool CodeGenCPP::hasExportedFunction() {
+        for (auto func_decl : mir_context_->getFunctionList()) {
+            if (func_decl->type == mir::FuncDecl::Type::EXPORTED)
+                return true;
+        }
+        return false;
+    }
+
+    std::vector<mir::VarDecl::Ptr> CodeGenCPP::getInitializedScalarConstants() {
+        std::vector<mir::VarDecl::Ptr> scalar_constants;
+        for (auto constant : mir_context_->getLoweredConstants()) {
+            if (mir::isa<mir::ScalarType>(constant->type) && constant->initVal != nullptr)
+                scalar_constants.push_back(constant);
+        }
+        return scalar_constants;
+    }
+
+    std::map<std::string, mir::ScalarType::Ptr> CodeGenCPP::getNumaLocalFields() {
+        std::map<std::string, mir::ScalarType::Ptr> local_fields;
+        for (auto iter : mir_context_->edgeset_to_label_to_merge_reduce) {
+            for (auto inner_iter : iter.second) {
+                auto merge_reduce = inner_iter.second;
+                if (!merge_reduce->numa_aware)
+                    continue;
+                local_fields[merge_reduce->field_name] = merge_reduce->scalar_type;
+                for (auto replicated_field : merge_reduce->replicated_fields)
+                    local_fields[replicated_field] = mir::to<mir::ScalarType>(
+                            mir_context_->getVectorItemType(replicated_field));
+            }
+        }
+        return local_fields;
+    }
+
+    std::set<std::string> CodeGenCPP::getNumaReplicatedFields() {
+        std::set<std::string> replicated_fields;
+        for (auto iter : mir_context_->edgeset_to_label_to_merge_reduce) {
+            for (auto inner_iter : iter.second) {
+                auto merge_reduce = inner_iter.second;
+                if (merge_reduce->numa_aware)
+                    replicated_fields.insert(merge_reduce->replicated_fields.begin(),
+                                             merge_reduce->replicated_fields.end());
+            }
+        }
+        return replicated_fields;
+    }
+
+    void CodeGenCPP::genReplicaStaleMark(mir::Expr::Ptr lhs) {
+        std::string field_name;
+        if (mir::isa<mir::TensorArrayReadExpr>(lhs))
+            field_name = mir::to<mir::TensorArrayReadExpr>(lhs)->getTargetNameStr();
+        else if (mir::isa<mir::VarExpr>(lhs))
+            field_name = mir::to<mir::VarExpr>(lhs)->var.getName();
+        if (field_name == "" || getNumaReplicatedFields().count(field_name) == 0)
+            return;
+        printIndent();
+        oss << "builtin_numaMarkStale(local_" << field_name << "_stale);" << std::endl;
+    }
+
     void CodeGenCPP::generatePyBindModule() {
 	oss << "#ifdef GEN_PYBIND_WRAPPERS" << std::endl;
 	oss << "PYBIND11_MODULE(" << module_name << ", m) {" << std::endl;
@@ -178,9 +243,11 @@ namespace graphit {
     void CodeGenCPP::visit(mir::ExprStmt::Ptr expr_stmt) {
 
         if (mir::isa<mir::EdgeSetApplyExpr>(expr_stmt->expr)) {
-            printIndent();
             auto edgeset_apply_expr = mir::to<mir::EdgeSetApplyExpr>(expr_stmt->expr);
+            genApplyCounterBegin(edgeset_apply_expr, expr_stmt->stmt_label);
+            printIndent();
             genEdgesetApplyFunctionCall(edgeset_apply_expr);
+            genApplyCounterEnd(edgeset_apply_expr, expr_stmt->stmt_label, "");
         } else {
             printIndent();
             expr_stmt->expr->accept(this);
@@ -205,11 +272,19 @@ namespace graphit {
         } else 
 */
         if (mir::isa<mir::EdgeSetApplyExpr>(assign_stmt->expr)) {
+            auto edgeset_apply_expr = mir::to<mir::EdgeSetApplyExpr>(assign_stmt->expr);
+            genApplyCounterBegin(edgeset_apply_expr, assign_stmt->stmt_label);
             printIndent();
             assign_stmt->lhs->accept(this);
             oss << " = ";
-            auto edgeset_apply_expr = mir::to<mir::EdgeSetApplyExpr>(assign_stmt->expr);
             genEdgesetApplyFunctionCall(edgeset_apply_expr);
+            if (instrument_applies_ && assign_stmt->stmt_label != "") {
+                // the assigned frontier is read back by the counters
+                std::ostringstream lhs;
+                CodeGenCPP lhs_codegen(lhs, mir_context_, module_name);
+                assign_stmt->lhs->accept(&lhs_codegen);
+                genApplyCounterEnd(edgeset_apply_expr, assign_stmt->stmt_label, lhs.str());
+            }
 
         } else {
             printIndent();
@@ -217,6 +292,7 @@ namespace graphit {
             oss << " = ";
             assign_stmt->expr->accept(this);
             oss << ";" << std::endl;
+            genReplicaStaleMark(assign_stmt->lhs);
         }
     }
 
@@ -229,6 +305,7 @@ namespace graphit {
         oss << ", ";
         cas_stmt->expr->accept(this);
         oss << ");" << std::endl;
+        genReplicaStaleMark(cas_stmt->lhs);
     }
 
     void CodeGenCPP::visit(mir::ReduceStmt::Ptr reduce_stmt) {
@@ -303,6 +380,7 @@ namespace graphit {
                     oss << " ); " << std::endl;
                     break;
             }
+            genReplicaStaleMark(reduce_stmt->lhs);
 
         }
     }
@@ -335,11 +413,13 @@ namespace graphit {
         } else 
 */
         if (mir::isa<mir::EdgeSetApplyExpr>(var_decl->initVal)) {
+            auto edgeset_apply_expr = mir::to<mir::EdgeSetApplyExpr>(var_decl->initVal);
+            genApplyCounterBegin(edgeset_apply_expr, var_decl->stmt_label);
             printIndent();
             var_decl->type->accept(this);
             oss << var_decl->name << " = ";
-            auto edgeset_apply_expr = mir::to<mir::EdgeSetApplyExpr>(var_decl->initVal);
             genEdgesetApplyFunctionCall(edgeset_apply_expr);
+            genApplyCounterEnd(edgeset_apply_expr, var_decl->stmt_label, var_decl->name);
         } else {
             printIndent();
 
@@ -434,11 +514,21 @@ namespace graphit {
             //generate special initialization code for main function
             //TODO: this is probably a hack that could be fixed for later
 
+            // thread count, affinity and scaling flags, removed from argv before the program reads it
+            oss << "  builtin_parseRuntimeFlags(argc, argv);" << std::endl;
+
             //First, allocate the edgesets (read them from outside files if needed)
             for (auto stmt : mir_context_->edgeset_alloc_stmts) {
                 stmt->accept(this);
             }
 
+            // Relabel the vertices of edgesets whose schedules ask for a vertex order, before any other
+            // structure (segments, compressed copies) is derived from the edges
+            for (auto relabeled : mir_context_->edgeset_to_vertex_order) {
+                oss << "  " << relabeled.first << " = builtin_relabelEdges(" << relabeled.first << ", "
+                    << relabeled.second << ");" << std::endl;
+            }
+
             // Initialize graphSegments if necessary
             auto segment_map = mir_context_->edgeset_to_label_to_num_segment;
             for (auto edge_iter = segment_map.begin(); edge_iter != segment_map.end(); edge_iter++) {
@@ -450,24 +540,43 @@ namespace graphit {
                     auto edge_iter_first = (*edge_iter).first;
                     auto label_iter_first = (*label_iter).first;
                     auto label_iter_second = (*label_iter).second;
-                    auto numa_aware_flag = mir_context_->edgeset_to_label_to_merge_reduce[edge_iter_first][label_iter_first]->numa_aware;
+                    // only pull traversals merge per-socket buffers
+                    auto merge_reduce_map = mir_context_->edgeset_to_label_to_merge_reduce[edge_iter_first];
+                    auto merge_reduce = merge_reduce_map.find(label_iter_first);
+                    auto numa_aware_flag = merge_reduce != merge_reduce_map.end() && merge_reduce->second->numa_aware;
+                    auto push_labels = mir_context_->edgeset_to_push_segment_labels[edge_iter_first];
+                    std::string build_func = push_labels.find(label_iter_first) != push_labels.end() ?
+                                             "buildPushSegmentedGraphs" : "buildPullSegmentedGraphs";
+                    auto edge_aware_labels = mir_context_->edgeset_to_edge_aware_segment_labels[edge_iter_first];
+                    bool edge_aware_flag = edge_aware_labels.find(label_iter_first) != edge_aware_labels.end();
+                    std::string flags = edge_aware_flag ? (numa_aware_flag ? ", true, true" : ", false, true")
+                                                        : (numa_aware_flag ? ", true" : "");
 
                     if (label_iter_second < 0) {
                         //do a specical case for negative number of segments. I
                         // in the case of negative integer, we use the number as argument to runtimve argument argv
                         // this is the only place in the generated code that we set the number of segments
-                        oss << "  " << edgeset->name << ".buildPullSegmentedGraphs(\"" << label_iter_first
+                        oss << "  " << edgeset->name << "." << build_func << "(\"" << label_iter_first
                             << "\", " << "atoi(argv[" << -1*label_iter_second << "])"
-                            << (numa_aware_flag ? ", true" : "") << ");" << std::endl;
+                            << flags << ");" << std::endl;
                     } else {
                         // just use the positive integer as argument to number of segments
-                        oss << "  " << edgeset->name << ".buildPullSegmentedGraphs(\"" << label_iter_first
+                        oss << "  " << edgeset->name << "." << build_func << "(\"" << label_iter_first
                             << "\", " << label_iter_second
-                            << (numa_aware_flag ? ", true" : "") << ");" << std::endl;
+                            << flags << ");" << std::endl;
                     }
                 }
             }
 
+            // Build the compressed neighbor lists of edgesets traversed with a compressed edge layout,
+            // edgesets that are only traversed compressed drop their CSR arrays
+            for (auto compressed : mir_context_->edgeset_to_compressed_edge_code) {
+                bool release_csr = mir_context_->edgesets_with_csr_uses.find(compressed.first)
+                                   == mir_context_->edgesets_with_csr_uses.end();
+                oss << "  " << compressed.first << ".buildCompressedGraph<" << compressed.second << ">("
+                    << (release_csr ? "true" : "") << ");" << std::endl;
+            }
+
             //generate allocation statemetns for field vectors
             for (auto constant : mir_context_->getLoweredConstants()) {
                 if ((std::dynamic_pointer_cast<mir::VectorType>(constant->type)) != nullptr) {
@@ -494,47 +603,53 @@ namespace graphit {
                 stmt->accept(this);
             }
 
-            for (auto iter : mir_context_->edgeset_to_label_to_merge_reduce) {
-                for (auto inner_iter : iter.second) {
-
-                    if ((inner_iter.second)->numa_aware) {
-                        auto merge_reduce = inner_iter.second;
-                        std::string local_field = "local_" + merge_reduce->field_name;
-                        oss << "  " << local_field << " = new ";
-                        merge_reduce->scalar_type->accept(this);
-                        oss << "*[omp_get_num_places()];\n";
-
-                        oss << "  for (int socketId = 0; socketId < omp_get_num_places(); socketId++) {\n";
-                        oss << "    " << local_field << "[socketId] = (";
-                        merge_reduce->scalar_type->accept(this);
-                        oss << "*)numa_alloc_onnode(sizeof(";
-                        merge_reduce->scalar_type->accept(this);
-                        oss << ") * ";
-                        auto count_expr = mir_context_->getElementCount(
-                                mir_context_->getElementTypeFromVectorOrSetName(merge_reduce->field_name));
-                        count_expr->accept(this);
-                        oss << ", socketId);\n";
-
-                        oss << "    parallel_for (int n = 0; n < ";
-                        count_expr->accept(this);
-                        oss << "; n++) {\n";
-                        oss << "      " << local_field << "[socketId][n] = " << merge_reduce->field_name << "[n];\n";
-                        oss << "    }\n  }\n";
-
-                        oss << "  omp_set_nested(1);" << std::endl;
-                    }
-                }
+            auto numa_local_fields = getNumaLocalFields();
+            for (auto numa_local_field : numa_local_fields) {
+                std::string field_name = numa_local_field.first;
+                auto scalar_type = numa_local_field.second;
+                std::string local_field = "local_" + field_name;
+                oss << "  " << local_field << " = new ";
+                scalar_type->accept(this);
+                oss << "*[omp_get_num_places()];\n";
+
+                oss << "  for (int socketId = 0; socketId < omp_get_num_places(); socketId++) {\n";
+                oss << "    " << local_field << "[socketId] = (";
+                scalar_type->accept(this);
+                oss << "*)numa_alloc_onnode(sizeof(";
+                scalar_type->accept(this);
+                oss << ") * ";
+                auto count_expr = mir_context_->getElementCount(
+                        mir_context_->getElementTypeFromVectorOrSetName(field_name));
+                count_expr->accept(this);
+                oss << ", socketId);\n";
+
+                oss << "    parallel_for (int n = 0; n < ";
+                count_expr->accept(this);
+                oss << "; n++) {\n";
+                oss << "      " << local_field << "[socketId][n] = " << field_name << "[n];\n";
+                oss << "    }\n  }\n";
             }
+            // the field vector initialization above is already in the copies
+            for (auto replicated_field : getNumaReplicatedFields())
+                oss << "  local_" << replicated_field << "_stale = false;" << std::endl;
+            if (!numa_local_fields.empty())
+                oss << "  omp_set_nested(1);" << std::endl;
         } //end of if "main" condition
 
-        // still generate the constant declarations
-        if (func_decl->type == mir::FuncDecl::Type::EXPORTED){
-            for (auto constant : mir_context_->getLoweredConstants()) {
-                if (mir::isa<mir::ScalarType>(constant->type) &&
-                        constant->initVal != nullptr){
-                    genScalarAlloc(constant);
-                }
+        // still generate the constant declarations, once for all the exported functions of the module
+        auto scalar_constants = getInitializedScalarConstants();
+        if (func_decl->type == mir::FuncDecl::Type::EXPORTED && !scalar_constants.empty()){
+            printIndent();
+            oss << "if (!__constants_initialized) {" << std::endl;
+            indent();
+            for (auto constant : scalar_constants) {
+                genScalarAlloc(constant);
             }
+            printIndent();
+            oss << "__constants_initialized = true;" << std::endl;
+            dedent();
+            printIndent();
+            oss << "}" << std::endl;
         }
 
 
@@ -558,21 +673,17 @@ namespace graphit {
           printEndIndent();
           oss << ";";
           oss << std::endl;
+          genSimdPullReduce(func_decl);
         }
 
         if (func_decl->name == "main") {
-            for (auto iter : mir_context_->edgeset_to_label_to_merge_reduce) {
-                for (auto inner_iter : iter.second) {
-                    if (inner_iter.second->numa_aware) {
-                        auto merge_reduce = inner_iter.second;
-                        oss << "  for (int socketId = 0; socketId < omp_get_num_places(); socketId++) {\n";
-                        oss << "    numa_free(local_" << merge_reduce->field_name << "[socketId], sizeof(";
-                        merge_reduce->scalar_type->accept(this);
-                        oss << ") * ";
-                        mir_context_->getElementCount(mir_context_->getElementTypeFromVectorOrSetName(merge_reduce->field_name))->accept(this);
-                        oss << ");\n  }\n";
-                    }
-                }
+            for (auto numa_local_field : getNumaLocalFields()) {
+                oss << "  for (int socketId = 0; socketId < omp_get_num_places(); socketId++) {\n";
+                oss << "    numa_free(local_" << numa_local_field.first << "[socketId], sizeof(";
+                numa_local_field.second->accept(this);
+                oss << ") * ";
+                mir_context_->getElementCount(mir_context_->getElementTypeFromVectorOrSetName(numa_local_field.first))->accept(this);
+                oss << ");\n  }\n";
             }
         }
 
@@ -865,6 +976,15 @@ namespace graphit {
 //        expr->index->accept(this);
 //        oss << "]";
 //    }
+        if (simd_value_type_ != "") {
+            // one lane per in-neighbor
+            oss << "SimdVector<" << simd_value_type_ << ">::gather(";
+            expr->target->accept(this);
+            oss << ", ";
+            expr->index->accept(this);
+            oss << ")";
+            return;
+        }
         if (mir::isa<mir::MIRNode>(expr.get()->target.get()->shared_from_this())) {
             //not sure what this is std::shared_ptr<mir::MIRNode> ptr = expr.get()->target.get()->shared_from_this();
             std::string nameptr = expr.get()->getTargetNameStr();
@@ -894,6 +1014,15 @@ namespace graphit {
  * @param expr
  */
     void CodeGenCPP::visit(mir::TensorStructReadExpr::Ptr expr) {
+        if (simd_value_type_ != "") {
+            // one lane per in-neighbor, the fields are strided by the size of the struct
+            oss << "SimdVector<" << simd_value_type_ << ">::gather(&" << expr->array_of_struct_target << "[0].";
+            expr->field_target->accept(this);
+            oss << ", ";
+            expr->index->accept(this);
+            oss << ", sizeof(" << expr->array_of_struct_target << "[0]))";
+            return;
+        }
         //for dense array tensor read
         oss << expr->array_of_struct_target << "[";
         expr->index->accept(this);
@@ -1106,7 +1235,8 @@ namespace graphit {
         oss << " ); " << std::endl;
          **/
 
-        oss << " = new ";
+        // property arrays are large, they come from the huge page allocator of the runtime
+        oss << " = HugePageAllocator::Allocate<";
 
         if (mir::isa<mir::VectorType>(vector_element_type)){
             //for vector type, we use the name from typedef
@@ -1117,9 +1247,18 @@ namespace graphit {
             vector_element_type->accept(this);
         }
 
-        oss << "[ ";
+        oss << ">( ";
         size_expr -> accept(this);
-        oss << "];" << std::endl;
+        oss << ");" << std::endl;
+
+        // bind the pages to the NUMA nodes before the array is initialized
+        auto numa_placement = mir_context_->vector_to_numa_placement.find(name);
+        if (numa_placement != mir_context_->vector_to_numa_placement.end()) {
+            printIndent();
+            oss << numa_placement->second << "(" << name << ", ";
+            size_expr->accept(this);
+            oss << ");" << std::endl;
+        }
     }
 
     void CodeGenCPP::genPropertyArrayImplementationWithInitialization(mir::VarDecl::Ptr var_decl) {
@@ -1204,23 +1343,35 @@ namespace graphit {
             assert(associated_element_type);
             auto associated_element_type_size = mir_context_->getElementCount(associated_element_type);
             assert(associated_element_type_size);
-            std::string for_type = apply_expr->is_parallel ? "parallel_for" : "for";
-            oss << for_type << " (int vertexsetapply_iter = 0; vertexsetapply_iter < ";
-            associated_element_type_size->accept(this);
-            oss << "; vertexsetapply_iter++) {" << std::endl;
+            // graphitc -w hands the loop body to the work-stealing scheduler as a lambda
+            bool work_stealing = apply_expr->is_parallel && work_stealing_;
+            if (work_stealing) {
+                oss << "builtin_parallelFor(0, ";
+                associated_element_type_size->accept(this);
+                oss << ", [&] (int vertexsetapply_iter) {" << std::endl;
+            } else {
+                std::string for_type = apply_expr->is_parallel ? "parallel_for" : "for";
+                oss << for_type << " (int vertexsetapply_iter = 0; vertexsetapply_iter < ";
+                associated_element_type_size->accept(this);
+                oss << "; vertexsetapply_iter++) {" << std::endl;
+            }
             indent();
             printIndent();
+            // a serial apply over a relabeled edgeset visits the vertices in the order of the input
+            std::string vertex = "vertexsetapply_iter";
+            if (apply_expr->relabeled_edgeset != "")
+                vertex = "builtin_relabeledVertex(" + apply_expr->relabeled_edgeset + ", vertexsetapply_iter)";
             if (mir_context_->isExternFunction(apply_expr->input_function_name)){
                 // This function is an extern function (not a functor)
-                oss << apply_expr->input_function_name << "(vertexsetapply_iter);" << std::endl;
+                oss << apply_expr->input_function_name << "(" << vertex << ");" << std::endl;
             } else  {
                 // This function is not an extern function, it is defined in GraphIt code
                 // This would generate a functor declaration
-                oss << apply_expr->input_function_name << "()(vertexsetapply_iter);" << std::endl;
+                oss << apply_expr->input_function_name << "()(" << vertex << ");" << std::endl;
             }
             dedent();
             printIndent();
-            oss << "}";
+            oss << (work_stealing ? "})" : "}");
         } else {
             // NOT sure what how this condition is triggered and used
             // if this is a dynamically created vertexset
@@ -1429,6 +1580,12 @@ namespace graphit {
             arguments.push_back(genFuncNameAsArgumentString(apply_expr->push_function_));
         }
 
+        // the priority vector (tracking field) and bucket width of ordered applies
+        if (apply->is_ordered) {
+            arguments.push_back(apply->tracking_field);
+            arguments.push_back(std::to_string(apply->priority_update_delta));
+        }
+
         // the edgeset that is being applied over (target)
         apply->target->accept(this);
         for (auto &arg : arguments) {
@@ -1438,6 +1595,98 @@ namespace graphit {
         oss << "); " << std::endl;
     }
 
+    void CodeGenCPP::genApplyCounterBegin(mir::EdgeSetApplyExpr::Ptr apply, std::string label) {
+        if (!instrument_applies_ || label == "")
+            return;
+        std::string direction = "push";
+        if (mir::isa<mir::PullEdgeSetApplyExpr>(apply)) {
+            direction = "pull";
+        } else if (mir::isa<mir::HybridDenseEdgeSetApplyExpr>(apply)
+                   || mir::isa<mir::HybridDenseForwardEdgeSetApplyExpr>(apply)) {
+            // the hybrid apply records the direction it picks
+            direction = "hybrid";
+        }
+        std::string from_vertexset = "nullptr";
+        if (apply->from_func != "" && !mir_context_->isFunction(apply->from_func))
+            from_vertexset = apply->from_func;
+        printIndent();
+        oss << "builtin_beginApplyCounter(\"" << label << "\", ";
+        apply->target->accept(this);
+        oss << ", " << from_vertexset << ", \"" << direction << "\");" << std::endl;
+    }
+
+    void CodeGenCPP::genApplyCounterEnd(mir::EdgeSetApplyExpr::Ptr apply, std::string label, std::string result) {
+        if (!instrument_applies_ || label == "")
+            return;
+        auto apply_func = mir_context_->getFunction(apply->input_function_name);
+        bool returns_frontier = apply_func->result.isInitialized() && !apply->is_ordered;
+        printIndent();
+        oss << "builtin_endApplyCounter(" << (returns_frontier && result != "" ? result : "") << ");" << std::endl;
+    }
+
+    void CodeGenCPP::genSimdPullReduce(mir::FuncDecl::Ptr func_decl) {
+        auto simd_reduce = mir_context_->function_to_simd_pull_reduce.find(func_decl->name);
+        if (simd_reduce == mir_context_->function_to_simd_pull_reduce.end())
+            return;
+        auto reduce = simd_reduce->second;
+        std::string value_type = reduce->scalar_type->type == mir::ScalarType::Type::INT ? "int" :
+                                 (reduce->scalar_type->type == mir::ScalarType::Type::FLOAT ? "float" : "double");
+        std::string dst_name = func_decl->args[1].getName();
+
+        // the value of one in-neighbor (scalar tail) and of kSimdLanes in-neighbors
+        printIndent();
+        oss << value_type << " pullValue (";
+        func_decl->args[0].getType()->accept(this);
+        oss << reduce->src_name << ")" << std::endl;
+        printBeginIndent();
+        indent();
+        printIndent();
+        oss << "return ";
+        reduce->value->accept(this);
+        oss << ";" << std::endl;
+        dedent();
+        printEndIndent();
+        oss << ";" << std::endl;
+
+        printIndent();
+        oss << "SimdVector<" << value_type << "> pullValue (const SimdIndex &" << reduce->src_name << ")" << std::endl;
+        printBeginIndent();
+        indent();
+        printIndent();
+        oss << "return SimdVector<" << value_type << ">(";
+        simd_value_type_ = value_type;
+        reduce->value->accept(this);
+        simd_value_type_ = "";
+        oss << ");" << std::endl;
+        dedent();
+        printEndIndent();
+        oss << ";" << std::endl;
+
+        // called by the pull traversal with the in-neighbors of dst
+        printIndent();
+        oss << "void pullReduce (";
+        func_decl->args[1].getType()->accept(this);
+        oss << dst_name << ", const NodeID *begin, const NodeID *end)" << std::endl;
+        printBeginIndent();
+        indent();
+        printIndent();
+        if (reduce->reduce_op == mir::ReduceStmt::ReductionOp::SUM) {
+            reduce->target->accept(this);
+            oss << " += builtin_simdPullSum<" << value_type << ">(begin, end, *this);" << std::endl;
+        } else {
+            oss << value_type << " simd_min = builtin_simdPullMin<" << value_type << ">(begin, end, *this);" << std::endl;
+            printIndent();
+            oss << "if (simd_min < ";
+            reduce->target->accept(this);
+            oss << ") ";
+            reduce->target->accept(this);
+            oss << " = simd_min;" << std::endl;
+        }
+        dedent();
+        printEndIndent();
+        oss << ";" << std::endl;
+    }
+
     void CodeGenCPP::visit(mir::EdgeSetLoadExpr::Ptr edgeset_load_expr) {
         if (edgeset_load_expr->is_weighted_){
             oss << "builtin_loadWeightedEdgesFromFile ( ";
@@ -1462,14 +1711,15 @@ namespace graphit {
     }
 
     void CodeGenCPP::visit(mir::VectorAllocExpr::Ptr alloc_expr) {
-        oss << "new ";
+        // the same huge page backed allocation as the global property arrays, released by deleteObject
+        oss << "HugePageAllocator::Allocate<";
 
         if (alloc_expr->scalar_type != nullptr){
             alloc_expr->scalar_type->accept(this);
         } else if (alloc_expr->vector_type != nullptr){
             oss << alloc_expr->vector_type->toString();
         }
-        oss << "[ ";
+        oss << ">( ";
         //This is the current number of elements, but we need the range
         //alloc_expr->size_expr->accept(this);
         const auto size_expr = mir_context_->getElementCount(alloc_expr->element_type);
@@ -1479,7 +1729,7 @@ namespace graphit {
 	    // This means it is a vector of constant size. The size_expr now directly holds the constant literal.
 	    alloc_expr->size_expr->accept(this);
 	}
-        oss << "]";
+        oss << ")";
     }
 
     std::string CodeGenCPP::genFuncNameAsArgumentString(std::string func_name) {
@@ -32,6 +32,18 @@ namespace graphit {
             return;
         }
 
+        // applies with the same schedule share one declaration
+        if (generated_func_names_.find(func_name) != generated_func_names_.end())
+            return;
+        generated_func_names_.insert(func_name);
+
+        if (apply->is_ordered) {
+            // the ordered apply drives the unordered traversal of the same schedule, one bucket at a time
+            apply->is_ordered = false;
+            genEdgeApplyFunctionDeclaration(apply);
+            apply->is_ordered = true;
+        }
+
 
         genEdgeApplyFunctionSignature(apply);
         oss_ << "{ " << endl; //the end of the function declaration
@@ -41,6 +53,11 @@ namespace graphit {
     }
 
     void EdgesetApplyFunctionDeclGenerator::genEdgeApplyFunctionDeclBody(mir::EdgeSetApplyExpr::Ptr apply) {
+        if (apply->is_ordered) {
+            genEdgeOrderedApplyFunctionDeclBody(apply);
+            return;
+        }
+
         if (mir::isa<mir::PullEdgeSetApplyExpr>(apply)) {
             genEdgePullApplyFunctionDeclBody(apply);
         }
@@ -93,9 +110,11 @@ namespace graphit {
 //            }
 
             //we need to calculate the outdegrees and m if it is hybrid_dense, hybrid_denseforward or push with output
+            //edge based push needs the degrees to split the edges into chunks
             if (mir::isa<mir::HybridDenseEdgeSetApplyExpr>(apply)
                 || mir::isa<mir::HybridDenseForwardEdgeSetApplyExpr>(apply)
-                    || (mir::isa<mir::PushEdgeSetApplyExpr>(apply) && apply_expr_gen_frontier)) {
+                    || (mir::isa<mir::PushEdgeSetApplyExpr>(apply)
+                        && (apply_expr_gen_frontier || apply->use_push_edge_based_load_balance))) {
                 if (from_vertexset_specified) {
                     oss_ << "    from_vertexset->toSparse();" << std::endl;
                     oss_ << "    long m = from_vertexset->size();\n";
@@ -104,7 +123,7 @@ namespace graphit {
                     oss_ << "    long m = numVertices; \n";
                 }
                 oss_ << "    // used to generate nonzero indices to get degrees\n"
-                        "    uintT *degrees = newA(uintT, m);\n"
+                        "    uintT *degrees = FrontierPool::allocate<uintT>(m);\n"
                         "    // We probably need this when we get something that doesn't have a dense set, not sure\n"
                         "    // We can also write our own, the eixsting one doesn't quite work for bitvectors\n"
                         "    //from_vertexset->toSparse();\n"
@@ -172,38 +191,73 @@ namespace graphit {
                         "    }\n";
             }
 
-            oss_ <<
-                         "    if (outDegrees == 0) return next_frontier;\n"
-                         "    uintT *offsets = degrees;\n"
-                         "    long outEdgeCount = sequence::plusScan(offsets, degrees, m);\n"
-                         "    uintE *outEdges = newA(uintE, outEdgeCount);\n";
+            oss_ << "    if (outDegrees == 0) {\n"
+                    "        FrontierPool::release(degrees);\n"
+                    "        return next_frontier;\n"
+                    "    }\n";
+            if (apply->use_thread_local_frontier) {
+                // every thread collects the vertices it adds, no slot per frontier edge
+                oss_ << "    FrontierBuffer<uintE> next_buffer;\n";
+            } else {
+                oss_ << "    uintT *offsets = degrees;\n"
+                        "    long outEdgeCount = sequence::plusScan(offsets, degrees, m);\n"
+                        "    uintE *outEdges = FrontierPool::allocate<uintE>(outEdgeCount);\n";
+            }
         }
 
+        // the frontier edges are written to the slots of their source in outEdges
+        bool edge_slots = apply_expr_gen_frontier && !apply->use_thread_local_frontier;
+
+        bool edge_based = apply->use_push_edge_based_load_balance;
+        if (edge_based && !edge_slots) {
+            // the offsets are not computed for the output frontier, compute them for the chunks
+            oss_ << "    uintT *offsets = degrees;\n"
+                    "    long outEdgeCount = sequence::plusScan(offsets, degrees, m);\n";
+        }
 
         indent();
 
         printIndent();
 
-        std::string for_type = "for";
-        if (apply->is_parallel)
-            for_type = "parallel_for";
-
         std::string node_id_type = "NodeID";
         if (apply->is_weighted) node_id_type = "WNode";
 
-
-        if (from_vertexset_specified)
-            oss_ << for_type << " (long i=0; i < m; i++) {" << std::endl;
+        if (edge_based) {
+            // each iteration processes a chunk of a fixed number of edges of the frontier,
+            // a high degree vertex is split across several chunks
+            oss_ << "long numChunks = (outEdgeCount + " << apply->push_edge_based_load_balance_grain_size
+                 << " - 1) / " << apply->push_edge_based_load_balance_grain_size << ";" << std::endl;
+            printIndent();
+            oss_ << genLoopBegin(apply->is_parallel, "long", "chunk", "0", "numChunks") << std::endl;
+            indent();
+            printIndent();
+            oss_ << "long chunk_begin = chunk * " << apply->push_edge_based_load_balance_grain_size << ";" << std::endl;
+            printIndent();
+            oss_ << "long chunk_end = std::min(chunk_begin + " << apply->push_edge_based_load_balance_grain_size
+                 << ", outEdgeCount);" << std::endl;
+            printIndent();
+            oss_ << "// the last source vertex whose edges start at or before chunk_begin" << std::endl;
+            printIndent();
+            oss_ << "long first = std::upper_bound(offsets, offsets + m, (uintT) chunk_begin) - offsets - 1;"
+                 << std::endl;
+            printIndent();
+            oss_ << "for (long i = first; i < m && offsets[i] < chunk_end; i++) {" << std::endl;
+        } else if (from_vertexset_specified)
+            oss_ << genLoopBegin(apply->is_parallel, "long", "i", "0", "m") << std::endl;
         else
-            oss_ << for_type << " (NodeID s=0; s < g.num_nodes(); s++) {" << std::endl;
+            oss_ << genLoopBegin(apply->is_parallel, "NodeID", "s", "0", "g.num_nodes()") << std::endl;
 
         indent();
 
         if (from_vertexset_specified){
             oss_ << "    NodeID s = from_vertexset->dense_vertex_set_[i];\n";
+        } else if (edge_based) {
+            oss_ << "    NodeID s = i;\n";
         }
 
-        if (apply_expr_gen_frontier){
+        if (edge_based) {
+            oss_ << "    uintT offset = offsets[i];\n";
+        } else if (edge_slots){
             oss_ <<  "    int j = 0;\n";
             if (from_vertexset_specified)
                 oss_ << "    uintT offset = offsets[i];\n";
@@ -211,6 +265,10 @@ namespace graphit {
                 oss_ << "    uintT offset = offsets[s];\n";
         }
 
+        if (apply_expr_gen_frontier && !edge_slots) {
+            oss_ << "    std::vector<uintE> &next_local = next_buffer.local();\n";
+        }
+
 
         if (apply->from_func != "" && !from_vertexset_specified) {
             printIndent();
@@ -220,7 +278,18 @@ namespace graphit {
 
         printIndent();
 
-        oss_ << "for(" << node_id_type << " d : g.out_neigh(s)){" << std::endl;
+        if (edge_based) {
+            // only the edges of s that fall into the chunk
+            oss_ << "auto neighbors = g.out_neigh(s).begin();" << std::endl;
+            printIndent();
+            oss_ << "long j_end = std::min((long) g.out_degree(s), chunk_end - (long) offset);" << std::endl;
+            printIndent();
+            oss_ << "for (long j = std::max(chunk_begin - (long) offset, 0L); j < j_end; j++) {" << std::endl;
+            printIndent();
+            oss_ << "  " << node_id_type << " d = neighbors[j];" << std::endl;
+        } else {
+            oss_ << "for(" << node_id_type << " d : " << genNeighborhood(apply, false, "s") << "){" << std::endl;
+        }
 
 
         // print the checks on filtering on sources s
@@ -270,10 +339,17 @@ namespace graphit {
             //generate the code for adding destination to "next" frontier
             oss_ << " ) { " << std::endl;
             printIndent();
-            oss_ << "outEdges[offset + j] = " << dst_type << "; " << std::endl;
-            dedent();
-            printIndent();
-            oss_ << "} else { outEdges[offset + j] = UINT_E_MAX; }" << std::endl;
+            if (edge_slots) {
+                oss_ << "outEdges[offset + j] = " << dst_type << "; " << std::endl;
+                dedent();
+                printIndent();
+                oss_ << "} else { outEdges[offset + j] = UINT_E_MAX; }" << std::endl;
+            } else {
+                oss_ << "next_local.push_back(" << dst_type << "); " << std::endl;
+                dedent();
+                printIndent();
+                oss_ << "}" << std::endl;
+            }
 
 
 
@@ -290,7 +366,7 @@ namespace graphit {
             printIndent();
             oss_ << "} //end of to func" << std::endl;
 
-            if (apply_expr_gen_frontier){
+            if (edge_slots){
                 printIndent();
                 oss_ << " else { outEdges[offset + j] = UINT_E_MAX;  }" << std::endl;
             }
@@ -298,7 +374,7 @@ namespace graphit {
         }
 
         //increment the index for each source vertex
-        if (apply_expr_gen_frontier){
+        if (edge_slots && !edge_based){
             printIndent();
             oss_ << "j++;" << std::endl;
         }
@@ -317,17 +393,33 @@ namespace graphit {
 
         dedent();
         printIndent();
-        oss_ << "}" << std::endl;
+        oss_ << (edge_based ? "}" : genLoopEnd(apply->is_parallel)) << std::endl;
 
+        if (edge_based) {
+            //end of the loop on the chunks
+            dedent();
+            printIndent();
+            oss_ << genLoopEnd(apply->is_parallel, "1") << std::endl;
+        }
 
+        // the hybrid applies compute the degrees for the direction switch even without an output frontier
+        bool hybrid = mir::isa<mir::HybridDenseEdgeSetApplyExpr>(apply)
+                      || mir::isa<mir::HybridDenseForwardEdgeSetApplyExpr>(apply);
+        if (!apply_expr_gen_frontier && (edge_based || hybrid))
+            oss_ << "  FrontierPool::release(degrees);\n";
 
 
         //return a new vertexset if no subset vertexset is returned
         if (apply_expr_gen_frontier) {
-            oss_ << "  uintE *nextIndices = newA(uintE, outEdgeCount);\n"
-                    "  long nextM = sequence::filter(outEdges, nextIndices, outEdgeCount, nonMaxF());\n"
-                    "  free(outEdges);\n"
-                    "  free(degrees);\n"
+            if (edge_slots) {
+                oss_ << "  uintE *nextIndices = FrontierPool::allocate<uintE>(outEdgeCount);\n"
+                        "  long nextM = sequence::filter(outEdges, nextIndices, outEdgeCount, nonMaxF());\n"
+                        "  FrontierPool::release(outEdges);\n";
+            } else {
+                oss_ << "  long nextM;\n"
+                        "  uintE *nextIndices = next_buffer.merge(&nextM);\n";
+            }
+            oss_ << "  FrontierPool::release(degrees);\n"
                     "  next_frontier->num_vertices_ = nextM;\n"
                     "  next_frontier->dense_vertex_set_ = nextIndices;\n";
 
@@ -351,6 +443,14 @@ namespace graphit {
             bool cache_aware,
             bool numa_aware) {
 
+        if (apply->use_simd_pull) {
+            // the apply function gathers and reduces the whole in-neighbor list (SimdPullReduceLower)
+            std::string neighborhood = genNeighborhood(apply, true, "d");
+            printIndent();
+            oss_ << apply_func_name << ".pullReduce(d, " << neighborhood << ".begin(), "
+                 << neighborhood << ".end());" << std::endl;
+            return;
+        }
 
         //filtering on destination
         if (apply->to_func != "") {
@@ -368,7 +468,7 @@ namespace graphit {
             printIndent();
             oss_ << "  " << node_id_type << " s = sg->edgeArray[ngh];" << std::endl;
         } else {
-            oss_ << "for(" << node_id_type << " s : g.in_neigh(d)){" << std::endl;
+            oss_ << "for(" << node_id_type << " s : " << genNeighborhood(apply, true, "d") << "){" << std::endl;
         }
 
 
@@ -421,7 +521,10 @@ namespace graphit {
             //TODO: fix later
             oss_ << " ) { " << std::endl;
             printIndent();
-            oss_ << "next[d] = 1; " << std::endl;
+            if (apply->use_pull_frontier_bitvector)
+                oss_ << "next->set_bit_atomic(d); " << std::endl;
+            else
+                oss_ << "next[d] = 1; " << std::endl;
             // generating code for early break
             if (apply->to_func != "") {
                 printIndent();
@@ -483,6 +586,14 @@ namespace graphit {
         oss_ << "      local_" << apply->merge_reduce->field_name  << "[socketId][n] = "
              << apply->merge_reduce->field_name << "[n];\n";
         oss_ << "    }\n  }\n";
+        // the replicated fields are only copied again if they were written since the last copy
+        for (auto replicated_field : apply->merge_reduce->replicated_fields) {
+            oss_ << "  if (builtin_numaTakeStale(local_" << replicated_field << "_stale)) {\n";
+            oss_ << "    parallel_for (int n = 0; n < numVertices; n++) {\n";
+            oss_ << "      for (int socketId = 0; socketId < omp_get_num_places(); socketId++) {\n";
+            oss_ << "        local_" << replicated_field << "[socketId][n] = " << replicated_field << "[n];\n";
+            oss_ << "      }\n    }\n  }\n";
+        }
     }
 
     // Print the code for traversing the edges in the push direction and return the new frontier
@@ -500,48 +611,37 @@ namespace graphit {
             //        "  long numVertices = g.num_nodes(), numEdges = g.num_edges();\n"
             //        "  long m = from_vertexset->size();\n"
 
-            oss_ << "  VertexSubset<NodeID> *next_frontier = new VertexSubset<NodeID>(g.num_nodes(), 0);\n"
-                    "  bool * next = newA(bool, g.num_nodes());\n"
-                    "  parallel_for (int i = 0; i < numVertices; i++)next[i] = 0;\n";
+            oss_ << "  VertexSubset<NodeID> *next_frontier = new VertexSubset<NodeID>(g.num_nodes(), 0);\n";
+            if (apply->use_pull_frontier_bitvector) {
+                // the next frontier is a bitvector as well, its size is counted with popcount
+                oss_ << "  Bitmap * next = new Bitmap(g.num_nodes());\n"
+                        "  next->reset();\n";
+            } else {
+                oss_ << "  bool * next = FrontierPool::allocate<bool>(g.num_nodes());\n"
+                        "  parallel_for (int i = 0; i < numVertices; i++)next[i] = 0;\n";
+            }
         }
 
         indent();
 
 
         if (apply->from_func != "") {
-            if (!mir_context_->isFunction(apply->from_func)) {
+            if (!mir_context_->isFunction(apply->from_func) && !apply->use_pull_frontier_bitvector) {
                 printIndent();
                 oss_ << "from_vertexset->toDense();" << std::endl;
             }
         }
 
-        //generate a bitvector from the dense vertexset (bool map)
+        //use the bitvector of the vertexset, it is kept with the vertexset across rounds
         if (from_vertexset_specified && apply->use_pull_frontier_bitvector){
-            oss_ << "  Bitmap bitmap(numVertices);\n"
-                    "  bitmap.reset();\n"
-                    "  parallel_for(int i = 0; i < numVertices; i+=64){\n"
-                    "     int start = i;\n"
-                    "     int end = (((i + 64) < numVertices)? (i+64):numVertices);\n"
-                    "     for(int j = start; j < end; j++){\n"
-                    "        if (from_vertexset->bool_map_[j])\n"
-                    "          bitmap.set_bit(j);\n"
-                    "     }\n"
-                    "  }" << std::endl;
+            oss_ << "  from_vertexset->toBitmap();\n"
+                    "  Bitmap &bitmap = *from_vertexset->bitmap_;" << std::endl;
         }
 
         printIndent();
 
         // Setup flag for cache_awareness: use cache optimization if the data modified by this apply is segemented
-        bool cache_aware = false;
-        auto segment_map = mir_context_->edgeset_to_label_to_num_segment;
-        for (auto edge_iter = segment_map.begin(); edge_iter != segment_map.end(); edge_iter++) {
-            for (auto label_iter = (*edge_iter).second.begin();
-            label_iter != (*edge_iter).second.end();
-            label_iter++) {
-                if ((*label_iter).first == apply->scope_label_name)
-                    cache_aware = true;
-            }
-        }
+        bool cache_aware = isCacheAware(apply);
 
         // Setup flag for numa_awareness: use numa optimization if the numa flag is set in the merge_reduce data structure
         bool numa_aware = false;
@@ -582,16 +682,13 @@ namespace graphit {
 
         //genearte the outer for loop
         if (! apply->use_pull_edge_based_load_balance) {
-            std::string for_type = "for";
             if (numa_aware) {
                 oss_ << "#pragma omp parallel num_threads(omp_get_place_num_procs(socketId)) proc_bind(close)\n{\n";
                 oss_ << "#pragma omp for schedule(dynamic, 1024)\n";
-            } else if (apply->is_parallel) {
-                for_type = "parallel_for";
             }
 
             //printIndent();
-            oss_ << for_type << " ( NodeID " << iter << "=0; " << iter << " < " << outer_end << "; " << iter << "++) {" << std::endl;
+            oss_ << genLoopBegin(apply->is_parallel && !numa_aware, "NodeID", iter, "0", outer_end) << std::endl;
             indent();
             if (cache_aware) {
                 printIndent();
@@ -607,7 +704,8 @@ namespace graphit {
 
             oss_ << "    std::function<void(int,int,int)> recursive_lambda = \n"
                     "    [" << (apply->to_func != "" ?  "&to_func, " : "")
-                 << "&apply_func, &g,  &recursive_lambda, edge_in_index" << (cache_aware ? ", sg" : "");
+                 << "&apply_func, &g,  &recursive_lambda, edge_in_index" << (cache_aware ? ", sg" : "")
+                 << (numa_aware ? ", socketId" : "");
             // capture bitmap and next frontier if needed
             if (from_vertexset_specified) {
                 if(apply->use_pull_frontier_bitvector) oss_ << ", &bitmap ";
@@ -636,21 +734,28 @@ namespace graphit {
             //end of outer for loop
             dedent();
             printIndent();
-            oss_ << "} //end of outer for loop" << std::endl;
+            oss_ << genLoopEnd(apply->is_parallel && !numa_aware) << " //end of outer for loop" << std::endl;
         } else {
             dedent();
             printIndent();
             oss_ << " } //end of outer for loop" << std::endl;
-            oss_ << "        } else { // end of if statement on grain size, recursive case next\n"
-                    "                 cilk_spawn recursive_lambda(start, start + ((end-start) >> 1), grain_size);\n"
-                    "                  recursive_lambda(start + ((end-start)>>1), end, grain_size);\n"
-                    "        } \n"
+            oss_ << "        } else { // end of if statement on grain size, recursive case next\n";
+            if (numa_aware) {
+                // already inside the per-socket parallel region, forking would add pool threads to the OpenMP team
+                oss_ << "                 recursive_lambda(start, start + ((end-start) >> 1), grain_size);\n"
+                        "                 recursive_lambda(start + ((end-start)>>1), end, grain_size);\n";
+            } else {
+                // the halves are forked with builtin_parallelInvoke, which also runs them in parallel without Cilk
+                oss_ << "                 builtin_parallelInvoke([&] { recursive_lambda(start, start + ((end-start) >> 1), grain_size); },\n"
+                        "                                        [&] { recursive_lambda(start + ((end-start)>>1), end, grain_size); });\n";
+            }
+            oss_ << "        } \n"
                     "    }; //end of lambda function\n";
-            oss_ << "    recursive_lambda(0, " << (cache_aware ? "sg->" : "") << "numVertices, "  <<  apply->pull_edge_based_load_balance_grain_size << ");\n"
-                    "    cilk_sync; \n";
+            oss_ << "    recursive_lambda(0, " << (cache_aware ? "sg->" : "") << "numVertices, "  <<  apply->pull_edge_based_load_balance_grain_size << ");\n";
         }
 
-        if (numa_aware) {
+        // the edge based load balance recurses on the socket's thread, without a per-socket team
+        if (numa_aware && !apply->use_pull_edge_based_load_balance) {
           oss_ << "} // end of per-socket parallel_for\n";
         }
         if (cache_aware) {
@@ -662,7 +767,10 @@ namespace graphit {
         }
 
         //return a new vertexset if no subset vertexset is returned
-        if (apply_expr_gen_frontier) {
+        if (apply_expr_gen_frontier && apply->use_pull_frontier_bitvector) {
+            oss_ << "  next_frontier->setBitmap(next);\n"
+                    "  return next_frontier;\n";
+        } else if (apply_expr_gen_frontier) {
             oss_ << "  next_frontier->num_vertices_ = sequence::sum(next, numVertices);\n"
                     "  next_frontier->bool_map_ = next;\n"
                     "  next_frontier->is_dense = true;\n"
@@ -679,13 +787,17 @@ namespace graphit {
             bool apply_expr_gen_frontier,
             std::string dst_type) {
 
-        oss_ << "    if (m + outDegrees > numEdges / 20) {\n";
+        printHybridDirectionSwitch(apply, "numVertices + numEdges");
         indent();
+        if (instrument_applies_)
+            oss_ << "  builtin_recordApplyDirection(\"pull\");\n";
         //suppplies the pull based apply function
         printPullEdgeTraversalReturnFrontier(apply, from_vertexset_specified, apply_expr_gen_frontier, dst_type);
         dedent();
         oss_ << "} else {\n";
         indent();
+        if (instrument_applies_)
+            oss_ << "  builtin_recordApplyDirection(\"push\");\n";
         //uses a special "push_apply_func", which contains synchronizations for the push direction
         printPushEdgeTraversalReturnFrontier(apply, from_vertexset_specified, apply_expr_gen_frontier, dst_type,
                                              "push_apply_func");
@@ -694,6 +806,22 @@ namespace graphit {
 
     }
 
+    void EdgesetApplyFunctionDeclGenerator::printHybridDirectionSwitch(mir::EdgeSetApplyExpr::Ptr apply,
+                                                                       std::string dense_work) {
+        if (!apply->adaptive_direction) {
+            oss_ << "    if (m + outDegrees > numEdges / " << apply->direction_threshold << ") {\n";
+            // the dense directions do not use the degrees of the frontier
+            oss_ << "  FrontierPool::release(degrees);\n";
+            return;
+        }
+        // the state lives as long as the program, so every round learns from the ones before it
+        oss_ << "    static AdaptiveDirection adaptive_direction(" << apply->direction_threshold << ");\n";
+        oss_ << "    AdaptiveDirection::Round adaptive_round(adaptive_direction, m + outDegrees, "
+             << dense_work << ", numEdges);\n";
+        oss_ << "    if (adaptive_round.dense()) {\n";
+        oss_ << "  FrontierPool::release(degrees);\n";
+    }
+
     // print code for denseforward direction
     void EdgesetApplyFunctionDeclGenerator::printDenseForwardEdgeTraversalReturnFrontier(
             mir::EdgeSetApplyExpr::Ptr apply, bool from_vertexset_specified, bool apply_expr_gen_frontier,
@@ -708,7 +836,7 @@ namespace graphit {
             //        "  long m = from_vertexset->size();\n"
 
             oss_ << "  VertexSubset<NodeID> *next_frontier = new VertexSubset<NodeID>(g.num_nodes(), 0);\n"
-                    "  bool * next = newA(bool, g.num_nodes());\n"
+                    "  bool * next = FrontierPool::allocate<bool>(g.num_nodes());\n"
                     "  parallel_for (int i = 0; i < numVertices; i++)next[i] = 0;\n";
         }
 
@@ -721,15 +849,50 @@ namespace graphit {
 
         printIndent();
 
-        std::string for_type = "for";
-        if (apply->is_parallel)
-            for_type = "parallel_for";
-
         std::string node_id_type = "NodeID";
         if (apply->is_weighted) node_id_type = "WNode";
 
-        oss_ << for_type << " ( NodeID s=0; s < g.num_nodes(); s++) {" << std::endl;
+        // with segments, every segment covers a range of destinations and lists the sources with edges into it
+        bool cache_aware = isCacheAware(apply);
+        bool edge_based = apply->use_dense_push_edge_based_load_balance;
+        std::string offsets = cache_aware ? "sg->vertexArray" : "edge_out_index";
+        std::string outer_end = cache_aware ? "sg->numVertices" : "numVertices";
+        std::string iter = cache_aware ? "localId" : "s";
+        if (edge_based && !cache_aware) {
+            // the segments carry their own offsets, the whole graph needs the out edge offsets of every vertex
+            oss_ << "  if (g.get_out_offsets_() == nullptr) g.SetUpOutOffsets();\n"
+                    "  SGOffset * edge_out_index = g.get_out_offsets_();\n";
+        }
+        if (cache_aware) {
+            oss_ << "  for (int segmentId = 0; segmentId < g.getNumSegments(\"" << apply->scope_label_name
+                 << "\"); segmentId++) {\n";
+            oss_ << "      auto sg = g.getSegmentedGraph(std::string(\"" << apply->scope_label_name << "\"), segmentId);\n";
+        }
+        if (edge_based) {
+            // each chunk holds the sources whose out edges start in a range of grain size edges,
+            // so chunks of low degree vertices are as long as a single high degree vertex
+            int grain_size = apply->dense_push_edge_based_load_balance_grain_size;
+            oss_ << "  long numChunks = (" << offsets << "[" << outer_end << "] + " << grain_size << " - 1) / "
+                 << grain_size << ";\n";
+            oss_ << genLoopBegin(apply->is_parallel, "long", "chunk", "0", "numChunks") << std::endl;
+            indent();
+            printIndent();
+            oss_ << "int64_t chunk_begin = chunk * " << grain_size << ";" << std::endl;
+            printIndent();
+            oss_ << "NodeID first = std::lower_bound(" << offsets << ", " << offsets << " + " << outer_end
+                 << ", chunk_begin) - " << offsets << ";" << std::endl;
+            printIndent();
+            oss_ << "for (NodeID " << iter << " = first; " << iter << " < " << outer_end << " && "
+                 << offsets << "[" << iter << "] < chunk_begin + " << grain_size << "; " << iter << "++) {" << std::endl;
+        } else {
+            oss_ << genLoopBegin(apply->is_parallel, "NodeID", iter, "0",
+                                 cache_aware ? "sg->numVertices" : "g.num_nodes()") << std::endl;
+        }
         indent();
+        if (cache_aware) {
+            printIndent();
+            oss_ << "NodeID s = sg->graphId[localId];" << std::endl;
+        }
 
         // print the checks on filtering on sources s
         if (apply->from_func != "") {
@@ -752,7 +915,13 @@ namespace graphit {
         indent();
         printIndent();
 
-        oss_ << "for(" << node_id_type << " d : g.out_neigh(s)){" << std::endl;
+        if (cache_aware) {
+            oss_ << "for (int64_t ngh = sg->vertexArray[localId]; ngh < sg->vertexArray[localId+1]; ngh++) {" << std::endl;
+            printIndent();
+            oss_ << "  " << node_id_type << " d = sg->edgeArray[ngh];" << std::endl;
+        } else {
+            oss_ << "for(" << node_id_type << " d : " << genNeighborhood(apply, false, "s") << "){" << std::endl;
+        }
         indent();
         printIndent();
 
@@ -823,7 +992,17 @@ namespace graphit {
 
         dedent();
         printIndent();
-        oss_ << "} //end of outer for loop" << std::endl;
+        oss_ << (edge_based ? "}" : genLoopEnd(apply->is_parallel)) << " //end of outer for loop" << std::endl;
+
+        if (edge_based) {
+            dedent();
+            printIndent();
+            oss_ << genLoopEnd(apply->is_parallel, "1") << " //end of for loop on chunks" << std::endl;
+        }
+
+        if (cache_aware) {
+            oss_ << "    } // end of segment for loop\n";
+        }
 
         //return a new vertexset if no subset vertexset is returned
         if (apply_expr_gen_frontier) {
@@ -837,13 +1016,17 @@ namespace graphit {
             mir::EdgeSetApplyExpr::Ptr apply, bool from_vertexset_specified, bool apply_expr_gen_frontier,
             std::string dst_type) {
 
-        oss_ << "    if (m + outDegrees > numEdges / 20) {\n";
+        printHybridDirectionSwitch(apply, "numVertices + outDegrees");
         indent();
+        if (instrument_applies_)
+            oss_ << "  builtin_recordApplyDirection(\"dense_forward\");\n";
         //suppplies the pull based apply function
         printDenseForwardEdgeTraversalReturnFrontier(apply, from_vertexset_specified, apply_expr_gen_frontier, dst_type);
         dedent();
         oss_ << "} else {\n";
         indent();
+        if (instrument_applies_)
+            oss_ << "  builtin_recordApplyDirection(\"push\");\n";
         //uses a special "push_apply_func", which contains synchronizations for the push direction
         printPushEdgeTraversalReturnFrontier(apply, from_vertexset_specified, apply_expr_gen_frontier, dst_type
                                              );
@@ -852,6 +1035,19 @@ namespace graphit {
 
     }
 
+    bool EdgesetApplyFunctionDeclGenerator::isCacheAware(mir::EdgeSetApplyExpr::Ptr apply) {
+        auto segment_map = mir_context_->edgeset_to_label_to_num_segment;
+        for (auto edge_iter = segment_map.begin(); edge_iter != segment_map.end(); edge_iter++) {
+            for (auto label_iter = (*edge_iter).second.begin();
+            label_iter != (*edge_iter).second.end();
+            label_iter++) {
+                if ((*label_iter).first == apply->scope_label_name)
+                    return true;
+            }
+        }
+        return false;
+    }
+
     void EdgesetApplyFunctionDeclGenerator::genEdgePullApplyFunctionDeclBody(mir::EdgeSetApplyExpr::Ptr apply) {
         bool apply_expr_gen_frontier = false;
         bool from_vertexset_specified = false;
@@ -892,6 +1088,35 @@ namespace graphit {
                                                            dst_type);
     }
 
+    // Generate the code for ordered (applyUpdatePriority) apply: repeatedly take the lowest bucket of a
+    // priority queue on the tracking field and push from it with the unordered version of the apply,
+    // the vertices it updates go back into the queue
+    void EdgesetApplyFunctionDeclGenerator::genEdgeOrderedApplyFunctionDeclBody(mir::EdgeSetApplyExpr::Ptr apply) {
+        apply->is_ordered = false;
+        auto traversal_func_name = genFunctionName(apply);
+        apply->is_ordered = true;
+
+        // the arguments order here has to be consistent with genEdgeApplyFunctionSignature
+        std::string traversal_args = "g, ready_set";
+        if (apply->to_func != "") {
+            if (mir_context_->isFunction(apply->to_func))
+                traversal_args += ", to_func";
+            else
+                traversal_args += ", to_vertexset";
+        }
+        traversal_args += ", apply_func";
+
+        oss_ << "    BucketPriorityQueue<PRIORITY_T> pq(priority_vector, g.num_nodes(), delta);\n"
+                "    pq.insert(from_vertexset);\n"
+                "    while (!pq.finished()) {\n"
+                "        VertexSubset<NodeID> * ready_set = pq.dequeueReadySet();\n"
+                "        VertexSubset<NodeID> * updated_set = " << traversal_func_name << "(" << traversal_args << ");\n"
+                "        pq.insert(updated_set);\n"
+                "        delete updated_set;\n"
+                "        delete ready_set;\n"
+                "    }\n";
+    }
+
     void EdgesetApplyFunctionDeclGenerator::genEdgeApplyFunctionSignature(mir::EdgeSetApplyExpr::Ptr apply) {
         auto func_name = genFunctionName(apply);
 
@@ -947,6 +1172,13 @@ namespace graphit {
             arguments.push_back("PUSH_APPLY_FUNC push_apply_func");
         }
 
+        // the priority vector (tracking field) and bucket width of ordered applies
+        if (apply->is_ordered) {
+            templates.push_back("typename PRIORITY_T");
+            arguments.push_back("PRIORITY_T * priority_vector");
+            arguments.push_back("int delta");
+        }
+
         oss_ << "template <";
 
         bool first = true;
@@ -958,7 +1190,7 @@ namespace graphit {
                 oss_ << ", " << temp;
         }
         oss_ << "> ";
-        oss_ << (mir_context_->getFunction(apply->input_function_name)->result.isInitialized() ?
+        oss_ << (mir_context_->getFunction(apply->input_function_name)->result.isInitialized() && !apply->is_ordered ?
                  "VertexSubset<NodeID>* " : "void ")  << func_name << "(";
 
         first = true;
@@ -975,6 +1207,15 @@ namespace graphit {
 
     }
 
+    // the neighbors of vertex, decoded in place when the schedule picked a compressed edge layout
+    std::string EdgesetApplyFunctionDeclGenerator::genNeighborhood(mir::EdgeSetApplyExpr::Ptr apply,
+                                                                   bool in_neighbors, std::string vertex) {
+        std::string direction = in_neighbors ? "in" : "out";
+        if (apply->compressed_edge_code != "")
+            return "g.compressed_" + direction + "_neigh<" + apply->compressed_edge_code + ">(" + vertex + ")";
+        return "g." + direction + "_neigh(" + vertex + ")";
+    }
+
     //generates different function name for different schedules
     // important for cases where we split the kernel iterations and assign different schedules to different iters
     std::string EdgesetApplyFunctionDeclGenerator::genFunctionName(mir::EdgeSetApplyExpr::Ptr apply) {
@@ -1072,8 +1313,63 @@ namespace graphit {
             output_name += "_pull_edge_based_load_balance";
         }
 
+        if (apply->use_push_edge_based_load_balance){
+            output_name += "_push_edge_based_load_balance";
+        }
+
+        if (apply->use_dense_push_edge_based_load_balance){
+            output_name += "_dense_push_edge_based_load_balance";
+        }
+
+        if (apply->use_thread_local_frontier){
+            output_name += "_thread_local_frontier";
+        }
+
+        if (apply->use_simd_pull){
+            output_name += "_simd_pull";
+        }
+
+        if (apply->is_ordered){
+            output_name += "_ordered";
+        }
+
+        if (apply->compressed_edge_code == "ByteCode"){
+            output_name += "_byte_compressed";
+        } else if (apply->compressed_edge_code == "NibbleCode"){
+            output_name += "_nibble_compressed";
+        }
+
+        bool is_hybrid = mir::isa<mir::HybridDenseEdgeSetApplyExpr>(apply)
+                         || mir::isa<mir::HybridDenseForwardEdgeSetApplyExpr>(apply);
+        if (is_hybrid && apply->direction_threshold != 20){
+            output_name += "_threshold_" + std::to_string(apply->direction_threshold);
+        }
+
+        // the segments (and the measured costs of adaptive applies) belong to the label,
+        // applies with different labels can not share a declaration
+        std::string label = apply->scope_label_name;
+        std::replace(label.begin(), label.end(), ':', '_');
+        if (isCacheAware(apply)) {
+            output_name += "_segmented_" + label;
+        }
+        if (is_hybrid && apply->adaptive_direction) {
+            output_name += "_adaptive_" + label;
+        }
+
         return output_name;
     }
 
+    std::string EdgesetApplyFunctionDeclGenerator::genLoopBegin(bool parallel, std::string type, std::string var,
+                                                                std::string begin, std::string end) {
+        if (parallel && work_stealing_)
+            return "builtin_parallelFor(" + begin + ", " + end + ", [&] (" + type + " " + var + ") {";
+        return std::string(parallel ? "parallel_for" : "for") + " (" + type + " " + var + " = " + begin + "; "
+               + var + " < " + end + "; " + var + "++) {";
+    }
 
+    std::string EdgesetApplyFunctionDeclGenerator::genLoopEnd(bool parallel, std::string grain) {
+        if (!parallel || !work_stealing_)
+            return "}";
+        return grain == "" ? "});" : "}, " + grain + ");";
+    }
 }
@@ -1103,6 +1103,11 @@ namespace graphit {
             if (apply_expr->to_expr){
                 to_expr = apply_expr->to_expr->clone<ToExpr>();
             }
+            if (apply_expr->change_tracking_field){
+                change_tracking_field = apply_expr->change_tracking_field->clone<Identifier>();
+            }
+            disable_deduplication = apply_expr->disable_deduplication;
+            is_ordered = apply_expr->is_ordered;
         }
 
         FIRNode::Ptr ApplyExpr::cloneNode() {
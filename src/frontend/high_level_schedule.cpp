@@ -292,19 +292,39 @@ namespace graphit {
                            ApplySchedule::OtherOpt::QUEUE,
                            ApplySchedule::PullFrontierType::BOOL_MAP,
                            ApplySchedule::PullLoadBalance::VERTEX_BASED,
-                           0, -100, false};
+                           0, -100, false, 1,
+                           ApplySchedule::PushLoadBalance::VERTEX_BASED, 0,
+                           ApplySchedule::EdgeLayout::CSR,
+                           ApplySchedule::VertexOrder::ORIGINAL,
+                           ApplySchedule::SegmentPartition::FIXED_VERTEX_COUNT,
+                           20, false,
+                           ApplySchedule::PushLoadBalance::VERTEX_BASED, 0,
+                           ApplySchedule::FrontierOutput::EDGE_ARRAY,
+                           ApplySchedule::PullKernel::SCALAR};
             }
 
             if (apply_schedule_str == "pull_edge_based_load_balance") {
                 (*schedule_->apply_schedules)[apply_label].pull_load_balance_type
                         = ApplySchedule::PullLoadBalance::EDGE_BASED;
                 (*schedule_->apply_schedules)[apply_label].pull_load_balance_edge_grain_size = parameter;
+            } else if (apply_schedule_str == "push_edge_based_load_balance") {
+                (*schedule_->apply_schedules)[apply_label].push_load_balance_type
+                        = ApplySchedule::PushLoadBalance::EDGE_BASED;
+                (*schedule_->apply_schedules)[apply_label].push_load_balance_edge_grain_size = parameter;
+            } else if (apply_schedule_str == "dense_push_edge_based_load_balance") {
+                (*schedule_->apply_schedules)[apply_label].dense_push_load_balance_type
+                        = ApplySchedule::PushLoadBalance::EDGE_BASED;
+                (*schedule_->apply_schedules)[apply_label].dense_push_load_balance_edge_grain_size = parameter;
             } else if (apply_schedule_str == "pull") {
                 (*schedule_->apply_schedules)[apply_label].direction_type = ApplySchedule::DirectionType::PULL;
             } else if (apply_schedule_str == "hybrid_dense") {
                 (*schedule_->apply_schedules)[apply_label].direction_type = ApplySchedule::DirectionType::HYBRID_DENSE;
             } else if (apply_schedule_str == "num_segment") {
                 (*schedule_->apply_schedules)[apply_label].num_segment = parameter;
+            } else if (apply_schedule_str == "delta") {
+                (*schedule_->apply_schedules)[apply_label].delta = parameter;
+            } else if (apply_schedule_str == "direction_threshold") {
+                (*schedule_->apply_schedules)[apply_label].direction_threshold = parameter;
             } else {
                 std::cout << "unrecognized schedule for apply: " << apply_schedule_str << std::endl;
                 exit(0);
@@ -339,7 +359,15 @@ namespace graphit {
                            ApplySchedule::OtherOpt::QUEUE,
                            ApplySchedule::PullFrontierType::BOOL_MAP,
                            ApplySchedule::PullLoadBalance::VERTEX_BASED,
-                           0, -100, false};
+                           0, -100, false, 1,
+                           ApplySchedule::PushLoadBalance::VERTEX_BASED, 0,
+                           ApplySchedule::EdgeLayout::CSR,
+                           ApplySchedule::VertexOrder::ORIGINAL,
+                           ApplySchedule::SegmentPartition::FIXED_VERTEX_COUNT,
+                           20, false,
+                           ApplySchedule::PushLoadBalance::VERTEX_BASED, 0,
+                           ApplySchedule::FrontierOutput::EDGE_ARRAY,
+                           ApplySchedule::PullKernel::SCALAR};
             }
 
 
@@ -366,8 +394,44 @@ namespace graphit {
             } else if (apply_schedule_str == "pull_edge_based_load_balance") {
                 (*schedule_->apply_schedules)[apply_label].pull_load_balance_type
                         = ApplySchedule::PullLoadBalance::EDGE_BASED;
+            } else if (apply_schedule_str == "push_edge_based_load_balance") {
+                (*schedule_->apply_schedules)[apply_label].push_load_balance_type
+                        = ApplySchedule::PushLoadBalance::EDGE_BASED;
+            } else if (apply_schedule_str == "dense_push_edge_based_load_balance") {
+                (*schedule_->apply_schedules)[apply_label].dense_push_load_balance_type
+                        = ApplySchedule::PushLoadBalance::EDGE_BASED;
+            } else if (apply_schedule_str == "edge_array_frontier") {
+                (*schedule_->apply_schedules)[apply_label].frontier_output = ApplySchedule::FrontierOutput::EDGE_ARRAY;
+            } else if (apply_schedule_str == "thread_local_frontier") {
+                (*schedule_->apply_schedules)[apply_label].frontier_output = ApplySchedule::FrontierOutput::THREAD_LOCAL_BUFFERS;
+            } else if (apply_schedule_str == "scalar_pull_kernel") {
+                (*schedule_->apply_schedules)[apply_label].pull_kernel = ApplySchedule::PullKernel::SCALAR;
+            } else if (apply_schedule_str == "simd_pull_kernel") {
+                (*schedule_->apply_schedules)[apply_label].pull_kernel = ApplySchedule::PullKernel::SIMD;
             } else if (apply_schedule_str == "numa_aware") {
                 (*schedule_->apply_schedules)[apply_label].numa_aware = true;
+            } else if (apply_schedule_str == "csr_edges") {
+                (*schedule_->apply_schedules)[apply_label].edge_layout = ApplySchedule::EdgeLayout::CSR;
+            } else if (apply_schedule_str == "byte_compressed_edges") {
+                (*schedule_->apply_schedules)[apply_label].edge_layout = ApplySchedule::EdgeLayout::BYTE_COMPRESSED;
+            } else if (apply_schedule_str == "nibble_compressed_edges") {
+                (*schedule_->apply_schedules)[apply_label].edge_layout = ApplySchedule::EdgeLayout::NIBBLE_COMPRESSED;
+            } else if (apply_schedule_str == "original_vertex_order") {
+                (*schedule_->apply_schedules)[apply_label].vertex_order = ApplySchedule::VertexOrder::ORIGINAL;
+            } else if (apply_schedule_str == "degree_sort_vertex_order") {
+                (*schedule_->apply_schedules)[apply_label].vertex_order = ApplySchedule::VertexOrder::DEGREE_SORT;
+            } else if (apply_schedule_str == "hub_cluster_vertex_order") {
+                (*schedule_->apply_schedules)[apply_label].vertex_order = ApplySchedule::VertexOrder::HUB_CLUSTER;
+            } else if (apply_schedule_str == "rcm_vertex_order") {
+                (*schedule_->apply_schedules)[apply_label].vertex_order = ApplySchedule::VertexOrder::RCM;
+            } else if (apply_schedule_str == "fixed_vertex_count_segments") {
+                (*schedule_->apply_schedules)[apply_label].segment_partition = ApplySchedule::SegmentPartition::FIXED_VERTEX_COUNT;
+            } else if (apply_schedule_str == "edge_aware_segments") {
+                (*schedule_->apply_schedules)[apply_label].segment_partition = ApplySchedule::SegmentPartition::EDGE_AWARE_VERTEX_COUNT;
+            } else if (apply_schedule_str == "fixed_direction") {
+                (*schedule_->apply_schedules)[apply_label].adaptive_direction = false;
+            } else if (apply_schedule_str == "adaptive_direction") {
+                (*schedule_->apply_schedules)[apply_label].adaptive_direction = true;
             } else {
                 std::cout << "unrecognized schedule for apply: " << apply_schedule_str << std::endl;
                 exit(0);
@@ -376,6 +440,29 @@ namespace graphit {
             return this->shared_from_this();
         }
 
+        high_level_schedule::ProgramScheduleNode::Ptr
+        high_level_schedule::ProgramScheduleNode::configVectorNUMA(std::string vector_name,
+                                                                   std::string config) {
+            // If no schedule has been constructed, construct a new one
+            if (schedule_ == nullptr) {
+                schedule_ = new Schedule();
+            }
+
+            if (config == "first-touch") {
+                schedule_->vector_numa_placements[vector_name] = FieldVectorNumaPlacement::FIRST_TOUCH;
+            } else if (config == "interleaved") {
+                schedule_->vector_numa_placements[vector_name] = FieldVectorNumaPlacement::INTERLEAVED;
+            } else if (config == "partitioned") {
+                schedule_->vector_numa_placements[vector_name] = FieldVectorNumaPlacement::PARTITIONED;
+            } else if (config == "replicated") {
+                schedule_->vector_numa_placements[vector_name] = FieldVectorNumaPlacement::REPLICATED;
+            } else {
+                throw "Unsupported Schedule!";
+            }
+
+            return this->shared_from_this();
+        }
+
         //DEPRECATED
         high_level_schedule::ProgramScheduleNode::Ptr
         high_level_schedule::ProgramScheduleNode::setVertexSet(std::string vertexset_label,
@@ -606,13 +693,17 @@ namespace graphit {
                     } else if (apply_parallel == "edge-aware-dynamic-vertex-parallel") {
                         gis.setPTTag(GraphIterationSpace::Dimension::BSG, Tags::PT_Tag::EdgeAwareVertexCount);
                         gis.setPRTag(GraphIterationSpace::Dimension::BSG, Tags::PR_Tag::WorkStealingPar);
+                    } else if (apply_parallel == "edge-parallel") {
+                        // splits the adjacency lists of the frontier across threads (SparsePush only)
+                        gis.setPTTag(GraphIterationSpace::Dimension::BSG, Tags::PT_Tag::FixedEdgeCount);
+                        gis.setPRTag(GraphIterationSpace::Dimension::BSG, Tags::PR_Tag::WorkStealingPar);
                     } else {
                         std::cout << "unsupported parallelization strategy: " << apply_parallel << std::endl;
                         throw "Unsupported Schedule!";
 
                     }
 
-                    if (grain_size != 1024) {
+                    if (grain_size != -1) {
                         //if the grain size is not the default size
                         gis.BSG_grain_size = grain_size;
                     }
@@ -623,10 +714,18 @@ namespace graphit {
             //for now, we still use the old API, it will slowly be deprecated
             if (parallelCompatibilityMap_.find(apply_parallel) != parallelCompatibilityMap_.end()) {
                 std::string old_par_schedule = parallelCompatibilityMap_[apply_parallel];
-                if (apply_parallel == "edge-aware-dynamic-vertex-parallel") {
+                if (apply_parallel == "edge-aware-dynamic-vertex-parallel" && direction == "DensePush") {
+                    //the grain size is the number of out edges in a chunk of sources
+                    setApply(apply_label, "dense_push_edge_based_load_balance", grain_size != -1 ? grain_size : 0);
+                    return setApply(apply_label, old_par_schedule);
+                } else if (apply_parallel == "edge-aware-dynamic-vertex-parallel") {
                     //need a separate specification in the old API
                     setApply(apply_label, "pull_edge_based_load_balance");
                     return setApply(apply_label, old_par_schedule);
+                } else if (apply_parallel == "edge-parallel") {
+                    //the grain size is the number of edges in a chunk
+                    setApply(apply_label, "push_edge_based_load_balance", grain_size != -1 ? grain_size : 0);
+                    return setApply(apply_label, old_par_schedule);
                 } else {
                     return setApply(apply_label, old_par_schedule);
                 }
@@ -703,22 +802,26 @@ namespace graphit {
             auto gis_vec = (*schedule_->graph_iter_spaces)[apply_label];
             int argv_number;
 
+            bool matched = false;
             for (auto &gis : *gis_vec) {
                 if (gis.scheduling_api_direction == direction || direction == "all") {
-                    if (config == "fixed-vertex-count"){
-                        if (gis.scheduling_api_direction != "DensePull"){
-                            //currently, we don't support any direction other than DensePull for graph partitioning
-                            // push based partitioning is coming
-                            std::cout << "unsupported direction for partition SSGs: "  << gis.scheduling_api_direction << std::endl;
-                            throw "Unsupported Schedule!";
-                        }
-                        gis.setPTTag(GraphIterationSpace::Dimension::SSG, Tags::PT_Tag::FixedVertexCount);
-                    } else if (config == "edge-aware-vertex-count"){
-                        gis.setPTTag(GraphIterationSpace::Dimension::SSG, Tags::PT_Tag::EdgeAwareVertexCount);
+                    matched = true;
+                    if (config != "fixed-vertex-count" && config != "edge-aware-vertex-count"){
                         throw "Unsupported Schedule!";
-                    } else {
+                    }
+                    if (gis.scheduling_api_direction != "DensePull" && gis.scheduling_api_direction != "DensePush"){
+                        //DensePull partitions the in edges by source, DensePush the out edges by destination
+                        std::cout << "unsupported direction for partition SSGs: "  << gis.scheduling_api_direction << std::endl;
+                        throw "Unsupported Schedule!";
+                    }
+                    if (gis.scheduling_api_direction == "DensePush" && gis_vec->size() == 1){
+                        //only the dense forward half of a hybrid apply traverses the push segments
+                        std::cout << "partition SSGs of DensePush need the SparsePush-DensePush direction" << std::endl;
                         throw "Unsupported Schedule!";
                     }
+                    //edge aware segments get about the same number of edges instead of the same number of vertices
+                    gis.setPTTag(GraphIterationSpace::Dimension::SSG, config == "fixed-vertex-count" ?
+                                 Tags::PT_Tag::FixedVertexCount : Tags::PT_Tag::EdgeAwareVertexCount);
 
                     // use string rfind insted of regular expression because gcc older than 4.9.0 does not support regular expression
                     //regex argv_regex ("argv\\[(\\d)\\]");
@@ -740,7 +843,14 @@ namespace graphit {
                 }
             }
 
+            if (!matched){
+                //the segments would be built for a traversal the apply does not have
+                std::cout << "no " << direction << " traversal to partition in apply " << apply_label << std::endl;
+                throw "Unsupported Schedule!";
+            }
+
             // for now, we still use the old setApply API. We will probably switch to full graph iteration space soon
+            setApply(apply_label, config == "fixed-vertex-count" ? "fixed_vertex_count_segments" : "edge_aware_segments");
             return setApply(apply_label, "num_segment", argv_number);
 
         }
@@ -753,27 +863,38 @@ namespace graphit {
             initGraphIterationSpaceIfNeeded(apply_label);
             auto gis_vec = (*schedule_->graph_iter_spaces)[apply_label];
 
+            bool matched = false;
             for (auto &gis : *gis_vec) {
                 if (gis.scheduling_api_direction == direction || direction == "all") {
-                    if (config == "fixed-vertex-count"){
-                        if (gis.scheduling_api_direction != "DensePull"){
-                            //currently, we don't support any direction other than DensePull for graph partitioning
-                            // push based partitioning is coming
-                            std::cout << "unsupported direction for partition SSGs: "  << gis.scheduling_api_direction << std::endl;
-                            throw "Unsupported Schedule!";
-                        }
-                        gis.setPTTag(GraphIterationSpace::Dimension::SSG, Tags::PT_Tag::FixedVertexCount);
-                    } else if (config == "edge-aware-vertex-count"){
-                        gis.setPTTag(GraphIterationSpace::Dimension::SSG, Tags::PT_Tag::EdgeAwareVertexCount);
+                    matched = true;
+                    if (config != "fixed-vertex-count" && config != "edge-aware-vertex-count"){
                         throw "Unsupported Schedule!";
-                    } else {
+                    }
+                    if (gis.scheduling_api_direction != "DensePull" && gis.scheduling_api_direction != "DensePush"){
+                        //DensePull partitions the in edges by source, DensePush the out edges by destination
+                        std::cout << "unsupported direction for partition SSGs: "  << gis.scheduling_api_direction << std::endl;
+                        throw "Unsupported Schedule!";
+                    }
+                    if (gis.scheduling_api_direction == "DensePush" && gis_vec->size() == 1){
+                        //only the dense forward half of a hybrid apply traverses the push segments
+                        std::cout << "partition SSGs of DensePush need the SparsePush-DensePush direction" << std::endl;
                         throw "Unsupported Schedule!";
                     }
+                    //edge aware segments get about the same number of edges instead of the same number of vertices
+                    gis.setPTTag(GraphIterationSpace::Dimension::SSG, config == "fixed-vertex-count" ?
+                                 Tags::PT_Tag::FixedVertexCount : Tags::PT_Tag::EdgeAwareVertexCount);
                     assert(num_segment > 0);
                     gis.num_ssg = num_segment;
                 }
             }
 
+            if (!matched){
+                //the segments would be built for a traversal the apply does not have
+                std::cout << "no " << direction << " traversal to partition in apply " << apply_label << std::endl;
+                throw "Unsupported Schedule!";
+            }
+
+            setApply(apply_label, config == "fixed-vertex-count" ? "fixed_vertex_count_segments" : "edge_aware_segments");
             return setApply(apply_label, "num_segment", num_segment);
         }
 
@@ -823,5 +944,96 @@ namespace graphit {
                 return this->shared_from_this();
         }
 
+        high_level_schedule::ProgramScheduleNode::Ptr
+        high_level_schedule::ProgramScheduleNode::configApplyEdgeLayout(std::string apply_label,
+                                                                        std::string config) {
+            if (config == "csr") {
+                return setApply(apply_label, "csr_edges");
+            } else if (config == "byte-compressed") {
+                return setApply(apply_label, "byte_compressed_edges");
+            } else if (config == "nibble-compressed") {
+                return setApply(apply_label, "nibble_compressed_edges");
+            } else {
+                std::cout << "unsupported edge layout: " << config << std::endl;
+                throw "Unsupported Schedule!";
+            }
+        }
+
+        high_level_schedule::ProgramScheduleNode::Ptr
+        high_level_schedule::ProgramScheduleNode::configApplyPullKernel(std::string apply_label,
+                                                                        std::string config) {
+            if (config == "scalar") {
+                return setApply(apply_label, "scalar_pull_kernel");
+            } else if (config == "simd") {
+                return setApply(apply_label, "simd_pull_kernel");
+            } else {
+                std::cout << "unsupported pull kernel: " << config << std::endl;
+                throw "Unsupported Schedule!";
+            }
+        }
+
+        high_level_schedule::ProgramScheduleNode::Ptr
+        high_level_schedule::ProgramScheduleNode::configApplyVertexOrder(std::string apply_label,
+                                                                         std::string config) {
+            if (config == "original") {
+                return setApply(apply_label, "original_vertex_order");
+            } else if (config == "degree-sort") {
+                return setApply(apply_label, "degree_sort_vertex_order");
+            } else if (config == "hub-cluster") {
+                return setApply(apply_label, "hub_cluster_vertex_order");
+            } else if (config == "rcm") {
+                return setApply(apply_label, "rcm_vertex_order");
+            } else {
+                std::cout << "unsupported vertex order: " << config << std::endl;
+                throw "Unsupported Schedule!";
+            }
+        }
+
+        high_level_schedule::ProgramScheduleNode::Ptr
+        high_level_schedule::ProgramScheduleNode::configApplyPriorityUpdateDelta(std::string apply_label,
+                                                                                 int delta) {
+            if (delta <= 0) {
+                std::cout << "priority update delta has to be positive: " << delta << std::endl;
+                throw "Unsupported Schedule!";
+            }
+            return setApply(apply_label, "delta", delta);
+        }
+
+        high_level_schedule::ProgramScheduleNode::Ptr
+        high_level_schedule::ProgramScheduleNode::configApplyDirectionThreshold(std::string apply_label,
+                                                                                int threshold) {
+            if (threshold <= 0) {
+                std::cout << "direction threshold has to be positive: " << threshold << std::endl;
+                throw "Unsupported Schedule!";
+            }
+            return setApply(apply_label, "direction_threshold", threshold);
+        }
+
+        high_level_schedule::ProgramScheduleNode::Ptr
+        high_level_schedule::ProgramScheduleNode::configApplyDirectionThreshold(std::string apply_label,
+                                                                                std::string config) {
+            if (config == "fixed") {
+                return setApply(apply_label, "fixed_direction");
+            } else if (config == "adaptive") {
+                return setApply(apply_label, "adaptive_direction");
+            } else {
+                std::cout << "unsupported direction threshold: " << config << std::endl;
+                throw "Unsupported Schedule!";
+            }
+        }
+
+        high_level_schedule::ProgramScheduleNode::Ptr
+        high_level_schedule::ProgramScheduleNode::configApplyFrontierOutput(std::string apply_label,
+                                                                            std::string config) {
+            if (config == "edge-array") {
+                return setApply(apply_label, "edge_array_frontier");
+            } else if (config == "thread-local-buffers") {
+                return setApply(apply_label, "thread_local_frontier");
+            } else {
+                std::cout << "unsupported frontier output: " << config << std::endl;
+                throw "Unsupported Schedule!";
+            }
+        }
+
     }
 }
@@ -1195,7 +1195,8 @@ namespace graphit {
 
 // DEPRECATED SIMIT GRAMMR: field_read_expr: set_read_expr ['.' ident]
 // field_read_expr: set_read_expr {'.' (ident( [ expr_params ] )) | apply '(' ident ')' | where '(' ident ')'
-// | from '(' expr ')' '.' to '(' expr ')''.' apply '(' ident ')' ['.' modified '(' ident ')'],}
+// | from '(' expr ')' '.' to '(' expr ')''.' apply '(' ident ')' ['.' modified '(' ident ')']
+// | from '(' ident ')' '.' applyUpdatePriority '(' ident ',' ident ')',}
     fir::Expr::Ptr Parser::parseFieldReadExpr() {
         // We don't need to supprot set read expressions, so we just work with factors directly
         //fir::Expr::Ptr expr = parseSetReadExpr();
@@ -1249,7 +1250,7 @@ namespace graphit {
                     consume(Token::Type::PERIOD);
                 }
 
-                // FROM and To has to end with either apply modified or apply for now
+                // FROM and To has to end with either apply modified, apply update priority or apply for now
                 if (tryConsume(Token::Type::APPLYMODIFIED)) {
                     consume(Token::Type::LP);
                     apply_expr->target = expr;
@@ -1271,6 +1272,15 @@ namespace graphit {
                         }
                     }
 
+                } else if (tryConsume(Token::Type::APPLYUPDATEPRIORITY)) {
+                    //.from(vertexset).applyUpdatePriority(func, priority_field)
+                    consume(Token::Type::LP);
+                    apply_expr->target = expr;
+                    apply_expr->input_function = parseIdent();
+                    apply_expr->from_expr = from_expr;
+                    consume(Token::Type::COMMA);
+                    apply_expr->change_tracking_field = parseIdent();
+                    apply_expr->is_ordered = true;
                 } else {
                     consume(Token::Type::APPLY);
                     consume(Token::Type::LP);
@@ -2588,6 +2598,9 @@ namespace graphit {
         //library functions for edgeset
         intrinsics_.push_back("getVertices");
         intrinsics_.push_back("getOutDegrees");
+        intrinsics_.push_back("insertBatch");
+        intrinsics_.push_back("deleteBatch");
+        intrinsics_.push_back("getBatchVertices");
 
         // library functions for vertexset
         intrinsics_.push_back("getVertexSetSize");
@@ -28,6 +28,7 @@ namespace graphit {
         if (token == "inout") return Token::Type::INOUT;
         if (token == "apply") return Token::Type::APPLY;
         if (token == "applyModified") return Token::Type::APPLYMODIFIED;
+        if (token == "applyUpdatePriority") return Token::Type::APPLYUPDATEPRIORITY;
         if (token == "map") return Token::Type::MAP;
         if (token == "to") return Token::Type::TO;
         if (token == "dstFilter") return Token::Type::DST_FILTER;
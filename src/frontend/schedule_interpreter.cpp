@@ -0,0 +1,343 @@
+#include <graphit/frontend/schedule_interpreter.h>
+#include <cctype>
+#include <cstdlib>
+
+namespace graphit {
+
+    int splitScheduleBlock(std::istream &input, std::string &algorithm, std::string &schedule) {
+        std::string line;
+        int line_number = 0;
+        int schedule_line = 0;
+        while (std::getline(input, line)) {
+            line_number++;
+            if (schedule_line == 0 && line.compare(0, 9, "schedule:") == 0) {
+                schedule_line = line_number;
+                // keep the line count of the algorithm intact for parse errors
+                algorithm += "\n";
+                continue;
+            }
+            if (schedule_line == 0)
+                algorithm += line + "\n";
+            else
+                schedule += line + "\n";
+        }
+        return schedule_line;
+    }
+
+    bool ScheduleInterpreter::interpret(const std::string &schedule, int first_line) {
+        tokens_.clear();
+        current_ = 0;
+        if (!tokenize(schedule, first_line))
+            return false;
+        while (tokens_[current_].type != Token::Type::END) {
+            if (!parseStatement())
+                return false;
+        }
+        return true;
+    }
+
+    bool ScheduleInterpreter::tokenize(const std::string &schedule, int first_line) {
+        int line = first_line;
+        int column = 1;
+        unsigned i = 0;
+        auto advance = [&]() {
+            if (schedule[i] == '\n') {
+                line++;
+                column = 1;
+            } else {
+                column++;
+            }
+            i++;
+        };
+        while (i < schedule.size()) {
+            char c = schedule[i];
+            if (std::isspace(c)) {
+                advance();
+                continue;
+            }
+            if (c == '/' && i + 1 < schedule.size() && schedule[i + 1] == '/') {
+                while (i < schedule.size() && schedule[i] != '\n')
+                    advance();
+                continue;
+            }
+            if (c == '/' && i + 1 < schedule.size() && schedule[i + 1] == '*') {
+                advance();
+                advance();
+                while (i < schedule.size() && !(schedule[i] == '*' && i + 1 < schedule.size() && schedule[i + 1] == '/'))
+                    advance();
+                if (i >= schedule.size()) {
+                    errors_->push_back(ParseError(line, column, line, column, "unterminated comment in schedule"));
+                    return false;
+                }
+                advance();
+                advance();
+                continue;
+            }
+
+            Token token;
+            token.line = line;
+            token.column = column;
+            if (std::isalpha(c) || c == '_') {
+                token.type = Token::Type::IDENT;
+                while (i < schedule.size() && (std::isalnum(schedule[i]) || schedule[i] == '_')) {
+                    token.str += schedule[i];
+                    advance();
+                }
+            } else if (std::isdigit(c) || (c == '-' && i + 1 < schedule.size() && std::isdigit(schedule[i + 1]))) {
+                token.type = Token::Type::INT;
+                token.str += c;
+                advance();
+                while (i < schedule.size() && std::isdigit(schedule[i])) {
+                    token.str += schedule[i];
+                    advance();
+                }
+            } else if (c == '-' && i + 1 < schedule.size() && schedule[i + 1] == '>') {
+                token.type = Token::Type::ARROW;
+                token.str = "->";
+                advance();
+                advance();
+            } else if (c == '"') {
+                token.type = Token::Type::STRING;
+                advance();
+                while (i < schedule.size() && schedule[i] != '"' && schedule[i] != '\n') {
+                    token.str += schedule[i];
+                    advance();
+                }
+                if (i >= schedule.size() || schedule[i] != '"') {
+                    errors_->push_back(ParseError(token.line, token.column, line, column,
+                                                  "unterminated string literal in schedule"));
+                    return false;
+                }
+                advance();
+            } else {
+                switch (c) {
+                    case '(': token.type = Token::Type::LPAREN; break;
+                    case ')': token.type = Token::Type::RPAREN; break;
+                    case '{': token.type = Token::Type::LBRACE; break;
+                    case '}': token.type = Token::Type::RBRACE; break;
+                    case ',': token.type = Token::Type::COMMA; break;
+                    case ';': token.type = Token::Type::SEMICOLON; break;
+                    default:
+                        errors_->push_back(ParseError(line, column, line, column,
+                                                      std::string("unexpected character '") + c + "' in schedule"));
+                        return false;
+                }
+                token.str = c;
+                advance();
+            }
+            tokens_.push_back(token);
+        }
+        Token end;
+        end.type = Token::Type::END;
+        end.str = "end of schedule";
+        end.line = line;
+        end.column = column;
+        tokens_.push_back(end);
+        return true;
+    }
+
+    // statement: program ('->' call)+ ';'
+    bool ScheduleInterpreter::parseStatement() {
+        const Token &receiver = tokens_[current_];
+        if (receiver.type != Token::Type::IDENT || receiver.str != "program") {
+            reportError(receiver, "expected 'program' at the start of a schedule statement, found '" + receiver.str + "'");
+            return false;
+        }
+        current_++;
+        if (!expect(Token::Type::ARROW, "'->'"))
+            return false;
+        if (!parseCall())
+            return false;
+        while (tokens_[current_].type == Token::Type::ARROW) {
+            current_++;
+            if (!parseCall())
+                return false;
+        }
+        return expect(Token::Type::SEMICOLON, "';'");
+    }
+
+    // call: name '(' [argument (',' argument)*] ')'
+    bool ScheduleInterpreter::parseCall() {
+        const Token &name = tokens_[current_];
+        if (name.type != Token::Type::IDENT) {
+            reportError(name, "expected a schedule function name, found '" + name.str + "'");
+            return false;
+        }
+        current_++;
+        if (!expect(Token::Type::LPAREN, "'('"))
+            return false;
+        std::vector<Argument> args;
+        if (tokens_[current_].type != Token::Type::RPAREN) {
+            Argument arg;
+            if (!parseArgument(arg))
+                return false;
+            args.push_back(arg);
+            while (tokens_[current_].type == Token::Type::COMMA) {
+                current_++;
+                if (!parseArgument(arg))
+                    return false;
+                args.push_back(arg);
+            }
+        }
+        if (!expect(Token::Type::RPAREN, "')'"))
+            return false;
+        if (!apply(name.str, args)) {
+            std::string signature = name.str + "(";
+            for (unsigned i = 0; i < args.size(); i++) {
+                if (i != 0) signature += ", ";
+                signature += args[i].type == Argument::Type::STRING ? "string"
+                             : args[i].type == Argument::Type::INT ? "int" : "{string, ...}";
+            }
+            reportError(name, "no schedule function matches " + signature + ")");
+            return false;
+        }
+        return true;
+    }
+
+    bool ScheduleInterpreter::parseArgument(Argument &arg) {
+        const Token &token = tokens_[current_];
+        arg.list.clear();
+        switch (token.type) {
+            case Token::Type::STRING:
+                arg.type = Argument::Type::STRING;
+                arg.str = token.str;
+                current_++;
+                return true;
+            case Token::Type::INT:
+                arg.type = Argument::Type::INT;
+                arg.num = std::atoi(token.str.c_str());
+                current_++;
+                return true;
+            case Token::Type::LBRACE:
+                arg.type = Argument::Type::STRING_LIST;
+                current_++;
+                while (tokens_[current_].type == Token::Type::STRING) {
+                    arg.list.push_back(tokens_[current_].str);
+                    current_++;
+                    if (tokens_[current_].type != Token::Type::COMMA)
+                        break;
+                    current_++;
+                }
+                return expect(Token::Type::RBRACE, "'}'");
+            default:
+                reportError(token, "expected a string, integer or {...} argument, found '" + token.str + "'");
+                return false;
+        }
+    }
+
+    bool ScheduleInterpreter::expect(Token::Type type, const std::string &what) {
+        const Token &token = tokens_[current_];
+        if (token.type != type) {
+            reportError(token, "expected " + what + ", found '" + token.str + "'");
+            return false;
+        }
+        current_++;
+        return true;
+    }
+
+    void ScheduleInterpreter::reportError(const Token &token, const std::string &msg) {
+        errors_->push_back(ParseError(token.line, token.column, token.line,
+                                      token.column + (int) token.str.size(), msg));
+    }
+
+    // signature has one character per argument: s for string, i for integer, l for {string, ...}
+    bool ScheduleInterpreter::matches(const std::vector<Argument> &args, const std::string &signature) {
+        if (args.size() != signature.size())
+            return false;
+        for (unsigned i = 0; i < args.size(); i++) {
+            Argument::Type expected = signature[i] == 's' ? Argument::Type::STRING
+                                      : signature[i] == 'i' ? Argument::Type::INT : Argument::Type::STRING_LIST;
+            if (args[i].type != expected)
+                return false;
+        }
+        return true;
+    }
+
+    bool ScheduleInterpreter::apply(const std::string &method, const std::vector<Argument> &args) {
+        const std::vector<Argument> &a = args;
+
+        if (method == "fuseFields") {
+            if (matches(a, "ss")) program_->fuseFields(a[0].str, a[1].str);
+            else if (matches(a, "l")) program_->fuseFields(a[0].list);
+            else return false;
+        } else if (method == "configVectorNUMA") {
+            if (matches(a, "ss")) program_->configVectorNUMA(a[0].str, a[1].str);
+            else return false;
+        } else if (method == "splitForLoop") {
+            if (matches(a, "sssii")) program_->splitForLoop(a[0].str, a[1].str, a[2].str, a[3].num, a[4].num);
+            else return false;
+        } else if (method == "fuseForLoop") {
+            if (matches(a, "sss")) program_->fuseForLoop(a[0].str, a[1].str, a[2].str);
+            else return false;
+        } else if (method == "fuseApplyFunctions") {
+            if (matches(a, "sss")) program_->fuseApplyFunctions(a[0].str, a[1].str, a[2].str);
+            else return false;
+        } else if (method == "configApplyDirection") {
+            if (matches(a, "ss")) program_->configApplyDirection(a[0].str, a[1].str);
+            else return false;
+        } else if (method == "configApplyParallelization") {
+            if (matches(a, "ss")) program_->configApplyParallelization(a[0].str, a[1].str);
+            else if (matches(a, "ssi")) program_->configApplyParallelization(a[0].str, a[1].str, a[2].num);
+            else if (matches(a, "ssis"))
+                program_->configApplyParallelization(a[0].str, a[1].str, a[2].num, a[3].str);
+            else return false;
+        } else if (method == "configApplyDeduplication") {
+            if (matches(a, "ss")) program_->configApplyDeduplication(a[0].str, a[1].str);
+            else return false;
+        } else if (method == "configApplyDataStructure") {
+            if (matches(a, "ss")) program_->configApplyDataStructure(a[0].str, a[1].str);
+            else return false;
+        } else if (method == "configApplyDenseVertexSet") {
+            if (matches(a, "ss")) program_->configApplyDenseVertexSet(a[0].str, a[1].str);
+            else if (matches(a, "sss")) program_->configApplyDenseVertexSet(a[0].str, a[1].str, a[2].str);
+            else if (matches(a, "ssss"))
+                program_->configApplyDenseVertexSet(a[0].str, a[1].str, a[2].str, a[3].str);
+            else return false;
+        } else if (method == "configApplyNumSegments") {
+            if (matches(a, "si")) program_->configApplyNumSegments(a[0].str, a[1].num);
+            else return false;
+        } else if (method == "configApplyNumSSG") {
+            if (matches(a, "ssi")) program_->configApplyNumSSG(a[0].str, a[1].str, a[2].num);
+            else if (matches(a, "ssis")) program_->configApplyNumSSG(a[0].str, a[1].str, a[2].num, a[3].str);
+            else if (matches(a, "sss")) program_->configApplyNumSSG(a[0].str, a[1].str, a[2].str);
+            else if (matches(a, "ssss")) program_->configApplyNumSSG(a[0].str, a[1].str, a[2].str, a[3].str);
+            else return false;
+        } else if (method == "configApplyPriorityUpdateDelta") {
+            if (matches(a, "si")) program_->configApplyPriorityUpdateDelta(a[0].str, a[1].num);
+            else return false;
+        } else if (method == "configApplyDirectionThreshold") {
+            if (matches(a, "si")) program_->configApplyDirectionThreshold(a[0].str, a[1].num);
+            else if (matches(a, "ss")) program_->configApplyDirectionThreshold(a[0].str, a[1].str);
+            else return false;
+        } else if (method == "configApplyFrontierOutput") {
+            if (matches(a, "ss")) program_->configApplyFrontierOutput(a[0].str, a[1].str);
+            else return false;
+        } else if (method == "configApplyPullKernel") {
+            if (matches(a, "ss")) program_->configApplyPullKernel(a[0].str, a[1].str);
+            else return false;
+        } else if (method == "configApplyEdgeLayout") {
+            if (matches(a, "ss")) program_->configApplyEdgeLayout(a[0].str, a[1].str);
+            else return false;
+        } else if (method == "configApplyVertexOrder") {
+            if (matches(a, "ss")) program_->configApplyVertexOrder(a[0].str, a[1].str);
+            else return false;
+        } else if (method == "configApplyNumaAware") {
+            if (matches(a, "s")) program_->configApplyNumaAware(a[0].str);
+            else return false;
+        } else if (method == "configApplyNUMA") {
+            if (matches(a, "ss")) program_->configApplyNUMA(a[0].str, a[1].str);
+            else if (matches(a, "sss")) program_->configApplyNUMA(a[0].str, a[1].str, a[2].str);
+            else return false;
+        } else if (method == "setApply") {
+            if (matches(a, "ss")) program_->setApply(a[0].str, a[1].str);
+            else if (matches(a, "ssi")) program_->setApply(a[0].str, a[1].str, a[2].num);
+            else return false;
+        } else if (method == "setVertexSet") {
+            if (matches(a, "ss")) program_->setVertexSet(a[0].str, a[1].str);
+            else return false;
+        } else {
+            return false;
+        }
+        return true;
+    }
+}
@@ -72,6 +72,8 @@ namespace graphit {
                 return "'inout'";
             case Token::Type::APPLY:
                 return "'apply'";
+            case Token::Type::APPLYUPDATEPRIORITY:
+                return "'applyUpdatePriority'";
             case Token::Type::MAP:
                 return "'map'";
             case Token::Type::TO:
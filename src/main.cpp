@@ -8,6 +8,7 @@
 #include <graphit/frontend/error.h>
 #include <fstream>
 #include <graphit/frontend/high_level_schedule.h>
+#include <graphit/frontend/schedule_interpreter.h>
 
 using namespace graphit;
 
@@ -28,14 +29,30 @@ int main(int argc, char* argv[]) {
     if (!cli.ParseArgs())
         return -1;
     
-    //read input file into buffer
+    //read input file into buffer, the schedule block (if any) is interpreted after parsing
     std::ifstream file(cli.input_filename());
-    std::stringstream buffer;
     if(!file) {
         std::cout << "error reading the input file" << std::endl;
     }
-    buffer << file.rdbuf();
+    std::string algorithm, schedule;
+    int schedule_line = splitScheduleBlock(file, algorithm, schedule);
     file.close();
+    std::stringstream buffer(algorithm);
+
+    //a separate schedule file replaces the schedule block of the input file
+    if (cli.schedule_filename() != "") {
+        std::ifstream schedule_file(cli.schedule_filename());
+        if (!schedule_file) {
+            std::cout << "error reading the schedule file" << std::endl;
+            return -1;
+        }
+        std::string schedule_file_algorithm;
+        schedule = "";
+        schedule_line = splitScheduleBlock(schedule_file, schedule_file_algorithm, schedule);
+        // a file without a schedule: line is taken as a bare schedule
+        if (schedule_line == 0)
+            schedule = schedule_file_algorithm;
+    }
 
     //set up the output file
     std::ofstream output_file;
@@ -52,6 +69,17 @@ int main(int argc, char* argv[]) {
     user_defined_schedule(program);
 #endif
 
+    //interpret the schedule block, no need to rebuild the compiler for a new schedule
+    if (schedule != "") {
+        std::vector<ParseError> schedule_errors;
+        ScheduleInterpreter interpreter(program, &schedule_errors);
+        if (!interpreter.interpret(schedule, schedule_line + 1)) {
+            for (auto &error : schedule_errors)
+                std::cout << error << std::endl;
+            return -1;
+        }
+    }
+
     graphit::Midend* me = new graphit::Midend(context, program->getSchedule());
     me->emitMIR(mir_context);
     graphit::Backend* be = new graphit::Backend(mir_context);
@@ -59,7 +87,7 @@ int main(int argc, char* argv[]) {
     std::string python_module_path = cli.python_module_path();
     
         
-    be->emitCPP(output_file, python_module_name);
+    be->emitCPP(output_file, python_module_name, cli.instrument_applies(), cli.work_stealing());
     output_file.close();
 /*
     if (python_module_name != "") {
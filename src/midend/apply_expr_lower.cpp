@@ -12,6 +12,10 @@ namespace graphit {
         for (auto function : functions) {
             lower_apply_expr.rewrite(function);
         }
+        // transposes of edgesets are set up with the edgeset allocations of main
+        for (auto stmt : mir_context_->edgeset_alloc_stmts) {
+            stmt->accept(&lower_apply_expr);
+        }
     }
 
     void ApplyExprLower::LowerApplyExpr::visit(mir::VertexSetApplyExpr::Ptr vertexset_apply) {
@@ -36,7 +40,25 @@ namespace graphit {
         node = vertexset_apply;
     }
 
+    void ApplyExprLower::LowerApplyExpr::visit(mir::Call::Ptr call) {
+        static const std::set<std::string> csr_builtins = {"builtin_transpose", "getRandomOutNgh",
+                                                           "getRandomInNgh", "serialMinimumSpanningTree"};
+        if (csr_builtins.find(call->name) != csr_builtins.end() && !call->args.empty()
+            && mir::isa<mir::VarExpr>(call->args[0])) {
+            mir_context_->edgesets_with_csr_uses.insert(mir::to<mir::VarExpr>(call->args[0])->var.getName());
+        }
+        mir::MIRRewriter::visit(call);
+    }
+
     void ApplyExprLower::LowerApplyExpr::visit(mir::EdgeSetApplyExpr::Ptr edgeset_apply) {
+        lowerEdgeSetApply(edgeset_apply);
+        // an edgeset keeps its CSR arrays as long as one of its applies traverses them
+        if (mir::to<mir::EdgeSetApplyExpr>(node)->compressed_edge_code == "") {
+            mir_context_->edgesets_with_csr_uses.insert(mir::to<mir::VarExpr>(edgeset_apply->target)->var.getName());
+        }
+    }
+
+    void ApplyExprLower::LowerApplyExpr::lowerEdgeSetApply(mir::EdgeSetApplyExpr::Ptr edgeset_apply) {
 
         // use the target var expressionto figure out the edgeset type
         mir::VarExpr::Ptr edgeset_expr = mir::to<mir::VarExpr>(edgeset_apply->target);
@@ -50,6 +72,13 @@ namespace graphit {
             edgeset_apply->is_weighted = true;
         }
 
+        // ordered applies (applyUpdatePriority) start from the vertices of a vertexset
+        if (edgeset_apply->is_ordered && mir_context_->isFunction(edgeset_apply->from_func)) {
+            std::cout << "applyUpdatePriority requires a vertexset in from(), found function: "
+                      << edgeset_apply->from_func << std::endl;
+            exit(0);
+        }
+
         // check if the schedule contains entry for the current edgeset apply expressions
 
         if (schedule_ != nullptr && schedule_->apply_schedules != nullptr) {
@@ -62,7 +91,12 @@ namespace graphit {
                 // a schedule is found
 
                 //First figure out the direction, and allocate the relevant edgeset expression
-                if (apply_schedule->second.direction_type == ApplySchedule::DirectionType::PUSH) {
+                if (edgeset_apply->is_ordered) {
+                    //ordered applies always push from the bucket being processed, the direction is ignored
+                    auto ordered_edgeset_apply = std::make_shared<mir::PushEdgeSetApplyExpr>(edgeset_apply);
+                    ordered_edgeset_apply->priority_update_delta = apply_schedule->second.delta;
+                    node = ordered_edgeset_apply;
+                } else if (apply_schedule->second.direction_type == ApplySchedule::DirectionType::PUSH) {
                     node = std::make_shared<mir::PushEdgeSetApplyExpr>(edgeset_apply);
                 } else if (apply_schedule->second.direction_type == ApplySchedule::DirectionType::PULL) {
                     //Pull
@@ -92,8 +126,21 @@ namespace graphit {
                     mir::to<mir::EdgeSetApplyExpr>(node)->scope_label_name = apply_schedule->second.scope_label_name;
                     mir_context_->edgeset_to_label_to_num_segment[edgeset_expr->var.getName()][apply_schedule->second.scope_label_name] =
                             apply_schedule->second.num_segment;
+                    // the dense direction of SparsePush-DensePush is a push, its writes are blocked by destination
+                    if (mir::isa<mir::HybridDenseForwardEdgeSetApplyExpr>(node))
+                        mir_context_->edgeset_to_push_segment_labels[edgeset_expr->var.getName()].insert(
+                                apply_schedule->second.scope_label_name);
+                    if (apply_schedule->second.segment_partition == ApplySchedule::SegmentPartition::EDGE_AWARE_VERTEX_COUNT)
+                        mir_context_->edgeset_to_edge_aware_segment_labels[edgeset_expr->var.getName()].insert(
+                                apply_schedule->second.scope_label_name);
                 }
 
+                mir::to<mir::EdgeSetApplyExpr>(node)->direction_threshold = apply_schedule->second.direction_threshold;
+                mir::to<mir::EdgeSetApplyExpr>(node)->adaptive_direction = apply_schedule->second.adaptive_direction;
+                // the measured costs of an adaptive apply are kept per label
+                if (apply_schedule->second.adaptive_direction)
+                    mir::to<mir::EdgeSetApplyExpr>(node)->scope_label_name = apply_schedule->second.scope_label_name;
+
                 //Check to see if it is parallel or serial
                 if (apply_schedule->second.parallel_type == ApplySchedule::ParType::Parallel) {
                     mir::to<mir::EdgeSetApplyExpr>(node)->is_parallel = true;
@@ -117,6 +164,76 @@ namespace graphit {
                     }
                 }
 
+                if (apply_schedule->second.push_load_balance_type == ApplySchedule::PushLoadBalance::EDGE_BASED){
+                    mir::to<mir::EdgeSetApplyExpr>(node)->use_push_edge_based_load_balance = true;
+                    if (apply_schedule->second.push_load_balance_edge_grain_size > 0){
+                        mir::to<mir::EdgeSetApplyExpr>(node)->push_edge_based_load_balance_grain_size
+                                = apply_schedule->second.push_load_balance_edge_grain_size;
+                    }
+                }
+
+                if (apply_schedule->second.dense_push_load_balance_type == ApplySchedule::PushLoadBalance::EDGE_BASED){
+                    mir::to<mir::EdgeSetApplyExpr>(node)->use_dense_push_edge_based_load_balance = true;
+                    if (apply_schedule->second.dense_push_load_balance_edge_grain_size > 0){
+                        mir::to<mir::EdgeSetApplyExpr>(node)->dense_push_edge_based_load_balance_grain_size
+                                = apply_schedule->second.dense_push_load_balance_edge_grain_size;
+                    }
+                }
+
+                if (apply_schedule->second.frontier_output == ApplySchedule::FrontierOutput::THREAD_LOCAL_BUFFERS){
+                    mir::to<mir::EdgeSetApplyExpr>(node)->use_thread_local_frontier = true;
+                }
+
+                if (apply_schedule->second.pull_kernel == ApplySchedule::PullKernel::SIMD){
+                    mir::to<mir::EdgeSetApplyExpr>(node)->use_simd_pull = true;
+                }
+
+                if (apply_schedule->second.edge_layout != ApplySchedule::EdgeLayout::CSR) {
+                    std::string edge_code =
+                            apply_schedule->second.edge_layout == ApplySchedule::EdgeLayout::BYTE_COMPRESSED ?
+                            "ByteCode" : "NibbleCode";
+                    auto edgeset_name = edgeset_expr->var.getName();
+                    // segments and edge chunks index into the uncompressed neighbor arrays
+                    if (mir::to<mir::EdgeSetApplyExpr>(node)->use_push_edge_based_load_balance
+                        || (apply_schedule->second.num_segment > -10 && apply_schedule->second.num_segment != 0)) {
+                        std::cout << "compressed edge layouts do not support edge-parallel push or segments: "
+                                  << current_scope_name << std::endl;
+                        throw "Unsupported Schedule!";
+                    }
+                    // the edgeset keeps a single compressed copy, all of its applies have to agree on the code
+                    auto compressed = mir_context_->edgeset_to_compressed_edge_code.find(edgeset_name);
+                    if (compressed != mir_context_->edgeset_to_compressed_edge_code.end()
+                        && compressed->second != edge_code) {
+                        std::cout << "conflicting compressed edge layouts for edgeset: " << edgeset_name << std::endl;
+                        throw "Unsupported Schedule!";
+                    }
+                    mir_context_->edgeset_to_compressed_edge_code[edgeset_name] = edge_code;
+                    mir::to<mir::EdgeSetApplyExpr>(node)->compressed_edge_code = edge_code;
+                }
+
+                if (apply_schedule->second.vertex_order != ApplySchedule::VertexOrder::ORIGINAL) {
+                    std::string vertex_order;
+                    switch (apply_schedule->second.vertex_order) {
+                        case ApplySchedule::VertexOrder::DEGREE_SORT:
+                            vertex_order = "VertexOrder::DEGREE_SORT";
+                            break;
+                        case ApplySchedule::VertexOrder::HUB_CLUSTER:
+                            vertex_order = "VertexOrder::HUB_CLUSTER";
+                            break;
+                        default:
+                            vertex_order = "VertexOrder::RCM";
+                    }
+                    // the edgeset is relabeled once when it is loaded, all of its applies have to agree on the order
+                    auto edgeset_name = edgeset_expr->var.getName();
+                    auto relabeled = mir_context_->edgeset_to_vertex_order.find(edgeset_name);
+                    if (relabeled != mir_context_->edgeset_to_vertex_order.end()
+                        && relabeled->second != vertex_order) {
+                        std::cout << "conflicting vertex orders for edgeset: " << edgeset_name << std::endl;
+                        throw "Unsupported Schedule!";
+                    }
+                    mir_context_->edgeset_to_vertex_order[edgeset_name] = vertex_order;
+                }
+
                 //if this is applyModified with a tracking field
                 if (edgeset_apply->tracking_field != "") {
                     // only enable deduplication when the argument to ApplyModified is True (disable deduplication), or the user manually set disable
@@ -129,7 +246,10 @@ namespace graphit {
                 }
             } else {
                 //There is a schedule, but nothing is specified for the current apply
-                node = std::make_shared<mir::PullEdgeSetApplyExpr>(edgeset_apply);
+                if (edgeset_apply->is_ordered)
+                    node = std::make_shared<mir::PushEdgeSetApplyExpr>(edgeset_apply);
+                else
+                    node = std::make_shared<mir::PullEdgeSetApplyExpr>(edgeset_apply);
                 return;
             }
 
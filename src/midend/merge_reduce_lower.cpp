@@ -5,6 +5,7 @@
 #include <graphit/midend/mir_context.h>
 #include <graphit/frontend/schedule.h>
 #include <graphit/midend/merge_reduce_lower.h>
+#include <algorithm>
 
 namespace graphit {
 
@@ -45,6 +46,13 @@ namespace graphit {
             int_type->type = mir::ScalarType::Type::INT;
             apply_func_decl->args.push_back(mir::Var("socketId", int_type));
             merge_reduce->numa_aware = true;
+
+            // the fields scheduled as replicated are only read from the copies if this apply does not write them
+            auto written_field_visitor = WrittenFieldVisitor();
+            apply_func_decl->accept(&written_field_visitor);
+            auto replicated_read_visitor = ReplicatedReadVisitor(mir_context_, schedule_,
+                                                                 written_field_visitor.written_fields, merge_reduce);
+            apply_func_decl->accept(&replicated_read_visitor);
         }
 
 
@@ -68,4 +76,46 @@ namespace graphit {
             }
         }
     }
+
+    void MergeReduceLower::WrittenFieldVisitor::visit(mir::AssignStmt::Ptr assign_stmt) {
+        addWrittenField(assign_stmt->lhs);
+        mir::MIRVisitor::visit(assign_stmt);
+    }
+
+    void MergeReduceLower::WrittenFieldVisitor::visit(mir::ReduceStmt::Ptr reduce_stmt) {
+        addWrittenField(reduce_stmt->lhs);
+        mir::MIRVisitor::visit(reduce_stmt);
+    }
+
+    void MergeReduceLower::WrittenFieldVisitor::visit(mir::CompareAndSwapStmt::Ptr cas_stmt) {
+        addWrittenField(cas_stmt->lhs);
+        mir::MIRVisitor::visit(cas_stmt);
+    }
+
+    void MergeReduceLower::WrittenFieldVisitor::addWrittenField(mir::Expr::Ptr lhs) {
+        if (mir::isa<mir::TensorReadExpr>(lhs)) {
+            auto tensor_read_expr = mir::to<mir::TensorReadExpr>(lhs);
+            if (mir::isa<mir::VarExpr>(tensor_read_expr->target))
+                written_fields.insert(mir::to<mir::VarExpr>(tensor_read_expr->target)->var.getName());
+        }
+    }
+
+    void MergeReduceLower::ReplicatedReadVisitor::visit(mir::TensorArrayReadExpr::Ptr tensor_read) {
+        mir::MIRVisitor::visit(tensor_read);
+        if (!mir::isa<mir::VarExpr>(tensor_read->target))
+            return;
+        auto target_expr = mir::to<mir::VarExpr>(tensor_read->target);
+        auto field_name = target_expr->var.getName();
+        auto numa_placement = schedule_->vector_numa_placements.find(field_name);
+        if (numa_placement == schedule_->vector_numa_placements.end()
+            || numa_placement->second != FieldVectorNumaPlacement::REPLICATED
+            || written_fields_.find(field_name) != written_fields_.end()
+            || !mir::isa<mir::ScalarType>(mir_context_->getVectorItemType(field_name)))
+            return;
+
+        if (std::find(merge_reduce_->replicated_fields.begin(), merge_reduce_->replicated_fields.end(), field_name)
+            == merge_reduce_->replicated_fields.end())
+            merge_reduce_->replicated_fields.push_back(field_name);
+        target_expr->var = mir::Var("local_" + field_name + "[socketId]", target_expr->var.getType());
+    }
 }
@@ -128,6 +128,7 @@ namespace graphit {
         void VertexSetApplyExpr::copy(MIRNode::Ptr node) {
             const auto expr = to<VertexSetApplyExpr>(node);
             ApplyExpr::copy(expr);
+            relabeled_edgeset = expr->relabeled_edgeset;
         }
 
 
@@ -145,6 +146,17 @@ namespace graphit {
             is_parallel = expr->is_parallel;
             enable_deduplication = expr->enable_deduplication;
             is_weighted = expr->is_weighted;
+            is_ordered = expr->is_ordered;
+            priority_update_delta = expr->priority_update_delta;
+            use_push_edge_based_load_balance = expr->use_push_edge_based_load_balance;
+            push_edge_based_load_balance_grain_size = expr->push_edge_based_load_balance_grain_size;
+            use_dense_push_edge_based_load_balance = expr->use_dense_push_edge_based_load_balance;
+            dense_push_edge_based_load_balance_grain_size = expr->dense_push_edge_based_load_balance_grain_size;
+            use_thread_local_frontier = expr->use_thread_local_frontier;
+            use_simd_pull = expr->use_simd_pull;
+            compressed_edge_code = expr->compressed_edge_code;
+            direction_threshold = expr->direction_threshold;
+            adaptive_direction = expr->adaptive_direction;
         }
 
 
@@ -547,6 +547,7 @@ namespace graphit {
                 edgeset_apply_expr->tracking_field = fir::to<fir::Identifier>(apply_expr->change_tracking_field)->ident;
             if (apply_expr->disable_deduplication) edgeset_apply_expr->enable_deduplication = false;
             else edgeset_apply_expr->enable_deduplication = true;
+            edgeset_apply_expr->is_ordered = apply_expr->is_ordered;
             retExpr = edgeset_apply_expr;
         }
 
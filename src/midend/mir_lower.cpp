@@ -11,6 +11,8 @@
 #include <graphit/midend/atomics_op_lower.h>
 #include <graphit/midend/vertex_edge_set_lower.h>
 #include <graphit/midend/merge_reduce_lower.h>
+#include <graphit/midend/vertex_relabel_lower.h>
+#include <graphit/midend/simd_pull_reduce_lower.h>
 
 namespace graphit {
     /**
@@ -35,6 +37,10 @@ namespace graphit {
 
         ApplyExprLower(mir_context, schedule).lower();
 
+        // If an edgeset is relabeled when it is loaded (vertex order in the schedule), this pass translates
+        // the vertex ids the program gets from the outside (argv, literals) to the relabeled ids
+        VertexRelabelLower(mir_context).lower();
+
         // Use program analysis to figure out the properties of each tensor access
         // read write type: read/write/read and write (reduction)
         // access type: shared or local
@@ -56,6 +62,10 @@ namespace graphit {
         // This pass extracts the merge field and reduce operator. If numa_aware is set to true in
         // the schedule for the corresponding label, it also adds NUMA optimization
         MergeReduceLower(mir_context, schedule).lower();
+
+        // This pass checks the applies scheduled with the SIMD pull kernel and extracts the reduction
+        // of their apply functions (target[dst] += value read at src), which the backend vectorizes
+        SimdPullReduceLower(mir_context).lower();
     }
 }
 
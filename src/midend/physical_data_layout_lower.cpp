@@ -57,6 +57,16 @@ namespace graphit {
                     }
                 }
 
+                if (schedule_ != nullptr) {
+                    auto numa_placement = schedule_->vector_numa_placements.find(var_name);
+                    if (numa_placement != schedule_->vector_numa_placements.end()) {
+                        if (numa_placement->second == FieldVectorNumaPlacement::INTERLEAVED)
+                            mir_context_->vector_to_numa_placement[var_name] = "builtin_numaInterleave";
+                        else if (numa_placement->second == FieldVectorNumaPlacement::PARTITIONED)
+                            mir_context_->vector_to_numa_placement[var_name] = "builtin_numaPartition";
+                    }
+                }
+
                 //By default, we generate dense array implementations
                 genArrayDecl(var_decl);
 
@@ -0,0 +1,164 @@
+#include <graphit/midend/simd_pull_reduce_lower.h>
+
+namespace graphit {
+
+    void SimdPullReduceLower::lower() {
+        auto apply_expr_visitor = ApplyExprVisitor(mir_context_);
+        for (auto function : mir_context_->getFunctionList()) {
+            function->accept(&apply_expr_visitor);
+        }
+    }
+
+    void SimdPullReduceLower::ApplyExprVisitor::visit(mir::PullEdgeSetApplyExpr::Ptr apply_expr) {
+        if (!apply_expr->use_simd_pull)
+            return;
+        auto edgeset_name = mir::to<mir::VarExpr>(apply_expr->target)->var.getName();
+        auto segments = mir_context_->edgeset_to_label_to_num_segment[edgeset_name];
+        bool segmented = segments.find(apply_expr->scope_label_name) != segments.end();
+        bool numa_aware = apply_expr->merge_reduce != nullptr && apply_expr->merge_reduce->numa_aware;
+        // the kernel reduces the whole csr neighbor list of a destination at once
+        if (apply_expr->is_weighted || apply_expr->from_func != "" || apply_expr->to_func != ""
+            || apply_expr->compressed_edge_code != "" || segmented || numa_aware) {
+            std::cout << "the simd pull kernel needs an unweighted csr DensePull apply over all vertices, "
+                         "without segments or NUMA: " << apply_expr->input_function_name << std::endl;
+            throw "Unsupported Schedule!";
+        }
+
+        auto apply_func = mir_context_->getFunction(apply_expr->input_function_name);
+        auto reduce = analyzeApplyFunction(apply_func);
+        if (reduce == nullptr) {
+            std::cout << "the simd pull kernel needs an apply function that only does dst_field[dst] += "
+                         "(or min=) arithmetic on vectors read at src: " << apply_func->name << std::endl;
+            throw "Unsupported Schedule!";
+        }
+        mir_context_->function_to_simd_pull_reduce[apply_func->name] = reduce;
+    }
+
+    void SimdPullReduceLower::ApplyExprVisitor::visit(mir::PushEdgeSetApplyExpr::Ptr apply_expr) {
+        rejectSimdPull(apply_expr);
+    }
+
+    void SimdPullReduceLower::ApplyExprVisitor::visit(mir::HybridDenseEdgeSetApplyExpr::Ptr apply_expr) {
+        rejectSimdPull(apply_expr);
+    }
+
+    void SimdPullReduceLower::ApplyExprVisitor::visit(mir::HybridDenseForwardEdgeSetApplyExpr::Ptr apply_expr) {
+        rejectSimdPull(apply_expr);
+    }
+
+    void SimdPullReduceLower::ApplyExprVisitor::rejectSimdPull(mir::EdgeSetApplyExpr::Ptr apply_expr) {
+        if (apply_expr->use_simd_pull) {
+            std::cout << "the simd pull kernel only applies to DensePull: " << apply_expr->input_function_name
+                      << std::endl;
+            throw "Unsupported Schedule!";
+        }
+    }
+
+    mir::SimdPullReduce::Ptr SimdPullReduceLower::ApplyExprVisitor::analyzeApplyFunction(
+            mir::FuncDecl::Ptr apply_func) {
+        if (apply_func->result.isInitialized() || apply_func->args.size() != 2 || apply_func->body == nullptr
+            || apply_func->body->stmts == nullptr || apply_func->body->stmts->size() != 1)
+            return nullptr;
+        auto reduce_stmt = std::dynamic_pointer_cast<mir::ReduceStmt>((*apply_func->body->stmts)[0]);
+        if (reduce_stmt == nullptr || reduce_stmt->tracking_var_name_ != "")
+            return nullptr;
+
+        auto reduce = std::make_shared<mir::SimdPullReduce>();
+        switch (reduce_stmt->reduce_op_) {
+            case mir::ReduceStmt::ReductionOp::SUM:
+            case mir::ReduceStmt::ReductionOp::ATOMIC_SUM:
+                reduce->reduce_op = mir::ReduceStmt::ReductionOp::SUM;
+                break;
+            case mir::ReduceStmt::ReductionOp::MIN:
+            case mir::ReduceStmt::ReductionOp::ATOMIC_MIN:
+                reduce->reduce_op = mir::ReduceStmt::ReductionOp::MIN;
+                break;
+            default:
+                return nullptr;
+        }
+
+        reduce->src_name = apply_func->args[0].getName();
+        std::string dst_name = apply_func->args[1].getName();
+        if (readVector(reduce_stmt->lhs, dst_name, reduce->scalar_type) == "")
+            return nullptr;
+        reduce->target = mir::to<mir::TensorReadExpr>(reduce_stmt->lhs);
+        if (valueType(reduce_stmt->expr, reduce, dst_name) == nullptr)
+            return nullptr;
+        reduce->value = reduce_stmt->expr;
+        return reduce;
+    }
+
+    mir::ScalarType::Ptr SimdPullReduceLower::ApplyExprVisitor::valueType(mir::Expr::Ptr expr,
+                                                                          mir::SimdPullReduce::Ptr reduce,
+                                                                          std::string dst_name) {
+        auto reduced_type = reduce->scalar_type->type;
+        auto leaf_type = std::make_shared<mir::ScalarType>();
+        if (mir::isa<mir::IntLiteral>(expr)) {
+            leaf_type->type = mir::ScalarType::Type::INT;
+            return leaf_type;
+        }
+        if (mir::isa<mir::FloatLiteral>(expr)) {
+            leaf_type->type = mir::ScalarType::Type::FLOAT;
+            return reduced_type == mir::ScalarType::Type::INT ? nullptr : leaf_type;
+        }
+
+        // vectors and scalars are converted to the reduced type, only int converts exactly
+        mir::ScalarType::Ptr read_type;
+        auto var_expr = std::dynamic_pointer_cast<mir::VarExpr>(expr);
+        if (var_expr != nullptr) {
+            if (var_expr->var.getName() == reduce->src_name || var_expr->var.getName() == dst_name)
+                return nullptr;
+            read_type = std::dynamic_pointer_cast<mir::ScalarType>(var_expr->var.getType());
+        } else if (mir::isa<mir::TensorReadExpr>(expr)) {
+            // the reduced vector changes while the in-neighbors are reduced
+            mir::ScalarType::Ptr target_type;
+            std::string vector = readVector(expr, reduce->src_name, read_type);
+            if (vector == "" || vector == readVector(reduce->target, dst_name, target_type))
+                return nullptr;
+        }
+        if (read_type != nullptr) {
+            if (read_type->type != mir::ScalarType::Type::INT && read_type->type != reduced_type)
+                return nullptr;
+            return read_type;
+        }
+
+        auto binary_expr = std::dynamic_pointer_cast<mir::BinaryExpr>(expr);
+        if (binary_expr == nullptr || !(mir::isa<mir::AddExpr>(expr) || mir::isa<mir::SubExpr>(expr)
+                                        || mir::isa<mir::MulExpr>(expr) || mir::isa<mir::DivExpr>(expr)))
+            return nullptr;
+        auto lhs_type = valueType(binary_expr->lhs, reduce, dst_name);
+        auto rhs_type = valueType(binary_expr->rhs, reduce, dst_name);
+        if (lhs_type == nullptr || rhs_type == nullptr)
+            return nullptr;
+        // the wider of the two operands, ints stay ints
+        if (lhs_type->type == mir::ScalarType::Type::INT && rhs_type->type == mir::ScalarType::Type::INT) {
+            return mir::isa<mir::DivExpr>(expr) ? nullptr : lhs_type;
+        }
+        return lhs_type->type == mir::ScalarType::Type::DOUBLE || rhs_type->type == mir::ScalarType::Type::INT
+               ? lhs_type : rhs_type;
+    }
+
+    std::string SimdPullReduceLower::ApplyExprVisitor::readVector(mir::Expr::Ptr expr, std::string index_name,
+                                                                   mir::ScalarType::Ptr &scalar_type) {
+        auto tensor_read = std::dynamic_pointer_cast<mir::TensorReadExpr>(expr);
+        if (tensor_read == nullptr)
+            return "";
+        auto index = std::dynamic_pointer_cast<mir::VarExpr>(tensor_read->index);
+        if (index == nullptr || index->var.getName() != index_name)
+            return "";
+        auto struct_read = std::dynamic_pointer_cast<mir::TensorStructReadExpr>(expr);
+        auto vector = std::dynamic_pointer_cast<mir::VarExpr>(struct_read != nullptr ? struct_read->field_target
+                                                                                     : tensor_read->target);
+        if (vector == nullptr)
+            return "";
+        auto vector_type = std::dynamic_pointer_cast<mir::VectorType>(vector->var.getType());
+        if (vector_type == nullptr)
+            return "";
+        scalar_type = std::dynamic_pointer_cast<mir::ScalarType>(vector_type->vector_element_type);
+        if (scalar_type == nullptr || (scalar_type->type != mir::ScalarType::Type::INT
+                                       && scalar_type->type != mir::ScalarType::Type::FLOAT
+                                       && scalar_type->type != mir::ScalarType::Type::DOUBLE))
+            return "";
+        return vector->var.getName();
+    }
+}
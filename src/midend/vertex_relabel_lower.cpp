@@ -0,0 +1,113 @@
+#include <graphit/midend/vertex_relabel_lower.h>
+
+namespace graphit {
+
+    void VertexRelabelLower::lower() {
+        for (auto relabeled : mir_context_->edgeset_to_vertex_order) {
+            auto edgeset_decl = mir_context_->getConstEdgeSetByName(relabeled.first);
+            // the permutation is computed right after loading, edgesets passed to exported functions are not relabeled
+            if (edgeset_decl == nullptr || !mir::isa<mir::EdgeSetLoadExpr>(edgeset_decl->initVal)) {
+                std::cout << "vertex orders are only supported for edgesets loaded from a file: "
+                          << relabeled.first << std::endl;
+                throw "Unsupported Schedule!";
+            }
+            auto element_types = mir::to<mir::EdgeSetType>(edgeset_decl->type)->vertex_element_type_list;
+            auto element = (*element_types)[0]->ident;
+            if ((*element_types)[1]->ident != element) {
+                std::cout << "vertex orders require the same element on both ends of the edges: "
+                          << relabeled.first << std::endl;
+                throw "Unsupported Schedule!";
+            }
+            // vectors and vertexsets of the element are indexed with a single set of ids
+            for (auto other_decl : mir_context_->getEdgeSets()) {
+                if (other_decl->name == relabeled.first || !mir::isa<mir::EdgeSetLoadExpr>(other_decl->initVal))
+                    continue;
+                auto other_types = mir::to<mir::EdgeSetType>(other_decl->type)->vertex_element_type_list;
+                if ((*other_types)[0]->ident == element || (*other_types)[1]->ident == element) {
+                    std::cout << "edgeset " << other_decl->name << " shares the vertices of the relabeled edgeset "
+                              << relabeled.first << std::endl;
+                    throw "Unsupported Schedule!";
+                }
+            }
+
+            auto translator = VertexIdTranslator(mir_context_, element, relabeled.first);
+            for (auto function : mir_context_->getFunctionList()) {
+                // apply functions work on relabeled vertices already
+                bool takes_elements = false;
+                for (auto arg : function->args) {
+                    if (mir::isa<mir::ElementType>(arg.getType()))
+                        takes_elements = true;
+                }
+                if (!takes_elements)
+                    function->accept(&translator);
+            }
+        }
+    }
+
+    void VertexRelabelLower::VertexIdTranslator::visit(mir::TensorReadExpr::Ptr tensor_read) {
+        mir::MIRVisitor::visit(tensor_read);
+        auto target = std::dynamic_pointer_cast<mir::VarExpr>(tensor_read->target);
+        if (target == nullptr)
+            return;
+        auto vector_type = std::dynamic_pointer_cast<mir::VectorType>(target->var.getType());
+        if (vector_type != nullptr && isElement(vector_type->element_type))
+            tensor_read->index = translate(tensor_read->index);
+    }
+
+    void VertexRelabelLower::VertexIdTranslator::visit(mir::Call::Ptr call) {
+        mir::MIRVisitor::visit(call);
+        if (call->name != "builtin_addVertex" || call->args.size() != 2)
+            return;
+        auto vertexset = std::dynamic_pointer_cast<mir::VarExpr>(call->args[0]);
+        if (vertexset == nullptr)
+            return;
+        auto vertexset_type = std::dynamic_pointer_cast<mir::VertexSetType>(vertexset->var.getType());
+        if (vertexset_type != nullptr && isElement(vertexset_type->element))
+            call->args[1] = translate(call->args[1]);
+    }
+
+    void VertexRelabelLower::VertexIdTranslator::visit(mir::VarDecl::Ptr var_decl) {
+        mir::MIRVisitor::visit(var_decl);
+        if (var_decl->initVal != nullptr && isElement(var_decl->type))
+            var_decl->initVal = translate(var_decl->initVal);
+    }
+
+    void VertexRelabelLower::VertexIdTranslator::visit(mir::AssignStmt::Ptr assign_stmt) {
+        mir::MIRVisitor::visit(assign_stmt);
+        auto lhs = std::dynamic_pointer_cast<mir::VarExpr>(assign_stmt->lhs);
+        if (lhs != nullptr && isElement(lhs->var.getType()))
+            assign_stmt->expr = translate(assign_stmt->expr);
+    }
+
+    void VertexRelabelLower::VertexIdTranslator::visit(mir::VertexSetApplyExpr::Ptr apply_expr) {
+        mir::MIRVisitor::visit(apply_expr);
+        // parallel applies have no order to preserve
+        auto target = std::dynamic_pointer_cast<mir::VarExpr>(apply_expr->target);
+        if (apply_expr->is_parallel || target == nullptr || !mir_context_->isConstVertexSet(target->var.getName()))
+            return;
+        if (isElement(mir_context_->getElementTypeFromVectorOrSetName(target->var.getName())))
+            apply_expr->relabeled_edgeset = edgeset_;
+    }
+
+    bool VertexRelabelLower::VertexIdTranslator::isElement(mir::Type::Ptr type) {
+        auto element_type = std::dynamic_pointer_cast<mir::ElementType>(type);
+        return element_type != nullptr && element_type->ident == element_;
+    }
+
+    mir::Expr::Ptr VertexRelabelLower::VertexIdTranslator::translate(mir::Expr::Ptr vertex) {
+        // vertex variables hold relabeled ids
+        auto var_expr = std::dynamic_pointer_cast<mir::VarExpr>(vertex);
+        if (var_expr != nullptr && isElement(var_expr->var.getType()))
+            return vertex;
+        auto call = std::dynamic_pointer_cast<mir::Call>(vertex);
+        if (call != nullptr && call->name == "builtin_relabeledVertex")
+            return vertex;
+        auto edgeset_expr = std::make_shared<mir::VarExpr>();
+        edgeset_expr->var = mir::Var(edgeset_, mir_context_->getConstEdgeSetByName(edgeset_)->type);
+        auto relabeled = std::make_shared<mir::Call>();
+        relabeled->name = "builtin_relabeledVertex";
+        relabeled->args.push_back(edgeset_expr);
+        relabeled->args.push_back(vertex);
+        return relabeled;
+    }
+}
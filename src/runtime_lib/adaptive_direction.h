@@ -0,0 +1,75 @@
+#ifndef GRAPHIT_ADAPTIVE_DIRECTION_H
+#define GRAPHIT_ADAPTIVE_DIRECTION_H
+
+#include <chrono>
+#include <cstdint>
+
+
+/*
+GraphIt runtime
+Class:  AdaptiveDirection
+
+Direction choice of a hybrid edgeset apply scheduled with
+configApplyDirectionThreshold(label, "adaptive")
+ - Every round is timed and turned into a cost per unit of work of the
+   direction it ran in: the frontier vertices and their out edges for the
+   sparse push, the work the dense direction was given for the dense one
+   (all vertices and edges for pull, all vertices and the frontier edges for
+   dense forward)
+ - Once both directions have been measured, the next round runs in the
+   direction with the lower predicted time; until then the fixed threshold
+   decides (dense once the frontier work exceeds numEdges / threshold)
+ - Costs are averaged over the rounds (new rounds weigh half), so a single
+   noisy round does not pin the choice
+*/
+
+
+class AdaptiveDirection {
+ public:
+  explicit AdaptiveDirection(int threshold) : threshold_(threshold), sparse_cost_(-1), dense_cost_(-1) {}
+
+  bool chooseDense(int64_t sparse_work, int64_t dense_work, int64_t num_edges) const {
+    if (sparse_cost_ < 0 || dense_cost_ < 0)
+      return sparse_work > num_edges / threshold_;
+    return dense_cost_ * dense_work < sparse_cost_ * sparse_work;
+  }
+
+  void record(bool dense, int64_t work, double seconds) {
+    double cost = seconds / (work > 0 ? work : 1);
+    double &average = dense ? dense_cost_ : sparse_cost_;
+    average = average < 0 ? cost : (average + cost) / 2;
+  }
+
+  // picks the direction of a round when it is created, records its time when it goes out of scope
+  class Round {
+   public:
+    Round(AdaptiveDirection &direction, int64_t sparse_work, int64_t dense_work, int64_t num_edges)
+        : direction_(direction), start_(std::chrono::steady_clock::now()) {
+      dense_ = direction.chooseDense(sparse_work, dense_work, num_edges);
+      work_ = dense_ ? dense_work : sparse_work;
+    }
+
+    ~Round() {
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+      direction_.record(dense_, work_, elapsed.count());
+    }
+
+    bool dense() const {
+      return dense_;
+    }
+
+   private:
+    AdaptiveDirection &direction_;
+    std::chrono::steady_clock::time_point start_;
+    bool dense_;
+    int64_t work_;
+  };
+
+ private:
+  int threshold_;
+  // seconds per unit of work, -1 until the direction has run
+  double sparse_cost_;
+  double dense_cost_;
+};
+
+#endif //GRAPHIT_ADAPTIVE_DIRECTION_H
@@ -0,0 +1,172 @@
+#ifndef GRAPHIT_APPLY_COUNTERS_H
+#define GRAPHIT_APPLY_COUNTERS_H
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "vertexsubset.h"
+
+
+/*
+GraphIt runtime
+Class:  ApplyCounters
+
+Performance counters of the labeled edgeset applies of a program compiled
+with graphitc -c
+ - The generated code brackets every labeled apply with begin/end, which
+   records one round: wall time, size of the input frontier, number of out
+   edges of the input frontier, size of the output frontier and direction
+ - Hybrid schedules record the direction they pick at run time
+ - The report is written when the program exits, to the file named by
+   GRAPHIT_APPLY_COUNTERS (CSV if the name ends in .csv, JSON otherwise)
+   or as JSON to stderr, so stdout stays untouched for verifiers
+*/
+
+
+class ApplyCounters {
+ public:
+  struct Round {
+    double seconds;
+    int64_t frontier_in;
+    // -1 when the apply does not return a frontier
+    int64_t frontier_out;
+    int64_t frontier_edges;
+    std::string direction;
+  };
+
+  static ApplyCounters& get() {
+    static ApplyCounters counters;
+    return counters;
+  }
+
+  // from is null when the apply runs over all vertices
+  template <typename GraphT>
+  void begin(const std::string &label, GraphT &g, VertexSubset<NodeID> *from,
+             const std::string &direction) {
+    Round round;
+    round.frontier_out = -1;
+    round.direction = direction;
+    if (from == nullptr) {
+      round.frontier_in = g.num_nodes();
+      round.frontier_edges = g.num_edges_directed();
+    } else {
+      round.frontier_in = from->size();
+      round.frontier_edges = countOutEdges(g, from);
+    }
+    current_label_ = label;
+    current_ = round;
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  // direction picked by a hybrid apply for the current round
+  void recordDirection(const std::string &direction) {
+    current_.direction = direction;
+  }
+
+  void end(VertexSubset<NodeID> *to) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+    current_.seconds = elapsed.count();
+    if (to != nullptr)
+      current_.frontier_out = to->size();
+    if (rounds_.find(current_label_) == rounds_.end())
+      labels_.push_back(current_label_);
+    rounds_[current_label_].push_back(current_);
+  }
+
+  void writeJSON(std::ostream &out) const {
+    out << "{\"applies\": [";
+    for (size_t l = 0; l < labels_.size(); l++) {
+      const std::vector<Round> &rounds = rounds_.at(labels_[l]);
+      double total = 0;
+      std::map<std::string, int64_t> directions;
+      for (const Round &r : rounds) {
+        total += r.seconds;
+        directions[r.direction]++;
+      }
+      out << (l == 0 ? "" : ",") << "\n  {\"label\": \"" << labels_[l] << "\", "
+          << "\"rounds\": " << rounds.size() << ", \"seconds\": " << total << ", \"directions\": {";
+      bool first = true;
+      for (auto &direction : directions) {
+        out << (first ? "" : ", ") << "\"" << direction.first << "\": " << direction.second;
+        first = false;
+      }
+      out << "},\n   \"per_round\": [";
+      for (size_t i = 0; i < rounds.size(); i++) {
+        const Round &r = rounds[i];
+        out << (i == 0 ? "" : ", ") << "{\"seconds\": " << r.seconds
+            << ", \"frontier_in\": " << r.frontier_in
+            << ", \"frontier_out\": " << r.frontier_out
+            << ", \"frontier_edges\": " << r.frontier_edges
+            << ", \"direction\": \"" << r.direction << "\"}";
+      }
+      out << "]}";
+    }
+    out << "\n]}" << std::endl;
+  }
+
+  void writeCSV(std::ostream &out) const {
+    out << "label,round,seconds,frontier_in,frontier_out,frontier_edges,direction" << std::endl;
+    for (const std::string &label : labels_) {
+      const std::vector<Round> &rounds = rounds_.at(label);
+      for (size_t i = 0; i < rounds.size(); i++) {
+        const Round &r = rounds[i];
+        out << label << "," << i << "," << r.seconds << "," << r.frontier_in << ","
+            << r.frontier_out << "," << r.frontier_edges << "," << r.direction << std::endl;
+      }
+    }
+  }
+
+  ~ApplyCounters() {
+    if (labels_.empty())
+      return;
+    const char *file_name = std::getenv("GRAPHIT_APPLY_COUNTERS");
+    if (file_name == nullptr) {
+      writeJSON(std::cerr);
+      return;
+    }
+    std::string name(file_name);
+    std::ofstream out(name);
+    if (!out) {
+      std::cerr << "could not write apply counters to " << name << std::endl;
+      return;
+    }
+    if (name.size() >= 4 && name.compare(name.size() - 4, 4, ".csv") == 0)
+      writeCSV(out);
+    else
+      writeJSON(out);
+  }
+
+ private:
+  std::vector<std::string> labels_;
+  std::map<std::string, std::vector<Round>> rounds_;
+  std::string current_label_;
+  Round current_;
+  std::chrono::steady_clock::time_point start_;
+
+  ApplyCounters() {}
+
+  template <typename GraphT>
+  static int64_t countOutEdges(GraphT &g, VertexSubset<NodeID> *from) {
+    int64_t edges = 0;
+    if (from->dense_vertex_set_ != nullptr) {
+      int64_t m = from->size();
+      #pragma omp parallel for reduction(+ : edges)
+      for (int64_t i = 0; i < m; i++)
+        edges += g.out_degree(from->dense_vertex_set_[i]);
+    } else if (from->size() > 0) {
+      int64_t n = g.num_nodes();
+      #pragma omp parallel for reduction(+ : edges)
+      for (int64_t v = 0; v < n; v++) {
+        if (from->contains(v))
+          edges += g.out_degree(v);
+      }
+    }
+    return edges;
+  }
+};
+
+#endif //GRAPHIT_APPLY_COUNTERS_H
@@ -0,0 +1,75 @@
+#ifndef GRAPHIT_FRONTIER_BUFFER_H
+#define GRAPHIT_FRONTIER_BUFFER_H
+
+#include <algorithm>
+#include <vector>
+#include "infra_ligra/ligra/parallel.h"
+#include "frontier_pool.h"
+#include "work_stealing.h"
+
+
+/*
+GraphIt runtime
+Class:  FrontierBuffer
+
+Output of the sparse push applies scheduled with
+configApplyFrontierOutput(label, "thread-local-buffers")
+ - Every thread appends the vertices it adds to the next frontier to its own
+   buffer, instead of writing one slot per frontier edge and filtering the
+   empty slots out afterwards
+ - merge() scans the buffer sizes and copies the buffers into one sparse
+   vertex array from the FrontierPool, in parallel
+ - Buffers are padded to a cache line so threads never share one
+ - Like QueueBuffer in sliding_queue.h, but the buffers are only merged
+   once, at the end of the round
+ - The workers of the work-stealing scheduler (graphitc -w) use the buffer of
+   their worker number, the forking thread the one of its OpenMP thread
+*/
+
+
+template <typename T>
+class FrontierBuffer {
+ public:
+  FrontierBuffer() : buffers_(std::max(getWorkers(), WorkStealingScheduler::maxWorkers())) {}
+
+  // the buffer of the calling thread
+  std::vector<T> &local() {
+    return buffers_[workerId()].items;
+  }
+
+  // moves the buffered vertices into a sparse vertex array, sets size to their number
+  T *merge(long *size) {
+    long num_buffers = buffers_.size();
+    std::vector<long> offsets(num_buffers + 1, 0);
+    for (long i = 0; i < num_buffers; i++)
+      offsets[i + 1] = offsets[i] + buffers_[i].items.size();
+    *size = offsets[num_buffers];
+    T *merged = FrontierPool::allocate<T>(std::max(*size, 1L));
+    parallel_for (long i = 0; i < num_buffers; i++) {
+      std::copy(buffers_[i].items.begin(), buffers_[i].items.end(), merged + offsets[i]);
+      buffers_[i].items.clear();
+    }
+    return merged;
+  }
+
+ private:
+  struct Buffer {
+    std::vector<T> items;
+    char padding[64];
+  };
+
+  static int workerId() {
+#if defined(CILK) || defined(CILKP)
+    return __cilkrts_get_worker_number();
+#elif defined(OPENMP)
+    int worker = WorkStealingScheduler::workerNumber();
+    return worker >= 0 ? worker : omp_get_thread_num();
+#else
+    return 0;
+#endif
+  }
+
+  std::vector<Buffer> buffers_;
+};
+
+#endif //GRAPHIT_FRONTIER_BUFFER_H
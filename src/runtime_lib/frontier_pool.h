@@ -0,0 +1,123 @@
+#ifndef GRAPHIT_FRONTIER_POOL_H
+#define GRAPHIT_FRONTIER_POOL_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "infra_gapbs/huge_pages.h"
+
+
+/*
+GraphIt runtime
+Class:  FrontierPool
+
+Recycles the O(V) and O(E) buffers of frontiers (bool maps, sparse vertex
+arrays, degree and offset scratch arrays) across iterations
+ - Buffers are grouped in size classes, a released buffer is handed out
+   again to the next request of the same class, so rounds after the first
+   one neither call malloc nor take page faults on fresh memory
+ - Classes are powers of two up to 1MB, above that every power of two is
+   split in kStepsPerDoubling classes, so the O(E) buffers waste at most
+   1/kStepsPerDoubling of their size instead of up to one half
+ - Only buffers handed out by the pool are accepted back: release returns
+   false for any other pointer and the caller frees it as before
+ - At most kMaxCachedPerClass buffers are kept per class, the rest is freed
+ - Buffers come from the HugePageAllocator, the large ones sit on huge pages
+ - Allocation and release happen once per traversal, outside of the
+   parallel loops, a single lock is enough
+*/
+
+
+class FrontierPool {
+ public:
+  // smallest class is 4KB, smaller requests are rounded up
+  static const int kMinClassLog = 12;
+  // classes above 2^kFineClassLog bytes are spaced 2^k / kStepsPerDoubling apart
+  static const int kFineClassLog = 20;
+  static const int kStepsPerDoubling = 8;
+  static const int kNumClasses = (kFineClassLog - kMinClassLog + 1)
+                                 + (64 - kFineClassLog) * kStepsPerDoubling;
+  static const size_t kMaxCachedPerClass = 4;
+
+  // uninitialized buffer for n elements of T
+  template <typename T>
+  static T* allocate(size_t n) {
+    return static_cast<T*>(get().allocateBytes(n * sizeof(T)));
+  }
+
+  // returns a buffer to the pool, false if the buffer was not allocated by the pool
+  template <typename T>
+  static bool release(T *buffer) {
+    return get().releaseBytes(static_cast<void*>(buffer));
+  }
+
+  ~FrontierPool() {
+    for (auto &buffers : free_buffers_) {
+      for (void *buffer : buffers)
+        HugePageAllocator::Free(buffer);
+    }
+  }
+
+ private:
+  std::mutex lock_;
+  // size class of every buffer handed out by the pool, whether in use or cached
+  std::unordered_map<void*, int> owned_;
+  std::vector<void*> free_buffers_[kNumClasses];
+
+  FrontierPool() {}
+
+  static FrontierPool& get() {
+    static FrontierPool pool;
+    return pool;
+  }
+
+  // capacity in bytes of the buffers of a size class
+  static size_t classBytes(int size_class) {
+    int num_coarse = kFineClassLog - kMinClassLog + 1;
+    if (size_class < num_coarse)
+      return (size_t) 1 << (size_class + kMinClassLog);
+    int fine = size_class - num_coarse;
+    int log = kFineClassLog + fine / kStepsPerDoubling;
+    size_t step = ((size_t) 1 << log) / kStepsPerDoubling;
+    return ((size_t) 1 << log) + (fine % kStepsPerDoubling + 1) * step;
+  }
+
+  static int sizeClass(size_t bytes) {
+    int size_class = 0;
+    while (classBytes(size_class) < bytes)
+      size_class++;
+    return size_class;
+  }
+
+  void* allocateBytes(size_t bytes) {
+    int size_class = sizeClass(bytes);
+    std::lock_guard<std::mutex> guard(lock_);
+    if (!free_buffers_[size_class].empty()) {
+      void *buffer = free_buffers_[size_class].back();
+      free_buffers_[size_class].pop_back();
+      return buffer;
+    }
+    void *buffer = HugePageAllocator::Allocate<char>(classBytes(size_class));
+    owned_[buffer] = size_class;
+    return buffer;
+  }
+
+  bool releaseBytes(void *buffer) {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto it = owned_.find(buffer);
+    if (it == owned_.end())
+      return false;
+    int size_class = it->second;
+    if (free_buffers_[size_class].size() < kMaxCachedPerClass) {
+      free_buffers_[size_class].push_back(buffer);
+    } else {
+      owned_.erase(it);
+      HugePageAllocator::Free(buffer);
+    }
+    return true;
+  }
+};
+
+#endif //GRAPHIT_FRONTIER_POOL_H
@@ -17,12 +17,14 @@ Author: Scott Beamer
 
 Parallel bitmap that is thread-safe
  - Can set bits in parallel (set_bit_atomic) unlike std::vector<bool>
+ - Exposes its 64-bit words so callers can scan it a word at a time
 */
 
 
 class Bitmap {
  public:
   explicit Bitmap(size_t size) {
+    num_bits_ = size;
     num_words_ = (size + kBitsPerWord - 1) / kBitsPerWord;
     start_ = new uint64_t[num_words_];
     end_ = start_ + num_words_;
@@ -58,9 +60,31 @@ class Bitmap {
 //      }
 //    }
 
+  uint64_t get_word(size_t word) const {
+    return start_[word];
+  }
+
+  // the caller owns the word, no other thread may write to it concurrently
+  void set_word(size_t word, uint64_t value) {
+    start_[word] = value;
+  }
+
+  size_t num_words() const { return num_words_; }
+
+  // number of set bits
+  int64_t count() const {
+    int64_t total = 0;
+    #pragma omp parallel for reduction(+ : total)
+    for (int64_t i = 0; i < (int64_t) num_words_; i++)
+      total += __builtin_popcountll(start_[i]);
+    return total;
+  }
+
   void swap(Bitmap &other) {
     std::swap(start_, other.start_);
     std::swap(end_, other.end_);
+    std::swap(num_words_, other.num_words_);
+    std::swap(num_bits_, other.num_bits_);
   }
 
     // a quick API to set all the elements to 1 in bitmap
@@ -70,6 +94,9 @@ class Bitmap {
       for (int i = 0; i< num_words_; i++){
         start_[i] = ~(start_[i]);
       }
+      // keep the bits past the end clear so that count() stays exact
+      if (bit_offset(num_bits_) != 0)
+        start_[num_words_ - 1] = ((uint64_t) 1l << bit_offset(num_bits_)) - 1;
     }
 
 
@@ -77,6 +104,7 @@ private:
   uint64_t *start_;
   uint64_t *end_;
   uint64_t num_words_;
+  uint64_t num_bits_;
   static const uint64_t kBitsPerWord = 64;
   static uint64_t word_offset(size_t n) { return n / kBitsPerWord; }
   static uint64_t bit_offset(size_t n) { return n & (kBitsPerWord - 1); }
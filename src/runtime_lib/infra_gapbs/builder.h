@@ -17,8 +17,10 @@
 #include "platform_atomics.h"
 #include "pvector.h"
 #include "reader.h"
+#include "reorder.h"
 #include "timer.h"
 #include "util.h"
+#include "../infra_ligra/ligra/blockRadixSort.h"
 
 
 /*
@@ -28,7 +30,9 @@ Author: Scott Beamer
 
 Given arguements from the command line (cli), returns a built graph
  - MakeGraph() will parse cli and obtain edgelist and call
-   MakeGraphFromEL(edgelist) to perform actual graph construction
+   MakeSortedGraphFromEL(edgelist) to perform actual graph construction
+ - MakeGraphFromEL(edgelist) keeps neighbors in arrival order and does not
+   remove self-loops or redundant edges (SquishGraph does)
  - edgelist can be from file (reader) or synthetically generated (generator)
  - Common case: BuilderBase typedef'd (w/ params) to be Builder (benchmark.h)
 */
@@ -59,6 +63,14 @@ class BuilderBase {
     return NodeWeight<NodeID_, WeightT_>(e.u, e.v.w);
   }
 
+  static NodeID_ GetTarget(NodeID_ d) {
+    return d;
+  }
+
+  static NodeID_ GetTarget(NodeWeight<NodeID_, WeightT_> d) {
+    return d.v;
+  }
+
   NodeID_ FindMaxNodeID(const EdgeList &el) {
     NodeID_ max_seen = 0;
     #pragma omp parallel for reduction(max : max_seen)
@@ -150,7 +162,7 @@ class BuilderBase {
       diffs[n] = new_end - n_start;
     }
     pvector<SGOffset> sq_offsets = ParallelPrefixSum(diffs);
-    *sq_neighs = new DestID_[sq_offsets[g.num_nodes()]];
+    *sq_neighs = HugePageAllocator::Allocate<DestID_>(sq_offsets[g.num_nodes()]);
     *sq_index = CSRGraph<NodeID_, DestID_>::GenIndex(sq_offsets, *sq_neighs);
     #pragma omp parallel for private(n_start)
     for (NodeID_ n=0; n < g.num_nodes(); n++) {
@@ -189,7 +201,7 @@ class BuilderBase {
                DestID_** neighs) {
     pvector<NodeID_> degrees = CountDegrees(el, transpose);
     pvector<SGOffset> offsets = ParallelPrefixSum(degrees);
-    *neighs = new DestID_[offsets[num_nodes_]];
+    *neighs = HugePageAllocator::Allocate<DestID_>(offsets[num_nodes_]);
     *index = CSRGraph<NodeID_, DestID_>::GenIndex(offsets, *neighs);
     #pragma omp parallel for
     for (auto it = el.begin(); it < el.end(); it++) {
@@ -223,62 +235,118 @@ class BuilderBase {
                                                 inv_index, inv_neighs);
   }
 
+  /*
+  Sorted Graph Building Steps (for CSR):
+    - Copy the edges of this direction into an array of (vertex, neighbor)
+    - Radix sort the array by neighbor and then (stably) by vertex, the
+      bucket offsets of the second sort are the vertex offsets
+    - Count the neighbors of every vertex that are not itself and differ
+      from the previous neighbor (ParallelPrefixSum)
+    - Copy every distinct neighbor into storage, of redundant weighted
+      edges the lowest weight is kept (as SquishCSR does)
+  Neighbor IDs come out sorted without building an unsquished graph
+  */
+  void MakeSortedCSR(const EdgeList &el, bool transpose, DestID_*** index,
+                     DestID_** neighs) {
+    bool forward = symmetrize_ || !transpose;
+    bool backward = symmetrize_ || transpose;
+    int64_t copies = (forward && backward) ? 2 : 1;
+    int64_t num_edges = el.size() * copies;
+    EdgeList edges(num_edges);
+    #pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(el.size()); i++) {
+      Edge e = el[i];
+      int64_t pos = i * copies;
+      if (forward)
+        edges[pos++] = e;
+      if (backward)
+        edges[pos] = Edge(static_cast<NodeID_>(e.v), GetSource(e));
+    }
+    pvector<SGOffset> offsets(num_nodes_ + 1, 0);
+    if (num_edges > 0) {
+      intSort::iSort(edges.begin(), num_edges, num_nodes_,
+                     [](Edge e) { return static_cast<long>(GetTarget(e.v)); });
+      intSort::iSort(edges.begin(), offsets.begin(), num_edges, num_nodes_, false,
+                     [](Edge e) { return static_cast<long>(e.u); });
+    }
+    offsets[num_nodes_] = num_edges;
+    pvector<NodeID_> degrees(num_nodes_);
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (NodeID_ n=0; n < num_nodes_; n++) {
+      NodeID_ distinct = 0;
+      for (SGOffset i=offsets[n]; i < offsets[n+1]; i++) {
+        NodeID_ target = GetTarget(edges[i].v);
+        if (target != n && (i == offsets[n] || target != GetTarget(edges[i-1].v)))
+          distinct++;
+      }
+      degrees[n] = distinct;
+    }
+    pvector<SGOffset> sq_offsets = ParallelPrefixSum(degrees);
+    *neighs = HugePageAllocator::Allocate<DestID_>(sq_offsets[num_nodes_]);
+    *index = CSRGraph<NodeID_, DestID_>::GenIndex(sq_offsets, *neighs);
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (NodeID_ n=0; n < num_nodes_; n++) {
+      DestID_ *out = (*index)[n];
+      for (SGOffset i=offsets[n]; i < offsets[n+1]; i++) {
+        NodeID_ target = GetTarget(edges[i].v);
+        if (target == n)
+          continue;
+        if (i == offsets[n] || target != GetTarget(edges[i-1].v))
+          *out++ = edges[i].v;
+        else if (edges[i].v < *(out - 1))
+          *(out - 1) = edges[i].v;
+      }
+    }
+  }
+
+  CSRGraph<NodeID_, DestID_, invert> MakeSortedGraphFromEL(EdgeList &el) {
+    DestID_ **index = nullptr, **inv_index = nullptr;
+    DestID_ *neighs = nullptr, *inv_neighs = nullptr;
+    Timer t;
+    t.Start();
+    if (num_nodes_ == -1)
+      num_nodes_ = FindMaxNodeID(el)+1;
+    if (needs_weights_)
+      Generator<NodeID_, DestID_, WeightT_>::InsertWeights(el);
+    MakeSortedCSR(el, false, &index, &neighs);
+    if (!symmetrize_ && invert)
+      MakeSortedCSR(el, true, &inv_index, &inv_neighs);
+    t.Stop();
+    //PrintTime("Build Time", t.Seconds());
+    if (symmetrize_)
+      return CSRGraph<NodeID_, DestID_, invert>(num_nodes_, index, neighs);
+    else
+      return CSRGraph<NodeID_, DestID_, invert>(num_nodes_, index, neighs,
+                                                inv_index, inv_neighs);
+  }
+
   CSRGraph<NodeID_, DestID_, invert> MakeGraph() {
-    CSRGraph<NodeID_, DestID_, invert> g;
-    {  // extra scope to trigger earlier deletion of el (save memory)
-      EdgeList el;
-      if (cli_.filename() != "") {
-        Reader<NodeID_, DestID_, WeightT_, invert> r(cli_.filename());
-        if ((r.GetSuffix() == ".sg") || (r.GetSuffix() == ".wsg")) {
-          return r.ReadSerializedGraph();
-        } else {
-          el = r.ReadFile(needs_weights_);
-        }
-      } else if (cli_.scale() != -1) {
-        Generator<NodeID_, DestID_> gen(cli_.scale(), cli_.degree());
-        el = gen.GenerateEL(cli_.uniform());
+    EdgeList el;
+    if (cli_.filename() != "") {
+      Reader<NodeID_, DestID_, WeightT_, invert> r(cli_.filename());
+      if ((r.GetSuffix() == ".sg") || (r.GetSuffix() == ".wsg")) {
+        return r.MapSerializedGraph();
+      } else {
+        el = r.ReadFile(needs_weights_);
       }
-      g = MakeGraphFromEL(el);
+    } else if (cli_.scale() != -1) {
+      Generator<NodeID_, DestID_> gen(cli_.scale(), cli_.degree());
+      el = gen.GenerateEL(cli_.uniform());
     }
-    return SquishGraph(g);
+    return MakeSortedGraphFromEL(el);
   }
 
   // Relabels (and rebuilds) graph by order of decreasing degree
   static
   CSRGraph<NodeID_, DestID_, invert> RelabelByDegree(
       const CSRGraph<NodeID_, DestID_, invert> &g) {
-    if (g.directed()) {
-      std::cout << "Cannot relabel directed graph" << std::endl;
-      std::exit(-11);
-    }
     Timer t;
     t.Start();
-    typedef std::pair<int64_t, NodeID_> degree_node_p;
-    pvector<degree_node_p> degree_id_pairs(g.num_nodes());
-    #pragma omp parallel for
-    for (NodeID_ n=0; n < g.num_nodes(); n++)
-      degree_id_pairs[n] = std::make_pair(g.out_degree(n), n);
-    std::sort(degree_id_pairs.begin(), degree_id_pairs.end(),
-              std::greater<degree_node_p>());
-    pvector<NodeID_> degrees(g.num_nodes());
-    pvector<NodeID_> new_ids(g.num_nodes());
-    #pragma omp parallel for
-    for (NodeID_ n=0; n < g.num_nodes(); n++) {
-      degrees[n] = degree_id_pairs[n].first;
-      new_ids[degree_id_pairs[n].second] = n;
-    }
-    pvector<SGOffset> offsets = ParallelPrefixSum(degrees);
-    DestID_* neighs = new DestID_[offsets[g.num_nodes()]];
-    DestID_** index = CSRGraph<NodeID_, DestID_>::GenIndex(offsets, neighs);
-    #pragma omp parallel for
-    for (NodeID_ u=0; u < g.num_nodes(); u++) {
-      for (NodeID_ v : g.out_neigh(u))
-        neighs[offsets[new_ids[u]]++] = new_ids[v];
-      std::sort(index[new_ids[u]], index[new_ids[u]+1]);
-    }
+    typedef GraphReorder<NodeID_, DestID_, invert> Reorder;
+    CSRGraph<NodeID_, DestID_, invert> relabeled = Reorder::Relabel(g, Reorder::DegreeSortOrder(g));
     t.Stop();
     PrintTime("Relabel", t.Seconds());
-    return CSRGraph<NodeID_, DestID_, invert>(g.num_nodes(), index, neighs);
+    return relabeled;
   }
 };
 
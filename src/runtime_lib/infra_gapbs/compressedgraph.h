@@ -0,0 +1,273 @@
+#ifndef COMPRESSED_GRAPH_H_
+#define COMPRESSED_GRAPH_H_
+
+#include <algorithm>
+#include <cinttypes>
+#include <type_traits>
+#include <vector>
+
+
+/*
+GraphIt runtime
+Class:  CompressedAdjacency
+
+Delta coded copy of the adjacency lists of a CSRGraph (Ligra+ style)
+ - The neighbors of every vertex are sorted, the first one is stored as
+   the signed difference to the source vertex, every following one as the
+   gap to its predecessor, so clustered lists take one or two units per edge
+ - Values are variable length codes, the code is a template parameter:
+   ByteCode uses 7 data bits per byte, NibbleCode 3 data bits per nibble,
+   the high bit of a unit marks that more units follow
+ - Weights (NodeWeight destinations) follow their target as signed codes
+ - Every list starts on a byte boundary so the lists of different vertices
+   can be decoded independently, offsets_ holds the byte position
+ - Neighbors are decoded in place by the iterator of the Neighborhood, so a
+   traversal reads the compressed bytes only
+*/
+
+
+// signed values are zigzag coded: 0, -1, 1, -2, ... become 0, 1, 2, 3, ...
+static inline uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static inline int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+
+// Positions are counted in bytes
+struct ByteCode {
+  static int64_t Bytes(int64_t units) {
+    return units;
+  }
+
+  // writes value at pos (only counts the units when buffer is null)
+  static int64_t Encode(uint8_t *buffer, int64_t pos, uint64_t value) {
+    do {
+      uint8_t unit = value & 0x7f;
+      value >>= 7;
+      if (value != 0)
+        unit |= 0x80;
+      if (buffer != nullptr)
+        buffer[pos] = unit;
+      pos++;
+    } while (value != 0);
+    return pos;
+  }
+
+  static uint64_t Decode(const uint8_t *buffer, int64_t &pos) {
+    uint64_t value = 0;
+    int shift = 0;
+    uint8_t unit;
+    do {
+      unit = buffer[pos++];
+      value |= static_cast<uint64_t>(unit & 0x7f) << shift;
+      shift += 7;
+    } while (unit & 0x80);
+    return value;
+  }
+};
+
+
+// Positions are counted in nibbles, the high nibble of a byte comes first
+struct NibbleCode {
+  static int64_t Bytes(int64_t units) {
+    return (units + 1) / 2;
+  }
+
+  static int64_t Encode(uint8_t *buffer, int64_t pos, uint64_t value) {
+    do {
+      uint8_t unit = value & 0x7;
+      value >>= 3;
+      if (value != 0)
+        unit |= 0x8;
+      if (buffer != nullptr) {
+        if (pos & 1)
+          buffer[pos >> 1] = (buffer[pos >> 1] & 0xf0) | unit;
+        else
+          buffer[pos >> 1] = (buffer[pos >> 1] & 0x0f) | (unit << 4);
+      }
+      pos++;
+    } while (value != 0);
+    return pos;
+  }
+
+  static uint64_t Decode(const uint8_t *buffer, int64_t &pos) {
+    uint64_t value = 0;
+    int shift = 0;
+    uint8_t unit;
+    do {
+      unit = (buffer[pos >> 1] >> ((~pos & 1) << 2)) & 0xf;
+      pos++;
+      value |= static_cast<uint64_t>(unit & 0x7) << shift;
+      shift += 3;
+    } while (unit & 0x8);
+    return value;
+  }
+};
+
+
+// Splits a destination into target and weight, unweighted graphs store targets only
+template <class NodeID_, class DestID_>
+struct CompressedDest {
+  static const bool kWeighted = false;
+  static NodeID_ Target(const DestID_ &d) { return d; }
+  static int64_t Weight(const DestID_ &) { return 0; }
+  static DestID_ Make(NodeID_ v, int64_t) { return v; }
+};
+
+template <class NodeID_, template <class, class> class NodeWeight_, class WeightT_>
+struct CompressedDest<NodeID_, NodeWeight_<NodeID_, WeightT_>> {
+  static_assert(std::is_integral<WeightT_>::value, "compressed edges need integer weights");
+  typedef NodeWeight_<NodeID_, WeightT_> DestID_;
+  static const bool kWeighted = true;
+  static NodeID_ Target(const DestID_ &d) { return d.v; }
+  static int64_t Weight(const DestID_ &d) { return d.w; }
+  static DestID_ Make(NodeID_ v, int64_t w) { return DestID_(v, static_cast<WeightT_>(w)); }
+};
+
+
+template <class NodeID_, class DestID_>
+class CompressedAdjacency {
+  typedef CompressedDest<NodeID_, DestID_> Dest;
+
+ public:
+  template <class Code>
+  class Neighborhood {
+    const uint8_t *edges_;
+    NodeID_ source_;
+    int64_t degree_;
+   public:
+    class iterator {
+      const uint8_t *edges_;
+      int64_t pos_;
+      int64_t remaining_;
+      NodeID_ last_;
+      DestID_ current_;
+
+      void DecodeNext(bool first) {
+        int64_t delta = first ? ZigZagDecode(Code::Decode(edges_, pos_))
+                              : static_cast<int64_t>(Code::Decode(edges_, pos_));
+        last_ = static_cast<NodeID_>(last_ + delta);
+        int64_t weight = Dest::kWeighted ? ZigZagDecode(Code::Decode(edges_, pos_)) : 0;
+        current_ = Dest::Make(last_, weight);
+      }
+
+     public:
+      iterator(const uint8_t *edges, NodeID_ source, int64_t remaining) :
+          edges_(edges), pos_(0), remaining_(remaining), last_(source) {
+        if (remaining_ != 0)
+          DecodeNext(true);
+      }
+
+      DestID_ operator*() const { return current_; }
+
+      iterator& operator++() {
+        if (--remaining_ != 0)
+          DecodeNext(false);
+        return *this;
+      }
+
+      bool operator!=(const iterator &other) const {
+        return remaining_ != other.remaining_;
+      }
+    };
+
+    Neighborhood(const uint8_t *edges, NodeID_ source, int64_t degree) :
+        edges_(edges), source_(source), degree_(degree) {}
+    iterator begin() const { return iterator(edges_, source_, degree_); }
+    iterator end() const { return iterator(nullptr, source_, 0); }
+  };
+
+  CompressedAdjacency() : num_nodes_(0), num_bytes_(0), offsets_(nullptr),
+                          degrees_(nullptr), edges_(nullptr) {}
+
+  ~CompressedAdjacency() {
+    delete[] offsets_;
+    delete[] degrees_;
+    delete[] edges_;
+  }
+
+  CompressedAdjacency(const CompressedAdjacency&) = delete;
+  CompressedAdjacency& operator=(const CompressedAdjacency&) = delete;
+
+  // Encodes the lists index[v] .. index[v+1] of the CSR index array
+  template <class Code>
+  void Build(int64_t num_nodes, DestID_ **index) {
+    num_nodes_ = num_nodes;
+    offsets_ = new int64_t[num_nodes_ + 1];
+    degrees_ = new NodeID_[num_nodes_];
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (int64_t v = 0; v < num_nodes_; v++) {
+      degrees_[v] = static_cast<NodeID_>(index[v + 1] - index[v]);
+      offsets_[v] = Code::Bytes(EncodeList<Code>(nullptr, v, index[v], index[v + 1]));
+    }
+    int64_t total = 0;
+    for (int64_t v = 0; v < num_nodes_; v++) {
+      int64_t bytes = offsets_[v];
+      offsets_[v] = total;
+      total += bytes;
+    }
+    offsets_[num_nodes_] = total;
+    num_bytes_ = total;
+    edges_ = new uint8_t[num_bytes_];
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (int64_t v = 0; v < num_nodes_; v++) {
+      std::fill(edges_ + offsets_[v], edges_ + offsets_[v + 1], 0);
+      EncodeList<Code>(edges_ + offsets_[v], v, index[v], index[v + 1]);
+    }
+  }
+
+  template <class Code>
+  Neighborhood<Code> neigh(NodeID_ n) const {
+    return Neighborhood<Code>(edges_ + offsets_[n], n, degrees_[n]);
+  }
+
+  int64_t degree(NodeID_ n) const {
+    return degrees_[n];
+  }
+
+  // size of the encoded neighbor lists and of their index
+  int64_t num_bytes() const {
+    return num_bytes_ + (num_nodes_ + 1) * sizeof(int64_t) + num_nodes_ * sizeof(NodeID_);
+  }
+
+ private:
+  int64_t num_nodes_;
+  int64_t num_bytes_;
+  int64_t *offsets_;
+  NodeID_ *degrees_;
+  uint8_t *edges_;
+
+  // returns the number of code units of the list, writes it when buffer is not null
+  template <class Code>
+  static int64_t EncodeList(uint8_t *buffer, int64_t source, DestID_ *begin, DestID_ *end) {
+    std::vector<DestID_> sorted;
+    if (!std::is_sorted(begin, end, TargetLess)) {
+      sorted.assign(begin, end);
+      std::sort(sorted.begin(), sorted.end(), TargetLess);
+      begin = sorted.data();
+      end = begin + sorted.size();
+    }
+    int64_t pos = 0;
+    int64_t last = source;
+    for (DestID_ *it = begin; it != end; it++) {
+      int64_t target = Dest::Target(*it);
+      if (it == begin)
+        pos = Code::Encode(buffer, pos, ZigZagEncode(target - last));
+      else
+        pos = Code::Encode(buffer, pos, static_cast<uint64_t>(target - last));
+      last = target;
+      if (Dest::kWeighted)
+        pos = Code::Encode(buffer, pos, ZigZagEncode(Dest::Weight(*it)));
+    }
+    return pos;
+  }
+
+  static bool TargetLess(const DestID_ &a, const DestID_ &b) {
+    return Dest::Target(a) < Dest::Target(b);
+  }
+};
+
+#endif  // COMPRESSED_GRAPH_H_
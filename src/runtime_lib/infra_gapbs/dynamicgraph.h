@@ -0,0 +1,310 @@
+#ifndef DYNAMIC_GRAPH_H_
+#define DYNAMIC_GRAPH_H_
+
+#include <algorithm>
+#include <cinttypes>
+#include <memory>
+#include <vector>
+
+#include "huge_pages.h"
+
+
+/*
+GraphIt runtime
+Class:  DynamicAdjacency
+
+Adjacency lists of a CSRGraph that receives batches of edge insertions and
+deletions
+ - The lists start out in the CSR arrays of the loaded graph, the list of
+   vertex n is index()[n] .. ends()[n], so traversals of the graph do not
+   change
+ - Those arrays are never written: they can be a read only mapping of a
+   serialized graph or shared with copies of the graph, so the list of a
+   vertex is copied to a delta block of its own the first time it changes
+ - The lists are kept sorted by target without duplicate targets, every
+   vertex merges its own part of a batch in parallel. Lists of the graph or
+   of a batch that are not (graphs built in arrival order, e.g. from CSR
+   arrays) are sorted on a copy, of duplicate targets the smallest
+   destination is kept as when a file is loaded
+ - Insert overwrites the weight of an edge that is already present, a list
+   that runs out of room moves to a delta block of its own with twice the
+   room it needs
+ - Delete removes the edges with the targets of the batch in place (once
+   the list is in a delta block or the compacted array)
+ - Once the delta blocks hold more room than half of the edges, the lists
+   are merged back into one contiguous array (Compact)
+*/
+
+
+// Target of a destination, weighted graphs store NodeWeights
+template <class NodeID_, class DestID_>
+struct DynamicDest {
+  static NodeID_ Target(const DestID_ &d) { return d; }
+};
+
+template <class NodeID_, template <class, class> class NodeWeight_, class WeightT_>
+struct DynamicDest<NodeID_, NodeWeight_<NodeID_, WeightT_>> {
+  static NodeID_ Target(const NodeWeight_<NodeID_, WeightT_> &d) { return d.v; }
+};
+
+
+template <class NodeID_, class DestID_>
+class DynamicAdjacency {
+ public:
+  // takes over the lists index[n] .. index[n+1], neighs keeps them alive
+  DynamicAdjacency(int64_t num_nodes, DestID_ **index, std::shared_ptr<DestID_> neighs) :
+      num_nodes_(num_nodes), num_edges_(0), delta_room_(0),
+      neighs_(neighs), owns_neighs_(false) {
+    index_ = new DestID_*[num_nodes_ + 1];
+    ends_ = new DestID_*[num_nodes_];
+    room_ = new int64_t[num_nodes_];
+    blocks_ = new DestID_*[num_nodes_];
+    int64_t num_edges = 0;
+    int64_t delta_room = 0;
+    #pragma omp parallel for schedule(dynamic, 1024) reduction(+ : num_edges, delta_room)
+    for (int64_t n = 0; n < num_nodes_; n++) {
+      index_[n] = index[n];
+      ends_[n] = index[n + 1];
+      room_[n] = index[n + 1] - index[n];
+      blocks_[n] = nullptr;
+      if (!SortedUnique(index[n], index[n + 1])) {
+        std::vector<DestID_> sorted;
+        SortUnique(index[n], index[n + 1], sorted);
+        blocks_[n] = new DestID_[sorted.size()];
+        std::copy(sorted.begin(), sorted.end(), blocks_[n]);
+        index_[n] = blocks_[n];
+        ends_[n] = blocks_[n] + sorted.size();
+        room_[n] = sorted.size();
+        delta_room += sorted.size();
+      }
+      num_edges += ends_[n] - index_[n];
+    }
+    index_[num_nodes_] = index[num_nodes_];
+    num_edges_ = num_edges;
+    delta_room_ = delta_room;
+  }
+
+  ~DynamicAdjacency() {
+    for (int64_t n = 0; n < num_nodes_; n++)
+      delete[] blocks_[n];
+    delete[] blocks_;
+    delete[] room_;
+    delete[] ends_;
+    delete[] index_;
+  }
+
+  DynamicAdjacency(const DynamicAdjacency&) = delete;
+  DynamicAdjacency& operator=(const DynamicAdjacency&) = delete;
+
+  DestID_** index() const {
+    return index_;
+  }
+
+  DestID_** ends() const {
+    return ends_;
+  }
+
+  int64_t num_edges() const {
+    return num_edges_;
+  }
+
+  // returns the number of edges that were not present before
+  int64_t Insert(int64_t batch_nodes, DestID_ **batch_index, DestID_ **batch_ends) {
+    int64_t added = 0;
+    int64_t delta_room = 0;
+    #pragma omp parallel for schedule(dynamic, 1024) reduction(+ : added, delta_room)
+    for (int64_t n = 0; n < batch_nodes; n++) {
+      DestID_ *batch = batch_index[n];
+      DestID_ *batch_end = batch_ends[n];
+      if (batch == batch_end)
+        continue;
+      std::vector<DestID_> sorted;
+      if (!SortedUnique(batch, batch_end)) {
+        SortUnique(batch, batch_end, sorted);
+        batch = sorted.data();
+        batch_end = batch + sorted.size();
+      }
+      int64_t degree = ends_[n] - index_[n];
+      int64_t fresh = CountFresh(index_[n], ends_[n], batch, batch_end);
+      if (Writable(n) && degree + fresh <= room_[n]) {
+        MergeInPlace(index_[n], degree, fresh, batch, batch_end);
+      } else {
+        int64_t room = 2 * (degree + fresh);
+        DestID_ *block = new DestID_[room];
+        Merge(index_[n], ends_[n], batch, batch_end, block);
+        if (blocks_[n] != nullptr)
+          delta_room -= room_[n];
+        delete[] blocks_[n];
+        blocks_[n] = block;
+        index_[n] = block;
+        room_[n] = room;
+        delta_room += room;
+      }
+      ends_[n] = index_[n] + degree + fresh;
+      added += fresh;
+    }
+    num_edges_ += added;
+    delta_room_ += delta_room;
+    if (2 * delta_room_ > num_edges_)
+      Compact();
+    return added;
+  }
+
+  // returns the number of edges that were removed
+  int64_t Delete(int64_t batch_nodes, DestID_ **batch_index, DestID_ **batch_ends) {
+    int64_t removed = 0;
+    int64_t delta_room = 0;
+    #pragma omp parallel for schedule(dynamic, 1024) reduction(+ : removed, delta_room)
+    for (int64_t n = 0; n < batch_nodes; n++) {
+      DestID_ *batch = batch_index[n];
+      DestID_ *batch_end = batch_ends[n];
+      if (batch == batch_end)
+        continue;
+      std::vector<DestID_> sorted;
+      if (!SortedUnique(batch, batch_end)) {
+        SortUnique(batch, batch_end, sorted);
+        batch = sorted.data();
+        batch_end = batch + sorted.size();
+      }
+      if (!Writable(n)) {
+        if (CountFresh(index_[n], ends_[n], batch, batch_end) == batch_end - batch)
+          continue;
+        int64_t degree = ends_[n] - index_[n];
+        DestID_ *block = new DestID_[degree];
+        std::copy(index_[n], ends_[n], block);
+        blocks_[n] = block;
+        index_[n] = block;
+        ends_[n] = block + degree;
+        room_[n] = degree;
+        delta_room += degree;
+      }
+      DestID_ *out = index_[n];
+      for (DestID_ *it = index_[n]; it < ends_[n]; it++) {
+        while (batch < batch_end && Target(*batch) < Target(*it))
+          batch++;
+        if (batch < batch_end && Target(*batch) == Target(*it))
+          continue;
+        *out++ = *it;
+      }
+      removed += ends_[n] - out;
+      ends_[n] = out;
+    }
+    num_edges_ -= removed;
+    delta_room_ += delta_room;
+    if (2 * delta_room_ > num_edges_)
+      Compact();
+    return removed;
+  }
+
+  // moves all lists into one contiguous array and frees the delta blocks
+  void Compact() {
+    int64_t *offsets = new int64_t[num_nodes_ + 1];
+    int64_t total = 0;
+    for (int64_t n = 0; n < num_nodes_; n++) {
+      offsets[n] = total;
+      total += ends_[n] - index_[n];
+    }
+    offsets[num_nodes_] = total;
+    std::shared_ptr<DestID_> neighs(HugePageAllocator::Allocate<DestID_>(total), HugePageAllocator::Deleter<DestID_>());
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (int64_t n = 0; n < num_nodes_; n++) {
+      DestID_ *list = neighs.get() + offsets[n];
+      std::copy(index_[n], ends_[n], list);
+      delete[] blocks_[n];
+      blocks_[n] = nullptr;
+      index_[n] = list;
+      ends_[n] = neighs.get() + offsets[n + 1];
+      room_[n] = offsets[n + 1] - offsets[n];
+    }
+    index_[num_nodes_] = neighs.get() + total;
+    neighs_ = neighs;
+    owns_neighs_ = true;
+    delta_room_ = 0;
+    delete[] offsets;
+  }
+
+ private:
+  int64_t num_nodes_;
+  int64_t num_edges_;
+  // room of the delta blocks
+  int64_t delta_room_;
+  DestID_ **index_;
+  DestID_ **ends_;
+  // number of edges that fit at index_[n]
+  int64_t *room_;
+  // delta block of the vertex, null while its list is in neighs_
+  DestID_ **blocks_;
+  std::shared_ptr<DestID_> neighs_;
+  // neighs_ is the array of the last Compact, not the one of the loaded graph
+  bool owns_neighs_;
+
+  // the list of the vertex may be changed in place
+  bool Writable(int64_t n) const {
+    return owns_neighs_ || blocks_[n] != nullptr;
+  }
+
+  static NodeID_ Target(const DestID_ &d) {
+    return DynamicDest<NodeID_, DestID_>::Target(d);
+  }
+
+  static bool SortedUnique(const DestID_ *list, const DestID_ *list_end) {
+    for (const DestID_ *it = list; it + 1 < list_end; it++) {
+      if (!(Target(*it) < Target(*(it + 1))))
+        return false;
+    }
+    return true;
+  }
+
+  // sorted copy of the list, of duplicate targets only the smallest destination stays
+  static void SortUnique(const DestID_ *list, const DestID_ *list_end, std::vector<DestID_> &sorted) {
+    sorted.assign(list, list_end);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end(), [](const DestID_ &a, const DestID_ &b) {
+      return Target(a) == Target(b);
+    }), sorted.end());
+  }
+
+  // number of batch targets that are not in the list
+  static int64_t CountFresh(DestID_ *list, DestID_ *list_end, DestID_ *batch, DestID_ *batch_end) {
+    int64_t fresh = 0;
+    while (batch < batch_end) {
+      while (list < list_end && Target(*list) < Target(*batch))
+        list++;
+      if (list == list_end || Target(*list) != Target(*batch))
+        fresh++;
+      batch++;
+    }
+    return fresh;
+  }
+
+  // merges from the back, so the list can grow within its room
+  static void MergeInPlace(DestID_ *list, int64_t degree, int64_t fresh,
+                           DestID_ *batch, DestID_ *batch_end) {
+    DestID_ *in = list + degree;
+    DestID_ *out = list + degree + fresh;
+    while (batch < batch_end) {
+      if (in > list && Target(*(in - 1)) > Target(*(batch_end - 1))) {
+        *--out = *--in;
+      } else {
+        if (in > list && Target(*(in - 1)) == Target(*(batch_end - 1)))
+          in--;
+        *--out = *--batch_end;
+      }
+    }
+  }
+
+  static void Merge(DestID_ *list, DestID_ *list_end, DestID_ *batch, DestID_ *batch_end,
+                    DestID_ *out) {
+    while (list < list_end || batch < batch_end) {
+      if (batch == batch_end || (list < list_end && Target(*list) < Target(*batch))) {
+        *out++ = *list++;
+      } else {
+        if (list < list_end && Target(*list) == Target(*batch))
+          list++;
+        *out++ = *batch++;
+      }
+    }
+  }
+};
+
+#endif  // DYNAMIC_GRAPH_H_
@@ -9,11 +9,17 @@
 #include <iostream>
 #include <type_traits>
 #include <map>
+#include <vector>
+#include <algorithm>
 
+#include "huge_pages.h"
 #include "pvector.h"
 #include "util.h"
 
 #include "segmentgraph.h"
+#include "segment_cache.h"
+#include "compressedgraph.h"
+#include "dynamicgraph.h"
 #include <memory>
 #include <assert.h>
 
@@ -26,6 +32,8 @@ Simple container for graph in CSR format
  - Intended to be constructed by a Builder
  - To make weighted, set DestID_ template type to NodeWeight
  - MakeInverse parameter controls whether graph stores its inverse
+ - The neighbors of n are index[n] .. end[n], end is index shifted by one
+   until the graph receives edge updates (insertEdges, deleteEdges)
 */
 
 
@@ -88,6 +96,23 @@ typedef int32_t SGID;
 typedef EdgePair<SGID> SGEdge;
 typedef int64_t SGOffset;
 
+// Header of the mappable serialized layout (WriterBase with aligned = true).
+// Every section after it starts on an 8 byte boundary so the neighbor arrays
+// can be used in place from a memory mapping. The first magic byte is never
+// a valid bool, which is how readers tell it apart from the GAPBS layout.
+struct MappableSGHeader {
+  char magic[8];
+  int64_t directed;
+  SGOffset num_edges;
+  SGOffset num_nodes;
+};
+
+static const char kMappableSGMagic[8] = {'G', 'R', 'I', 'T', 'S', 'G', '0', '1'};
+
+static inline int64_t MappableSGPad(int64_t bytes) {
+  return (bytes + 7) & ~int64_t(7);
+}
+
 
 
 template <class NodeID_, class DestID_ = NodeID_, bool MakeInverse = true>
@@ -96,11 +121,13 @@ class CSRGraph {
   class Neighborhood {
     NodeID_ n_;
     DestID_** g_index_;
+    DestID_** g_end_;
    public:
-    Neighborhood(NodeID_ n, DestID_** g_index) : n_(n), g_index_(g_index) {}
+    Neighborhood(NodeID_ n, DestID_** g_index, DestID_** g_end) :
+        n_(n), g_index_(g_index), g_end_(g_end) {}
     typedef DestID_* iterator;
     iterator begin() { return g_index_[n_]; }
-    iterator end()   { return g_index_[n_+1]; }
+    iterator end()   { return g_end_[n_]; }
   };
 
   void ReleaseResources() {
@@ -125,6 +152,14 @@ class CSRGraph {
     in_neighbors_shared_.reset();
     flags_shared_.reset();
     offsets_shared_.reset();
+    out_offsets_shared_.reset();
+    out_offsets_ = nullptr;
+    compressed_out_.reset();
+    compressed_in_.reset();
+    new_ids_shared_.reset();
+    original_ids_shared_.reset();
+    dynamic_out_.reset();
+    dynamic_in_.reset();
     for (auto iter = label_to_segment.begin(); iter != label_to_segment.end(); iter++) {
       delete ((*iter).second);
     }
@@ -132,43 +167,67 @@ class CSRGraph {
 
 
  public:
-  CSRGraph() : directed_(false), num_nodes_(-1), num_edges_(-1),
+  CSRGraph() : flags_(nullptr), is_transpose_(false),
+    directed_(false), num_nodes_(-1), num_edges_(-1),
     out_index_(nullptr), out_neighbors_(nullptr),
-  in_index_(nullptr), in_neighbors_(nullptr), flags_(nullptr), is_transpose_(false) {}
+  in_index_(nullptr), in_neighbors_(nullptr), out_end_(nullptr), in_end_(nullptr) {}
 
   CSRGraph(int64_t num_nodes, DestID_** index, DestID_* neighs) :
     directed_(false), num_nodes_(num_nodes),
     out_index_(index), out_neighbors_(neighs),
-    in_index_(index), in_neighbors_(neighs){
-      out_index_shared_.reset(index);
-      out_neighbors_shared_.reset(neighs);
+    in_index_(index), in_neighbors_(neighs),
+    out_end_(index + 1), in_end_(index + 1){
+      out_index_shared_.reset(index, HugePageAllocator::Deleter<DestID_*>());
+      out_neighbors_shared_.reset(neighs, HugePageAllocator::Deleter<DestID_>());
       in_index_shared_ = out_index_shared_;
       in_neighbors_shared_ = out_neighbors_shared_;
       
       num_edges_ = (out_index_[num_nodes_] - out_index_[0]) / 2;
       //adding flags used for deduplication
-      flags_ = new int[num_nodes_];
-      flags_shared_.reset(flags_);
+      flags_ = HugePageAllocator::Allocate<int>(num_nodes_);
+      flags_shared_.reset(flags_, HugePageAllocator::Deleter<int>());
     //adding offsets for load balacne scheme
     SetUpOffsets(true);
     //Set this up for getting random neighbors
       srand(time(NULL));
     }
 
+  // Undirected graph whose arrays are owned elsewhere (e.g. a file mapping),
+  // the shared_ptr deleters decide how they get released
+  CSRGraph(int64_t num_nodes, std::shared_ptr<DestID_*> index,
+           std::shared_ptr<DestID_> neighs) :
+    is_transpose_(false), directed_(false), num_nodes_(num_nodes),
+    out_index_(index.get()), out_neighbors_(neighs.get()),
+    in_index_(index.get()), in_neighbors_(neighs.get()),
+    out_end_(index.get() + 1), in_end_(index.get() + 1){
+      out_index_shared_ = index;
+      out_neighbors_shared_ = neighs;
+      in_index_shared_ = out_index_shared_;
+      in_neighbors_shared_ = out_neighbors_shared_;
+
+      num_edges_ = (out_index_[num_nodes_] - out_index_[0]) / 2;
+      flags_ = HugePageAllocator::Allocate<int>(num_nodes_);
+      flags_shared_.reset(flags_, HugePageAllocator::Deleter<int>());
+      SetUpOffsets(true);
+      //Set this up for getting random neighbors
+      srand(time(NULL));
+    }
+
   CSRGraph(int64_t num_nodes, DestID_** out_index, DestID_* out_neighs,
         DestID_** in_index, DestID_* in_neighs) :
-    directed_(true), num_nodes_(num_nodes),
+    is_transpose_(false), directed_(true), num_nodes_(num_nodes),
     out_index_(out_index), out_neighbors_(out_neighs),
-    in_index_(in_index), in_neighbors_(in_neighs), is_transpose_(false){
+    in_index_(in_index), in_neighbors_(in_neighs),
+    out_end_(out_index + 1), in_end_(in_index + 1){
       num_edges_ = out_index_[num_nodes_] - out_index_[0];
 
 
-      out_index_shared_.reset(out_index);
-      out_neighbors_shared_.reset(out_neighs);
-      in_index_shared_.reset(in_index);
-      in_neighbors_shared_.reset(in_neighs);
-      flags_ = new int[num_nodes_];
-      flags_shared_.reset(flags_);
+      out_index_shared_.reset(out_index, HugePageAllocator::Deleter<DestID_*>());
+      out_neighbors_shared_.reset(out_neighs, HugePageAllocator::Deleter<DestID_>());
+      in_index_shared_.reset(in_index, HugePageAllocator::Deleter<DestID_*>());
+      in_neighbors_shared_.reset(in_neighs, HugePageAllocator::Deleter<DestID_>());
+      flags_ = HugePageAllocator::Allocate<int>(num_nodes_);
+      flags_shared_.reset(flags_, HugePageAllocator::Deleter<int>());
         SetUpOffsets(true);
 
       //Set this up for getting random neighbors
@@ -177,17 +236,18 @@ class CSRGraph {
 
     CSRGraph(int64_t num_nodes, DestID_** out_index, DestID_* out_neighs,
         DestID_** in_index, DestID_* in_neighs, bool is_transpose) :
-    directed_(true), num_nodes_(num_nodes),
+    is_transpose_(is_transpose), directed_(true), num_nodes_(num_nodes),
     out_index_(out_index), out_neighbors_(out_neighs),
-    in_index_(in_index), in_neighbors_(in_neighs) , is_transpose_(is_transpose){
+    in_index_(in_index), in_neighbors_(in_neighs),
+    out_end_(out_index + 1), in_end_(in_index + 1){
       num_edges_ = out_index_[num_nodes_] - out_index_[0];
 
-      out_index_shared_.reset(out_index);
-      out_neighbors_shared_.reset(out_neighs);
-      in_index_shared_.reset(in_index);
-      in_neighbors_shared_.reset(in_neighs);
-      flags_ = new int[num_nodes_];
-      flags_shared_.reset(flags_);
+      out_index_shared_.reset(out_index, HugePageAllocator::Deleter<DestID_*>());
+      out_neighbors_shared_.reset(out_neighs, HugePageAllocator::Deleter<DestID_>());
+      in_index_shared_.reset(in_index, HugePageAllocator::Deleter<DestID_*>());
+      in_neighbors_shared_.reset(in_neighs, HugePageAllocator::Deleter<DestID_>());
+      flags_ = HugePageAllocator::Allocate<int>(num_nodes_);
+      flags_shared_.reset(flags_, HugePageAllocator::Deleter<int>());
     SetUpOffsets(true);
 
         //Set this up for getting random neighbors
@@ -195,27 +255,30 @@ class CSRGraph {
   }
     CSRGraph(int64_t num_nodes, std::shared_ptr<DestID_*> out_index, std::shared_ptr<DestID_> out_neighs,
         shared_ptr<DestID_*> in_index, shared_ptr<DestID_> in_neighs, bool is_transpose) :
-    directed_(true), num_nodes_(num_nodes),
+    is_transpose_(is_transpose), directed_(true), num_nodes_(num_nodes),
     out_index_(out_index.get()), out_neighbors_(out_neighs.get()),
-    in_index_(in_index.get()), in_neighbors_(in_neighs.get()) , is_transpose_(is_transpose){
+    in_index_(in_index.get()), in_neighbors_(in_neighs.get()),
+    out_end_(out_index.get() + 1), in_end_(in_index.get() + 1){
       num_edges_ = out_index_[num_nodes_] - out_index_[0];
 
       out_index_shared_ = (out_index);
       out_neighbors_shared_ = (out_neighs);
       in_index_shared_ = (in_index);
       in_neighbors_shared_ = (in_neighs);
-      flags_ = new int[num_nodes_];
-      flags_shared_.reset(flags_);
+      flags_ = HugePageAllocator::Allocate<int>(num_nodes_);
+      flags_shared_.reset(flags_, HugePageAllocator::Deleter<int>());
     SetUpOffsets(true);
         //Set this up for getting random neighbors
         srand(time(NULL));
   }
 
   
-    CSRGraph(CSRGraph& other) : directed_(other.directed_),
+    CSRGraph(CSRGraph& other) : flags_(nullptr), offsets_(nullptr), is_transpose_(false),
+                                 directed_(other.directed_),
                                  num_nodes_(other.num_nodes_), num_edges_(other.num_edges_),
                                  out_index_(other.out_index_), out_neighbors_(other.out_neighbors_),
-                                 in_index_(other.in_index_), in_neighbors_(other.in_neighbors_), is_transpose_(false){
+                                 in_index_(other.in_index_), in_neighbors_(other.in_neighbors_),
+                                 out_end_(other.out_end_), in_end_(other.in_end_){
    /* Commenting this because object is not taking owner ship of the elements, notice destructor_free is set to false
         other.num_edges_ = -1;
         other.num_nodes_ = -1;
@@ -230,22 +293,32 @@ class CSRGraph {
         out_neighbors_shared_ = other.out_neighbors_shared_;
         in_index_shared_ = other.in_index_shared_;
         in_neighbors_shared_ = other.in_neighbors_shared_;
+        compressed_out_ = other.compressed_out_;
+        compressed_in_ = other.compressed_in_;
+        new_ids_shared_ = other.new_ids_shared_;
+        original_ids_shared_ = other.original_ids_shared_;
+        dynamic_out_ = other.dynamic_out_;
+        dynamic_in_ = other.dynamic_in_;
         //Set this up for getting random neighbors
         srand(time(NULL));
 	
     }
 
 
-  CSRGraph(CSRGraph&& other) : directed_(other.directed_),
+  CSRGraph(CSRGraph&& other) : flags_(nullptr), offsets_(nullptr), is_transpose_(false),
+    directed_(other.directed_),
     num_nodes_(other.num_nodes_), num_edges_(other.num_edges_),
     out_index_(other.out_index_), out_neighbors_(other.out_neighbors_),
-    in_index_(other.in_index_), in_neighbors_(other.in_neighbors_), is_transpose_(false){
+    in_index_(other.in_index_), in_neighbors_(other.in_neighbors_),
+    out_end_(other.out_end_), in_end_(other.in_end_){
       other.num_edges_ = -1;
       other.num_nodes_ = -1;
       other.out_index_ = nullptr;
       other.out_neighbors_ = nullptr;
       other.in_index_ = nullptr;
       other.in_neighbors_ = nullptr;
+      other.out_end_ = nullptr;
+      other.in_end_ = nullptr;
       other.flags_ = nullptr;
     other.offsets_ = nullptr;
        
@@ -253,6 +326,12 @@ class CSRGraph {
         out_neighbors_shared_ = other.out_neighbors_shared_;
         in_index_shared_ = other.in_index_shared_;
         in_neighbors_shared_ = other.in_neighbors_shared_;
+        compressed_out_ = other.compressed_out_;
+        compressed_in_ = other.compressed_in_;
+        new_ids_shared_ = other.new_ids_shared_;
+        original_ids_shared_ = other.original_ids_shared_;
+        dynamic_out_ = other.dynamic_out_;
+        dynamic_in_ = other.dynamic_in_;
        
         other.out_index_shared_.reset(); 
         other.out_neighbors_shared_.reset();
@@ -261,6 +340,12 @@ class CSRGraph {
        
         other.flags_shared_.reset(); 
         other.offsets_shared_.reset();
+        other.compressed_out_.reset();
+        other.compressed_in_.reset();
+        other.new_ids_shared_.reset();
+        other.original_ids_shared_.reset();
+        other.dynamic_out_.reset();
+        other.dynamic_in_.reset();
       //Set this up for getting random neighbors
       srand(time(NULL));
   }
@@ -289,10 +374,18 @@ class CSRGraph {
             out_neighbors_ = other.out_neighbors_;
             in_index_ = other.in_index_;
             in_neighbors_ = other.in_neighbors_;
+            out_end_ = other.out_end_;
+            in_end_ = other.in_end_;
         out_index_shared_ = other.out_index_shared_;
         out_neighbors_shared_ = other.out_neighbors_shared_;
         in_index_shared_ = other.in_index_shared_;
         in_neighbors_shared_ = other.in_neighbors_shared_;
+        compressed_out_ = other.compressed_out_;
+        compressed_in_ = other.compressed_in_;
+        new_ids_shared_ = other.new_ids_shared_;
+        original_ids_shared_ = other.original_ids_shared_;
+        dynamic_out_ = other.dynamic_out_;
+        dynamic_in_ = other.dynamic_in_;
             //need the following, otherwise would get double free errors
 /*
           other.num_edges_ = -1;
@@ -319,16 +412,26 @@ class CSRGraph {
       out_neighbors_ = other.out_neighbors_;
       in_index_ = other.in_index_;
       in_neighbors_ = other.in_neighbors_;
+      out_end_ = other.out_end_;
+      in_end_ = other.in_end_;
         out_index_shared_ = other.out_index_shared_;
         out_neighbors_shared_ = other.out_neighbors_shared_;
         in_index_shared_ = other.in_index_shared_;
         in_neighbors_shared_ = other.in_neighbors_shared_;
+        compressed_out_ = other.compressed_out_;
+        compressed_in_ = other.compressed_in_;
+        new_ids_shared_ = other.new_ids_shared_;
+        original_ids_shared_ = other.original_ids_shared_;
+        dynamic_out_ = other.dynamic_out_;
+        dynamic_in_ = other.dynamic_in_;
       other.num_edges_ = -1;
       other.num_nodes_ = -1;
       other.out_index_ = nullptr;
       other.out_neighbors_ = nullptr;
       other.in_index_ = nullptr;
       other.in_neighbors_ = nullptr;
+      other.out_end_ = nullptr;
+      other.in_end_ = nullptr;
       other.flags_ = nullptr;
       other.offsets_ = nullptr;
         other.out_index_shared_.reset(); 
@@ -338,6 +441,12 @@ class CSRGraph {
        
         other.flags_shared_.reset(); 
         other.offsets_shared_.reset();
+        other.compressed_out_.reset();
+        other.compressed_in_.reset();
+        other.new_ids_shared_.reset();
+        other.original_ids_shared_.reset();
+        other.dynamic_out_.reset();
+        other.dynamic_in_.reset();
     }
     return *this;
   }
@@ -351,29 +460,40 @@ class CSRGraph {
   }
 
   int64_t num_edges() const {
+    if (dynamic_out_ != nullptr)
+      return directed_ ? dynamic_out_->num_edges() : dynamic_out_->num_edges() / 2;
     return num_edges_;
   }
 
   int64_t num_edges_directed() const {
-    return directed_ ? num_edges_ : 2*num_edges_;
+    return directed_ ? num_edges() : 2*num_edges();
   }
 
+  // a graph that dropped its CSR arrays (buildCompressedGraph) reads the degrees off the compressed lists
   int64_t out_degree(NodeID_ v) const {
-    return out_index_[v+1] - out_index_[v];
+    if (out_index_ == nullptr)
+      return compressed_out_->degree(v);
+    return out_end_[v] - out_index_[v];
   }
 
   int64_t in_degree(NodeID_ v) const {
     static_assert(MakeInverse, "Graph inversion disabled but reading inverse");
-    return in_index_[v+1] - in_index_[v];
+    if (in_index_ == nullptr)
+      return compressed_in_->degree(v);
+    return in_end_[v] - in_index_[v];
+  }
+
+  bool has_csr() const {
+    return out_index_ != nullptr;
   }
 
   Neighborhood out_neigh(NodeID_ n) const {
-    return Neighborhood(n, out_index_);
+    return Neighborhood(n, out_index_, out_end_);
   }
 
   Neighborhood in_neigh(NodeID_ n) const {
     static_assert(MakeInverse, "Graph inversion disabled but reading inverse");
-    return Neighborhood(n, in_index_);
+    return Neighborhood(n, in_index_, in_end_);
   }
 
   NodeID_ get_random_out_neigh(NodeID_ n)  {
@@ -411,7 +531,7 @@ class CSRGraph {
 
   static DestID_** GenIndex(const pvector<SGOffset> &offsets, DestID_* neighs) {
     NodeID_ length = offsets.size();
-    DestID_** index = new DestID_*[length];
+    DestID_** index = HugePageAllocator::Allocate<DestID_*>(length);
     #pragma omp parallel for
     for (NodeID_ n=0; n < length; n++)
       index[n] = neighs + offsets[n];
@@ -420,22 +540,34 @@ class CSRGraph {
 
   pvector<SGOffset> VertexOffsets(bool in_graph = false) const {
     pvector<SGOffset> offsets(num_nodes_+1);
-    for (NodeID_ n=0; n < num_nodes_+1; n++)
+    offsets[0] = 0;
+    for (NodeID_ n=0; n < num_nodes_; n++)
       if (in_graph)
-        offsets[n] = in_index_[n] - in_index_[0];
+        offsets[n+1] = offsets[n] + in_degree(n);
       else
-        offsets[n] = out_index_[n] - out_index_[0];
+        offsets[n+1] = offsets[n] + out_degree(n);
     return offsets;
   }
 
   void SetUpOffsets(bool in_graph = false)  {
-      offsets_ = new SGOffset[num_nodes_+1];
-      offsets_shared_.reset(offsets_);
-      for (NodeID_ n=0; n < num_nodes_+1; n++)
+      offsets_ = HugePageAllocator::Allocate<SGOffset>(num_nodes_+1);
+      offsets_shared_.reset(offsets_, HugePageAllocator::Deleter<SGOffset>());
+      offsets_[0] = 0;
+      for (NodeID_ n=0; n < num_nodes_; n++)
         if (in_graph)
-          offsets_[n] = in_index_[n] - in_index_[0];
+          offsets_[n+1] = offsets_[n] + (in_end_[n] - in_index_[n]);
         else
-          offsets_[n] = out_index_[n] - out_index_[0];
+          offsets_[n+1] = offsets_[n] + (out_end_[n] - out_index_[n]);
+    }
+
+  // offsets of the out edges of every vertex, kept next to the in edge offsets of SetUpOffsets(true)
+  // for the edge based DensePush, built on first use and dropped by edge updates
+  void SetUpOutOffsets() {
+      out_offsets_ = HugePageAllocator::Allocate<SGOffset>(num_nodes_+1);
+      out_offsets_shared_.reset(out_offsets_, HugePageAllocator::Deleter<SGOffset>());
+      out_offsets_[0] = 0;
+      for (NodeID_ n=0; n < num_nodes_; n++)
+        out_offsets_[n+1] = out_offsets_[n] + out_degree(n);
     }
 
   Range<NodeID_> vertices() const {
@@ -451,75 +583,315 @@ class CSRGraph {
     return label_to_segment[label]->numSegments;      
   }
   
-  void buildPullSegmentedGraphs(std::string label, int numSegments, bool numa_aware=false, std::string path="") {
+  // Builds the delta coded copies of the out (and in) neighbors used by
+  // schedules with a compressed edge layout, Code is ByteCode or NibbleCode.
+  // With release_csr the CSR index and neighbor arrays are freed afterwards,
+  // the degrees then come from the compressed lists and the in edge offsets
+  // (get_offsets_) stay as the constructor built them
+  template <class Code>
+  void buildCompressedGraph(bool release_csr = false) {
+    compressed_out_ = std::make_shared<CompressedAdjacency<NodeID_, DestID_>>();
+    compressed_out_->template Build<Code>(num_nodes_, out_index_);
+    if (directed_) {
+      compressed_in_ = std::make_shared<CompressedAdjacency<NodeID_, DestID_>>();
+      compressed_in_->template Build<Code>(num_nodes_, in_index_);
+    } else {
+      compressed_in_ = compressed_out_;
+    }
+    if (release_csr)
+      ReleaseCSR();
+  }
+
+  // Stops on graphs that no longer have CSR arrays, for the builtins that read them outside of applies
+  void RequireCSR(const std::string &caller) const {
+    if (!has_csr()) {
+      std::cout << caller << " needs the CSR arrays of an edgeset that is only traversed compressed" << std::endl;
+      std::exit(-1);
+    }
+  }
+
+  template <class Code>
+  typename CompressedAdjacency<NodeID_, DestID_>::template Neighborhood<Code>
+  compressed_out_neigh(NodeID_ n) const {
+    return compressed_out_->template neigh<Code>(n);
+  }
+
+  template <class Code>
+  typename CompressedAdjacency<NodeID_, DestID_>::template Neighborhood<Code>
+  compressed_in_neigh(NodeID_ n) const {
+    static_assert(MakeInverse, "Graph inversion disabled but reading inverse");
+    return compressed_in_->template neigh<Code>(n);
+  }
+
+  bool is_relabeled() const {
+    return original_ids_shared_ != nullptr;
+  }
+
+  // id in this graph of vertex original of the input
+  NodeID_ relabeled_id(NodeID_ original) const {
+    return new_ids_shared_ == nullptr ? original : new_ids_shared_.get()[original];
+  }
+
+  // id in the input of vertex v of this graph
+  NodeID_ original_id(NodeID_ v) const {
+    return original_ids_shared_ == nullptr ? v : original_ids_shared_.get()[v];
+  }
+
+  void setVertexOrder(std::shared_ptr<NodeID_> new_ids, std::shared_ptr<NodeID_> original_ids) {
+    new_ids_shared_ = new_ids;
+    original_ids_shared_ = original_ids;
+  }
+
+  // Inserts the edges of batch, a graph over the ids of this one, an edge
+  // that is already present takes the weight of the batch.
+  // Returns the number of edges that were not present before
+  int64_t insertEdges(const CSRGraph &batch) {
+    return updateEdges(batch, true);
+  }
+
+  // Removes the edges of batch, returns the number of edges that were present
+  int64_t deleteEdges(const CSRGraph &batch) {
+    return updateEdges(batch, false);
+  }
+
+  // out and in are swapped for the transpose of a graph with edge updates
+  void setDynamicAdjacency(std::shared_ptr<DynamicAdjacency<NodeID_, DestID_>> out,
+                           std::shared_ptr<DynamicAdjacency<NodeID_, DestID_>> in) {
+    dynamic_out_ = out;
+    dynamic_in_ = in;
+    out_index_ = out->index();
+    out_end_ = out->ends();
+    in_index_ = in->index();
+    in_end_ = in->ends();
+  }
+
+  // First vertex of every segment followed by num_nodes(). Without edge_aware every segment gets the
+  // same number of vertices, with it the cuts fall where every segment gets about the same number of
+  // edges, a vertex brings the in edges it is the source of (by_source) or the out edges into it
+  std::vector<NodeID_> segmentBoundaries(int numSegments, bool edge_aware, bool by_source) const {
+    std::vector<NodeID_> boundaries(numSegments + 1, num_nodes());
+    if (!edge_aware) {
+      int64_t segmentRange = (num_nodes() + numSegments - 1) / numSegments;
+      for (int i = 0; i < numSegments; i++)
+        boundaries[i] = std::min(i * segmentRange, num_nodes());
+      return boundaries;
+    }
+    int64_t total_edges = 0;
+    #pragma omp parallel for reduction(+ : total_edges)
+    for (NodeID_ n = 0; n < num_nodes(); n++)
+      total_edges += by_source ? out_degree(n) : in_degree(n);
+    int64_t seen_edges = 0;
+    int segment = 0;
+    boundaries[0] = 0;
+    for (NodeID_ n = 0; n < num_nodes() && segment + 1 < numSegments; n++) {
+      // segment i ends once it reaches (i+1)/numSegments of the edges
+      while (segment + 1 < numSegments && seen_edges * numSegments >= (segment + 1) * total_edges)
+        boundaries[++segment] = n;
+      seen_edges += by_source ? out_degree(n) : in_degree(n);
+    }
+    return boundaries;
+  }
+
+  static int segmentOf(const std::vector<NodeID_> &boundaries, NodeID_ v) {
+    return std::upper_bound(boundaries.begin(), boundaries.end(), v) - boundaries.begin() - 1;
+  }
+
+  void buildPullSegmentedGraphs(std::string label, int numSegments, bool numa_aware=false,
+                                bool edge_aware=false) {
+    buildSegmentedGraphs(label, numSegments, numa_aware, edge_aware, true);
+  }
+
+  // Segments of the out edges for cache-blocked DensePush, segment i holds the edges whose destination
+  // falls into the i-th range of vertices, every source keeps its edges into the range in one list
+  void buildPushSegmentedGraphs(std::string label, int numSegments, bool numa_aware=false,
+                                bool edge_aware=false) {
+    buildSegmentedGraphs(label, numSegments, numa_aware, edge_aware, false);
+  }
+
+  // the segments come from the segment cache (GRAPHIT_SEGMENT_CACHE) if it has them
+  void buildSegmentedGraphs(std::string label, int numSegments, bool numa_aware, bool edge_aware, bool pull) {
     auto graphSegments = new GraphSegments<DestID_,NodeID_>(numSegments, numa_aware);
     label_to_segment[label] = graphSegments;
 
-#ifdef LOADSEG
-    cout << "loading segmented graph from " << path << endl;
-#pragma omp parallel for num_threads(numSegments)
-    for (int i = 0; i < numSegments; i++) {
-      FILE *in;
-      in = fopen((path + "/" + std::to_string(i)).c_str(), "r");
-      auto sg = graphSegments->getSegmentedGraph(i);
-      fread((void *) &sg->numVertices, sizeof(sg->numVertices), 1, in);
-      fread((void *) &sg->numEdges, sizeof(sg->numEdges), 1, in);
-      sg->allocate(i);
-      fread((void *) sg->graphId, sizeof(*sg->graphId), sg->numVertices, in);
-      fread((void *) sg->edgeArray, sizeof(*sg->edgeArray), sg->numEdges, in);
-      fread((void *) sg->vertexArray, sizeof(*sg->vertexArray), sg->numVertices + 1, in);
-      fclose(in);
+    SegmentCacheKey key = {0, num_nodes(), num_edges_directed(), numSegments, !pull, edge_aware,
+                           sizeof(DestID_)};
+    std::string cache_file = SegmentCache<DestID_,NodeID_>::FileName(key);
+    if (cache_file != "") {
+      key.graph_hash = contentHash();
+      cache_file = SegmentCache<DestID_,NodeID_>::FileName(key);
+      if (SegmentCache<DestID_,NodeID_>::Load(cache_file, key, graphSegments))
+        return;
+    }
+    fillSegments(graphSegments, segmentBoundaries(numSegments, edge_aware, pull), pull);
+    if (cache_file != "")
+      SegmentCache<DestID_,NodeID_>::Store(cache_file, key, graphSegments);
+  }
+
+  // Hash of the out neighbors of every vertex, names the graph in the segment cache
+  uint64_t contentHash() const {
+    int64_t num_blocks = std::min<int64_t>(num_nodes(), 1024);
+    int64_t block_size = num_blocks == 0 ? 0 : (num_nodes() + num_blocks - 1) / num_blocks;
+    std::vector<uint64_t> block_hashes(num_blocks);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t b = 0; b < num_blocks; b++) {
+      uint64_t hash = b;
+      NodeID_ end = std::min(num_nodes(), (b + 1) * block_size);
+      for (NodeID_ v = b * block_size; v < end; v++)
+        hash = SegmentCacheHash(reinterpret_cast<const char*>(out_index_[v]),
+                                out_degree(v) * sizeof(DestID_), hash);
+      block_hashes[b] = hash;
+    }
+    uint64_t hash = SegmentCacheMix(num_nodes(), directed_);
+    for (uint64_t block_hash : block_hashes)
+      hash = SegmentCacheMix(hash, block_hash);
+    return hash;
+  }
+
+  // Fills the segments with the in edges (pull) or the out edges of every vertex, an edge goes to the
+  // segment of its neighbor. The parallel build counts the vertices and edges every block of vertices
+  // brings to every segment, the prefix sums over the blocks give each block the place of its part of
+  // a segment, and the blocks scatter their edges independently. Both builds give the same segments
+  void fillSegments(GraphSegments<DestID_,NodeID_> *graphSegments, const std::vector<NodeID_> &boundaries,
+                    bool pull, bool parallel=true) {
+    int numSegments = graphSegments->numSegments;
+    if (!parallel) {
+      //Go through the original graph and count the number of vertices and edges for each segment
+      for (auto v : vertices()){
+        for (auto n : (pull ? in_neigh(v) : out_neigh(v))){
+          int segment_id = segmentOf(boundaries, DynamicDest<NodeID_, DestID_>::Target(n));
+          graphSegments->getSegmentedGraph(segment_id)->countEdge(v);
+        }
+      }
+
+      //Allocate each segment
+      graphSegments->allocate();
+
+      //Add the edges for each segment
+      for (auto v : vertices()){
+        for (auto n : (pull ? in_neigh(v) : out_neigh(v))){
+          int segment_id = segmentOf(boundaries, DynamicDest<NodeID_, DestID_>::Target(n));
+          graphSegments->getSegmentedGraph(segment_id)->addEdge(v, n);
+        }
+      }
+      return;
+    }
+
+    int64_t num_blocks = std::min<int64_t>(num_nodes(), 1024);
+    int64_t block_size = num_blocks == 0 ? 0 : (num_nodes() + num_blocks - 1) / num_blocks;
+    // (block, segment) entries, the counts first and then the offsets of the block within the segment
+    std::vector<int64_t> vertex_counts(num_blocks * numSegments, 0);
+    std::vector<int64_t> edge_counts(num_blocks * numSegments, 0);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t b = 0; b < num_blocks; b++) {
+      int64_t *block_vertices = &vertex_counts[b * numSegments];
+      int64_t *block_edges = &edge_counts[b * numSegments];
+      std::vector<NodeID_> last_vertex(numSegments, -1);
+      NodeID_ end = std::min(num_nodes(), (b + 1) * block_size);
+      for (NodeID_ v = b * block_size; v < end; v++) {
+        for (auto n : (pull ? in_neigh(v) : out_neigh(v))) {
+          int segment_id = segmentOf(boundaries, DynamicDest<NodeID_, DestID_>::Target(n));
+          if (last_vertex[segment_id] != v) {
+            last_vertex[segment_id] = v;
+            block_vertices[segment_id]++;
+          }
+          block_edges[segment_id]++;
+        }
+      }
     }
-    return;
-#endif
-    int segmentRange = (num_nodes() + numSegments - 1) / numSegments;
-    //Go through the original graph and count the number of target vertices and edges for each segment
-    for (auto d : vertices()){
-      for (auto s : in_neigh(d)){
-	int segment_id;
-	if (std::is_same<DestID_, NodeWeight<>>::value)
-	  segment_id = static_cast<NodeWeight<>>(s).v/segmentRange;
-	else
-	  segment_id = s/segmentRange;
-	graphSegments->getSegmentedGraph(segment_id)->countEdge(d);
+
+    #pragma omp parallel for
+    for (int i = 0; i < numSegments; i++) {
+      int64_t vertex_total = 0;
+      int64_t edge_total = 0;
+      for (int64_t b = 0; b < num_blocks; b++) {
+        int64_t block_vertices = vertex_counts[b * numSegments + i];
+        int64_t block_edges = edge_counts[b * numSegments + i];
+        vertex_counts[b * numSegments + i] = vertex_total;
+        edge_counts[b * numSegments + i] = edge_total;
+        vertex_total += block_vertices;
+        edge_total += block_edges;
       }
+      graphSegments->getSegmentedGraph(i)->numVertices = vertex_total;
+      graphSegments->getSegmentedGraph(i)->numEdges = edge_total;
     }
 
     //Allocate each segment
     graphSegments->allocate();
 
-    //Add the edges for each segment
-    for (auto d : vertices()){
-      for (auto s : in_neigh(d)){
-	int segment_id;
-	if (std::is_same<DestID_, NodeWeight<>>::value)
-	  segment_id = static_cast<NodeWeight<>>(s).v/segmentRange;
-	else
-	  segment_id = s/segmentRange;
-	graphSegments->getSegmentedGraph(segment_id)->addEdge(d, s);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t b = 0; b < num_blocks; b++) {
+      std::vector<int64_t> next_vertex(vertex_counts.begin() + b * numSegments,
+                                       vertex_counts.begin() + (b + 1) * numSegments);
+      std::vector<int64_t> next_edge(edge_counts.begin() + b * numSegments,
+                                     edge_counts.begin() + (b + 1) * numSegments);
+      std::vector<NodeID_> last_vertex(numSegments, -1);
+      NodeID_ end = std::min(num_nodes(), (b + 1) * block_size);
+      for (NodeID_ v = b * block_size; v < end; v++) {
+        for (auto n : (pull ? in_neigh(v) : out_neigh(v))) {
+          int segment_id = segmentOf(boundaries, DynamicDest<NodeID_, DestID_>::Target(n));
+          auto sg = graphSegments->getSegmentedGraph(segment_id);
+          if (last_vertex[segment_id] != v) {
+            last_vertex[segment_id] = v;
+            sg->graphId[next_vertex[segment_id]] = v;
+            sg->vertexArray[next_vertex[segment_id]++] = next_edge[segment_id];
+          }
+          sg->edgeArray[next_edge[segment_id]++] = n;
+        }
       }
     }
+  }
+
+private:
+  void ReleaseCSR() {
+    out_index_shared_.reset();
+    out_neighbors_shared_.reset();
+    in_index_shared_.reset();
+    in_neighbors_shared_.reset();
+    out_index_ = in_index_ = out_end_ = in_end_ = nullptr;
+    out_neighbors_ = in_neighbors_ = nullptr;
+  }
 
-#ifdef STORESEG
-    cout << "output serialized graph segments to " << path << endl;
-#pragma omp parallel for num_threads(numSegments)
-    for(int i = 0; i < numSegments; i++) {
-      FILE *out = fopen((path + "/" + std::to_string(i)).c_str(), "w");
-      auto sg = graphSegments->getSegmentedGraph(i);
-      fwrite((void *) &sg->numVertices, sizeof(sg->numVertices), 1, out);
-      fwrite((void *) &sg->numEdges, sizeof(sg->numEdges), 1, out);
-      fwrite((void *) sg->graphId, sizeof(*sg->graphId), sg->numVertices, out);
-      fwrite((void *) sg->edgeArray, sizeof(*sg->edgeArray), sg->numEdges, out);
-      fwrite((void *) sg->vertexArray, sizeof(*sg->vertexArray), sg->numVertices + 1, out);
-      fclose(out);
+  int64_t updateEdges(const CSRGraph &batch, bool insert) {
+    if (batch.num_nodes() > num_nodes_) {
+      std::cout << "edge batch has vertices outside of the graph" << std::endl;
+      std::exit(-1);
+    }
+    if (compressed_out_ != nullptr || !label_to_segment.empty()) {
+      std::cout << "edge updates are not supported with compressed or segmented edge layouts" << std::endl;
+      std::exit(-1);
+    }
+    if (dynamic_out_ == nullptr) {
+      auto out = std::make_shared<DynamicAdjacency<NodeID_, DestID_>>(num_nodes_, out_index_,
+                                                                     out_neighbors_shared_);
+      auto in = out;
+      if (directed_ && MakeInverse)
+        in = std::make_shared<DynamicAdjacency<NodeID_, DestID_>>(num_nodes_, in_index_,
+                                                                  in_neighbors_shared_);
+      setDynamicAdjacency(out, in);
     }
-#endif
+    int64_t edges_before = num_edges();
+    // undirected graphs keep both directions of an edge in the same lists, graphs without inverse have none
+    bool update_in = dynamic_in_ != dynamic_out_;
+    if (insert) {
+      dynamic_out_->Insert(batch.num_nodes(), batch.out_index_, batch.out_end_);
+      if (update_in)
+        dynamic_in_->Insert(batch.num_nodes(), batch.in_index_, batch.in_end_);
+    } else {
+      dynamic_out_->Delete(batch.num_nodes(), batch.out_index_, batch.out_end_);
+      if (update_in)
+        dynamic_in_->Delete(batch.num_nodes(), batch.in_index_, batch.in_end_);
+    }
+    SetUpOffsets(true);
+    out_offsets_shared_.reset();
+    out_offsets_ = nullptr;
+    return insert ? num_edges() - edges_before : edges_before - num_edges();
   }
-private:
+
   // Making private so cannot be modified from outside
   //useful for deduplication
   int* flags_;
     SGOffset * offsets_;
+  SGOffset * out_offsets_ = nullptr;
 
   bool is_transpose_;
   bool directed_;
@@ -529,9 +901,12 @@ private:
   DestID_*  out_neighbors_;
   DestID_** in_index_;
   DestID_*  in_neighbors_;
+  DestID_** out_end_;
+  DestID_** in_end_;
 public:
   std::shared_ptr<int> flags_shared_;
   std::shared_ptr<SGOffset> offsets_shared_;
+  std::shared_ptr<SGOffset> out_offsets_shared_;
 
   std::shared_ptr<DestID_*> out_index_shared_;
   std::shared_ptr<DestID_> out_neighbors_shared_;
@@ -540,6 +915,17 @@ public:
   std::shared_ptr<DestID_> in_neighbors_shared_;
 
   std::map<std::string, GraphSegments<DestID_,NodeID_>*> label_to_segment;
+
+  std::shared_ptr<CompressedAdjacency<NodeID_, DestID_>> compressed_out_;
+  std::shared_ptr<CompressedAdjacency<NodeID_, DestID_>> compressed_in_;
+
+  // vertex order applied by GraphReorder::Relabel, null when the graph keeps the ids of the input
+  std::shared_ptr<NodeID_> new_ids_shared_;
+  std::shared_ptr<NodeID_> original_ids_shared_;
+
+  // neighbor lists that took edge updates, null until the first update
+  std::shared_ptr<DynamicAdjacency<NodeID_, DestID_>> dynamic_out_;
+  std::shared_ptr<DynamicAdjacency<NodeID_, DestID_>> dynamic_in_;
  
   DestID_** get_out_index_(void) {
       return out_index_;
@@ -563,6 +949,9 @@ public:
   inline SGOffset * get_offsets_(void) {
       return offsets_;
   }
+  inline SGOffset * get_out_offsets_(void) {
+      return out_offsets_;
+  }
 };
 
 #endif  // GRAPH_H_
@@ -0,0 +1,189 @@
+#ifndef HUGE_PAGES_H_
+#define HUGE_PAGES_H_
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+
+
+/*
+GraphIt runtime
+Class:  HugePageAllocator
+
+Allocator of the large runtime arrays: CSR index and neighbor arrays built
+by BuilderBase, the reader and the relabeling, segmented subgraphs, frontier
+buffers of the FrontierPool and the property arrays of generated programs
+ - Arrays of at least one huge page (2MB) are placed on 2MB boundaries and
+   rounded up to whole huge pages, so random neighbor and property accesses
+   miss the TLB far less often
+ - GRAPHIT_HUGE_PAGES picks how the huge pages are requested:
+     madvise (default)  transparent huge pages, madvise(MADV_HUGEPAGE)
+     hugetlb            mmap(MAP_HUGETLB) from the reserved huge page pool,
+                        falls back to madvise when the pool is exhausted
+     off                plain malloc
+ - Smaller arrays come from malloc, all arrays are released with Free
+ - GRAPHIT_HUGE_PAGE_REPORT prints, at exit and to stderr, every array still
+   allocated with how much of it is actually backed by huge pages
+   (AnonHugePages of /proc/self/smaps for madvise, all of it for hugetlb)
+*/
+
+
+class HugePageAllocator {
+ public:
+  static const size_t kHugePageSize = 2 * 1024 * 1024;
+
+  // uninitialized array of n elements of T
+  template <typename T>
+  static T* Allocate(size_t n) {
+    return static_cast<T*>(Get().AllocateBytes(n * sizeof(T)));
+  }
+
+  // releases an array from Allocate, accepts nullptr
+  static void Free(void *array) {
+    if (array != nullptr)
+      Get().FreeBytes(array);
+  }
+
+  // deleter for the shared_ptrs that own arrays from Allocate
+  template <typename T>
+  struct Deleter {
+    void operator()(T *array) const { Free(array); }
+  };
+
+  // bytes of the array [array, array + bytes) that are backed by huge pages
+  static size_t BackedBytes(const void *array, size_t bytes) {
+    uintptr_t begin = reinterpret_cast<uintptr_t>(array);
+    uintptr_t end = begin + bytes;
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    uintptr_t vma_begin = 0, vma_end = 0;
+    size_t backed = 0;
+    while (std::getline(smaps, line)) {
+      unsigned long long from, to;
+      size_t kb;
+      if (sscanf(line.c_str(), "%llx-%llx ", &from, &to) == 2) {
+        vma_begin = from;
+        vma_end = to;
+      } else if (sscanf(line.c_str(), "AnonHugePages: %zu kB", &kb) == 1) {
+        // a mapping may hold several arrays, the array gets at most its overlap
+        uintptr_t overlap_begin = std::max(begin, vma_begin);
+        uintptr_t overlap_end = std::min(end, vma_end);
+        if (overlap_begin < overlap_end)
+          backed += std::min(kb * 1024, (size_t) (overlap_end - overlap_begin));
+      }
+    }
+    return backed;
+  }
+
+  // lists the live arrays of at least one huge page and how much of them huge pages back
+  static void Report(std::ostream &out) {
+    HugePageAllocator &allocator = Get();
+    std::lock_guard<std::mutex> guard(allocator.lock_);
+    size_t total = 0, total_backed = 0;
+    for (auto &block : allocator.blocks_) {
+      size_t backed = block.second.method == kHugeTLB ? block.second.bytes
+                                                       : BackedBytes(block.first, block.second.bytes);
+      out << "huge pages: " << block.first << " " << (block.second.bytes >> 20) << " MB "
+          << MethodName(block.second.method) << ", " << (backed >> 20) << " MB backed" << std::endl;
+      total += block.second.bytes;
+      total_backed += backed;
+    }
+    out << "huge pages: " << (total_backed >> 20) << " of " << (total >> 20) << " MB backed" << std::endl;
+  }
+
+ private:
+  enum Method { kMalloc, kMadvise, kHugeTLB };
+
+  struct Block {
+    size_t bytes;
+    Method method;
+  };
+
+  std::mutex lock_;
+  Method method_;
+  // the arrays of at least one huge page, by address
+  std::map<void*, Block> blocks_;
+
+  HugePageAllocator() {
+    const char *mode = std::getenv("GRAPHIT_HUGE_PAGES");
+    std::string name = mode == nullptr ? "madvise" : mode;
+    if (name == "off") {
+      method_ = kMalloc;
+    } else if (name == "hugetlb") {
+      method_ = kHugeTLB;
+    } else {
+      if (name != "madvise")
+        std::cerr << "unknown GRAPHIT_HUGE_PAGES " << name << ", using madvise" << std::endl;
+      method_ = kMadvise;
+    }
+    const char *report = std::getenv("GRAPHIT_HUGE_PAGE_REPORT");
+    if (report != nullptr && report[0] != '\0')
+      std::atexit([] { Report(std::cerr); });
+  }
+
+  // never destroyed, static objects (FrontierPool) free their arrays during exit
+  static HugePageAllocator& Get() {
+    static HugePageAllocator *allocator = new HugePageAllocator();
+    return *allocator;
+  }
+
+  static const char* MethodName(Method method) {
+    return method == kHugeTLB ? "hugetlb" : (method == kMadvise ? "madvise" : "malloc");
+  }
+
+  void* AllocateBytes(size_t bytes) {
+    if (method_ == kMalloc || bytes < kHugePageSize)
+      return std::malloc(bytes == 0 ? 1 : bytes);
+    size_t rounded = (bytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    void *array = nullptr;
+    Method method = method_;
+#ifdef MAP_HUGETLB
+    if (method == kHugeTLB) {
+      array = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (array == MAP_FAILED)
+        array = nullptr;
+    }
+#endif
+    if (array == nullptr) {
+      method = kMadvise;
+      if (posix_memalign(&array, kHugePageSize, rounded) != 0) {
+        std::cerr << "Couldn't allocate " << bytes << " bytes" << std::endl;
+        std::exit(-1);
+      }
+#ifdef MADV_HUGEPAGE
+      madvise(array, rounded, MADV_HUGEPAGE);
+#endif
+    }
+    std::lock_guard<std::mutex> guard(lock_);
+    blocks_[array] = {rounded, method};
+    return array;
+  }
+
+  void FreeBytes(void *array) {
+    Block block = {0, kMalloc};
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      auto it = blocks_.find(array);
+      if (it != blocks_.end()) {
+        block = it->second;
+        blocks_.erase(it);
+      }
+    }
+    if (block.method == kHugeTLB)
+      munmap(array, block.bytes);
+    else
+      std::free(array);
+  }
+};
+
+#endif  // HUGE_PAGES_H_
@@ -0,0 +1,128 @@
+// See LICENSE.txt for license details
+
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+
+/*
+GraphIt runtime
+Class:  MappedFile
+
+Read-only memory mapping of a whole file
+ - Pages are shared with the page cache, so several processes mapping the
+   same graph only pay for it once
+ - kMapPopulate prefaults the whole file at map time (MAP_POPULATE), which
+   moves the page faults out of the first traversal
+ - kMapHugePageAlign places the mapping on a 2MB boundary and asks for
+   transparent huge pages (only honored by file systems that support them)
+ - The mapping is released when the object is destroyed; users that hand
+   out pointers into the mapping should keep it alive with a shared_ptr
+*/
+
+
+class MappedFile {
+ public:
+  static const int kMapPopulate = 1;
+  static const int kMapHugePageAlign = 2;
+  static const size_t kHugePageSize = 2 * 1024 * 1024;
+
+  MappedFile(const std::string &filename, int flags = 0)
+      : filename_(filename), data_(nullptr), size_(0), reserved_(nullptr),
+        reserved_size_(0) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      std::cout << "Couldn't open file " << filename << std::endl;
+      std::exit(-6);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      std::cout << "Couldn't stat file " << filename << std::endl;
+      close(fd);
+      std::exit(-6);
+    }
+    size_ = st.st_size;
+    if (size_ == 0) {
+      // nothing to map, data() stays null
+      close(fd);
+      return;
+    }
+
+    int map_flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (flags & kMapPopulate)
+      map_flags |= MAP_POPULATE;
+#endif
+
+    void *hint = nullptr;
+    if (flags & kMapHugePageAlign) {
+      // reserve an oversized window and map the file over its aligned part
+      reserved_size_ = size_ + kHugePageSize;
+      reserved_ = mmap(nullptr, reserved_size_, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      if (reserved_ == MAP_FAILED) {
+        reserved_ = nullptr;
+        reserved_size_ = 0;
+      } else {
+        uintptr_t base = reinterpret_cast<uintptr_t>(reserved_);
+        hint = reinterpret_cast<void*>(
+            (base + kHugePageSize - 1) & ~(kHugePageSize - 1));
+        map_flags |= MAP_FIXED;
+      }
+    }
+
+    void *addr = mmap(hint, size_, PROT_READ, map_flags, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+      std::cout << "Couldn't map file " << filename << std::endl;
+      std::exit(-6);
+    }
+    data_ = static_cast<char*>(addr);
+
+#ifdef MADV_HUGEPAGE
+    if (flags & kMapHugePageAlign)
+      madvise(data_, size_, MADV_HUGEPAGE);
+#endif
+    if (!(flags & kMapPopulate))
+      madvise(data_, size_, MADV_WILLNEED);
+  }
+
+  ~MappedFile() {
+    if (reserved_ != nullptr) {
+      // the file mapping sits inside the reservation, one call drops both
+      munmap(reserved_, reserved_size_);
+    } else if (data_ != nullptr) {
+      munmap(data_, size_);
+    }
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+  const std::string& filename() const { return filename_; }
+
+  // true if [offset, offset + bytes) lies inside the file
+  bool contains(size_t offset, size_t bytes) const {
+    return offset <= size_ && bytes <= size_ - offset;
+  }
+
+ private:
+  std::string filename_;
+  char *data_;
+  size_t size_;
+  void *reserved_;
+  size_t reserved_size_;
+};
+
+#endif  // MAPPED_FILE_H_
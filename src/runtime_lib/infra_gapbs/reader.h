@@ -9,8 +9,13 @@
 #include <sstream>
 #include <string>
 #include <cassert>
+#include <cmath>
+#include <cstring>
+#include <memory>
 #include <type_traits>
 
+#include "huge_pages.h"
+#include "mapped_file.h"
 #include "pvector.h"
 #include "util.h"
 
@@ -26,9 +31,24 @@ Given filename, returns an edgelist or the entire graph (if serialized)
  - If the input graph is serialized (.sg or .wsg), reads the graph
    directly into the returned graph instance
  - Otherwise, reads the file and returns an edgelist
+ - Text edge lists (.el, .wel, .mtx) are parsed in parallel by ParseEL,
+   ParseWEL and ParseMTX, the ReadIn* stream readers are kept as reference
+ - MapSerializedGraph() maps a serialized graph instead of reading it, the
+   hints passed to the mapping can be picked at compile time with
+   -DMMAP_POPULATE and -DMMAP_HUGEPAGE
 */
 
 
+static const int kDefaultMapFlags = 0
+#ifdef MMAP_POPULATE
+    | MappedFile::kMapPopulate
+#endif
+#ifdef MMAP_HUGEPAGE
+    | MappedFile::kMapHugePageAlign
+#endif
+    ;
+
+
 template <typename NodeID_, typename DestID_ = NodeID_,
           typename WeightT_ = NodeID_, bool invert = true>
 class Reader {
@@ -277,6 +297,254 @@ class Reader {
     return el;
   }
 
+  // Parallel parsing of the text formats (.el, .wel and .mtx). The file is
+  // mapped and cut into chunks at whitespace, a token belongs to the chunk it
+  // starts in and a record (tokens_per_record consecutive tokens) is parsed
+  // by the chunk that owns its first token. Counting the tokens of every
+  // chunk first gives each record its slot in the pre-sized edgelist, so the
+  // result is the same as reading the tokens in order with operator>>.
+  static bool IsSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+           c == '\f';
+  }
+
+  static const char* SkipSpace(const char *p, const char *end) {
+    while (p < end && IsSpace(*p))
+      p++;
+    return p;
+  }
+
+  // Integers stop at the first non-digit like operator>> does, the rest of
+  // the token (e.g. the fraction of a real weight) is skipped
+  template <typename T_>
+  static T_ ParseNumber(const char *&p, const char *end, std::true_type) {
+    p = SkipSpace(p, end);
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+      negative = *p == '-';
+      p++;
+    }
+    int64_t value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+      value = value * 10 + (*p - '0');
+      p++;
+    }
+    while (p < end && !IsSpace(*p))
+      p++;
+    return static_cast<T_>(negative ? -value : value);
+  }
+
+  template <typename T_>
+  static T_ ParseNumber(const char *&p, const char *end, std::false_type) {
+    p = SkipSpace(p, end);
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+      negative = *p == '-';
+      p++;
+    }
+    double value = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+      value = value * 10 + (*p++ - '0');
+    if (p < end && *p == '.') {
+      p++;
+      double scale = 0.1;
+      while (p < end && *p >= '0' && *p <= '9') {
+        value += (*p++ - '0') * scale;
+        scale *= 0.1;
+      }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+      p++;
+      int exponent = ParseNumber<int>(p, end, std::true_type());
+      value *= std::pow(10.0, exponent);
+    }
+    while (p < end && !IsSpace(*p))
+      p++;
+    return static_cast<T_>(negative ? -value : value);
+  }
+
+  template <typename T_>
+  static T_ ParseNumber(const char *&p, const char *end) {
+    return ParseNumber<T_>(p, end, std::is_integral<T_>());
+  }
+
+  // parse_record(p, end, out) consumes one record starting at p and writes
+  // edges_per_record edges to out
+  template <typename ParseRecordFunc>
+  EdgeList ParseRecords(const char *begin, const char *end,
+                        int tokens_per_record, int edges_per_record,
+                        ParseRecordFunc parse_record) {
+    const int64_t kChunkBytes = 1 << 20;
+    int64_t num_bytes = end - begin;
+    int64_t num_chunks = std::max<int64_t>(1,
+        (num_bytes + kChunkBytes - 1) / kChunkBytes);
+    pvector<const char*> chunk_start(num_chunks + 1);
+    #pragma omp parallel for
+    for (int64_t c = 0; c < num_chunks; c++) {
+      const char *p = begin + std::min(c * kChunkBytes, num_bytes);
+      // a token crossing the nominal boundary stays with the previous chunk
+      if (c > 0)
+        while (p < end && !IsSpace(p[-1]) && !IsSpace(*p))
+          p++;
+      chunk_start[c] = p;
+    }
+    chunk_start[num_chunks] = end;
+    for (int64_t c = 1; c <= num_chunks; c++)
+      chunk_start[c] = std::max(chunk_start[c], chunk_start[c-1]);
+
+    pvector<int64_t> token_offset(num_chunks + 1);
+    #pragma omp parallel for
+    for (int64_t c = 0; c < num_chunks; c++) {
+      int64_t tokens = 0;
+      bool in_token = false;
+      for (const char *p = chunk_start[c]; p < chunk_start[c+1]; p++) {
+        bool space = IsSpace(*p);
+        tokens += !space && !in_token;
+        in_token = !space;
+      }
+      token_offset[c] = tokens;
+    }
+    int64_t total_tokens = 0;
+    for (int64_t c = 0; c <= num_chunks; c++) {
+      int64_t tokens = c < num_chunks ? token_offset[c] : 0;
+      token_offset[c] = total_tokens;
+      total_tokens += tokens;
+    }
+
+    // a trailing partial record is dropped, like a failing operator>>
+    int64_t num_records = total_tokens / tokens_per_record;
+    EdgeList el(num_records * edges_per_record);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t c = 0; c < num_chunks; c++) {
+      int64_t record = (token_offset[c] + tokens_per_record - 1) /
+                       tokens_per_record;
+      int64_t to_skip = record * tokens_per_record - token_offset[c];
+      const char *p = chunk_start[c];
+      const char *chunk_end = chunk_start[c+1];
+      for (int64_t t = 0; t < to_skip; t++) {
+        p = SkipSpace(p, chunk_end);
+        while (p < chunk_end && !IsSpace(*p))
+          p++;
+      }
+      while (record < num_records) {
+        p = SkipSpace(p, chunk_end);
+        if (p >= chunk_end)
+          break;
+        parse_record(p, end, &el[record * edges_per_record]);
+        record++;
+      }
+    }
+    return el;
+  }
+
+  EdgeList ParseEL(const MappedFile &file) {
+    const char *begin = file.data();
+    return ParseRecords(begin, begin + file.size(), 2, 1,
+        [](const char *&p, const char *end, Edge *out) {
+          NodeID_ u = ParseNumber<NodeID_>(p, end);
+          NodeID_ v = ParseNumber<NodeID_>(p, end);
+          out[0] = Edge(u, v);
+        });
+  }
+
+  EdgeList ParseWEL(const MappedFile &file) {
+    const char *begin = file.data();
+    return ParseRecords(begin, begin + file.size(), 3, 1,
+        [](const char *&p, const char *end, Edge *out) {
+          NodeID_ u = ParseNumber<NodeID_>(p, end);
+          NodeWeight<NodeID_, WeightT_> v;
+          v.v = ParseNumber<NodeID_>(p, end);
+          v.w = ParseNumber<WeightT_>(p, end);
+          out[0] = Edge(u, v);
+        });
+  }
+
+  // Header handling mirrors ReadInMTX, the entries are parsed in parallel
+  // Note: converts vertex numbering from 1..N to 0..N-1
+  // Note: weights casted to type WeightT_
+  EdgeList ParseMTX(const MappedFile &file, bool &needs_weights) {
+    const char *p = file.data();
+    const char *end = p + file.size();
+    auto next_line = [&]() {
+      const char *line = p;
+      while (p < end && *p != '\n')
+        p++;
+      std::string result(line, p);
+      if (p < end)
+        p++;
+      return result;
+    };
+    std::string start, object, format, field, symmetry;
+    std::istringstream banner(next_line());
+    banner >> start >> object >> format >> field >> symmetry;
+    if (start != "%%MatrixMarket") {
+      std::cout << ".mtx file did not start with %%MatrixMarket" << std::endl;
+      std::exit(-21);
+    }
+    if ((object != "matrix") || (format != "coordinate")) {
+      std::cout << "only allow matrix coordinate format for .mtx" << std::endl;
+      std::exit(-22);
+    }
+    if (field == "complex") {
+      std::cout << "do not support complex weights for .mtx" << std::endl;
+      std::exit(-23);
+    }
+    bool read_weights;
+    if (field == "pattern") {
+      read_weights = false;
+    } else if ((field == "real") || (field == "double") ||
+               (field == "integer")) {
+      read_weights = true;
+    } else {
+      std::cout << "unrecognized field type for .mtx" << std::endl;
+      std::exit(-24);
+    }
+    bool undirected;
+    if (symmetry == "symmetric") {
+      undirected = true;
+    } else if ((symmetry == "general") || (symmetry == "skew-symmetric")) {
+      undirected = false;
+    } else {
+      std::cout << "unsupported symmetry type for .mtx" << std::endl;
+      std::exit(-25);
+    }
+    p = SkipSpace(p, end);
+    while (p < end && *p == '%') {
+      next_line();
+      p = SkipSpace(p, end);
+    }
+    int64_t m = ParseNumber<int64_t>(p, end);
+    int64_t n = ParseNumber<int64_t>(p, end);
+    int64_t nonzeros = ParseNumber<int64_t>(p, end);
+    if (m != n) {
+      std::cout << m << " " << n << " " << nonzeros << std::endl;
+      std::cout << "matrix must be square for .mtx" << std::endl;
+      std::exit(-26);
+    }
+    needs_weights = !read_weights;
+    int edges_per_record = undirected ? 2 : 1;
+    if (read_weights) {
+      return ParseRecords(p, end, 3, edges_per_record,
+          [undirected](const char *&p, const char *end, Edge *out) {
+            NodeID_ u = ParseNumber<NodeID_>(p, end) - 1;
+            NodeWeight<NodeID_, WeightT_> v;
+            v.v = ParseNumber<NodeID_>(p, end) - 1;
+            v.w = ParseNumber<WeightT_>(p, end);
+            out[0] = Edge(u, v);
+            if (undirected)
+              out[1] = Edge(v.v, NodeWeight<NodeID_, WeightT_>(u, v.w));
+          });
+    }
+    return ParseRecords(p, end, 2, edges_per_record,
+        [undirected](const char *&p, const char *end, Edge *out) {
+          NodeID_ u = ParseNumber<NodeID_>(p, end) - 1;
+          NodeID_ v = ParseNumber<NodeID_>(p, end) - 1;
+          out[0] = Edge(u, v);
+          if (undirected)
+            out[1] = Edge(v, u);
+        });
+  }
+
   EdgeList ReadFile(bool &needs_weights) {
     Timer t;
     t.Start();
@@ -296,17 +564,17 @@ class Reader {
     }
 
     if (suffix == ".el") {
-      el = ReadInEL(file);
+      el = ParseEL(MappedFile(filename_));
     } else if (suffix == ".wel") {
       needs_weights = false;
-      el = ReadInWEL(file);
+      el = ParseWEL(MappedFile(filename_));
     } else if (suffix == ".gr") {
       needs_weights = false;
       el = ReadInGR(file);
     } else if (suffix == ".graph") {
       el = ReadInMetis(file, needs_weights);
     } else if (suffix == ".mtx") {
-      el = ReadInMTX(file, needs_weights);
+      el = ParseMTX(MappedFile(filename_), needs_weights);
     } else if (suffix == ".bin") {
       el = ReadInAstar(file);
     } else {
@@ -319,7 +587,7 @@ class Reader {
     return el;
   }
 
-  CSRGraph<NodeID_, DestID_, invert> ReadSerializedGraph() {
+  void CheckSerializedTypes() {
     bool weighted = GetSuffix() == ".wsg";
     if (!std::is_same<NodeID_, SGID>::value) {
       std::cout << "serialized graphs only allowed for 32bit" << std::endl;
@@ -337,6 +605,10 @@ class Reader {
       std::cout << ".wsg only allowed for int32_t weights" << std::endl;
       std::exit(-5);
     }
+  }
+
+  CSRGraph<NodeID_, DestID_, invert> ReadSerializedGraph() {
+    CheckSerializedTypes();
     std::ifstream file(filename_);
     if (!file.is_open()) {
       std::cout << "Couldn't open file " << filename_ << std::endl;
@@ -352,14 +624,14 @@ class Reader {
     file.read(reinterpret_cast<char*>(&num_edges), sizeof(SGOffset));
     file.read(reinterpret_cast<char*>(&num_nodes), sizeof(SGOffset));
     pvector<SGOffset> offsets(num_nodes+1);
-    neighs = new DestID_[num_edges];
+    neighs = HugePageAllocator::Allocate<DestID_>(num_edges);
     std::streamsize num_index_bytes = (num_nodes+1) * sizeof(SGOffset);
     std::streamsize num_neigh_bytes = num_edges * sizeof(DestID_);
     file.read(reinterpret_cast<char*>(offsets.data()), num_index_bytes);
     file.read(reinterpret_cast<char*>(neighs), num_neigh_bytes);
     index = CSRGraph<NodeID_, DestID_>::GenIndex(offsets, neighs);
     if (directed && invert) {
-      inv_neighs = new DestID_[num_edges];
+      inv_neighs = HugePageAllocator::Allocate<DestID_>(num_edges);
       file.read(reinterpret_cast<char*>(offsets.data()), num_index_bytes);
       file.read(reinterpret_cast<char*>(inv_neighs), num_neigh_bytes);
       inv_index = CSRGraph<NodeID_, DestID_>::GenIndex(offsets, inv_neighs);
@@ -373,6 +645,108 @@ class Reader {
     else
       return CSRGraph<NodeID_, DestID_, invert>(num_nodes, index, neighs);
   }
+
+  CSRGraph<NodeID_, DestID_, invert> MapSerializedGraph(
+      int map_flags = kDefaultMapFlags) {
+    CheckSerializedTypes();
+    Timer t;
+    t.Start();
+    std::shared_ptr<MappedFile> file =
+        std::make_shared<MappedFile>(filename_, map_flags);
+    bool directed;
+    SGOffset num_nodes, num_edges;
+    size_t pos;
+    bool mappable = file->size() >= sizeof(MappableSGHeader) &&
+        memcmp(file->data(), kMappableSGMagic, sizeof(kMappableSGMagic)) == 0;
+    if (mappable) {
+      MappableSGHeader header;
+      memcpy(&header, file->data(), sizeof(header));
+      directed = header.directed != 0;
+      num_edges = header.num_edges;
+      num_nodes = header.num_nodes;
+      pos = sizeof(header);
+    } else {
+      const size_t header_bytes = sizeof(bool) + 2 * sizeof(SGOffset);
+      if (!file->contains(0, header_bytes)) {
+        std::cout << "Truncated serialized graph " << filename_ << std::endl;
+        std::exit(-6);
+      }
+      memcpy(&directed, file->data(), sizeof(bool));
+      memcpy(&num_edges, file->data() + sizeof(bool), sizeof(SGOffset));
+      memcpy(&num_nodes, file->data() + sizeof(bool) + sizeof(SGOffset),
+             sizeof(SGOffset));
+      pos = header_bytes;
+    }
+    size_t num_index_bytes = (num_nodes+1) * sizeof(SGOffset);
+    size_t num_neigh_bytes = num_edges * sizeof(DestID_);
+    // padding between sections only exists in the mappable layout
+    size_t num_neigh_section_bytes =
+        mappable ? MappableSGPad(num_neigh_bytes) : num_neigh_bytes;
+    size_t needed = num_index_bytes + num_neigh_section_bytes;
+    if (directed)
+      needed *= 2;
+    if (num_nodes < 0 || num_edges < 0 || !file->contains(pos, needed)) {
+      std::cout << "Truncated serialized graph " << filename_ << std::endl;
+      std::exit(-6);
+    }
+
+    const char *offsets = file->data() + pos;
+    std::shared_ptr<DestID_> neighs =
+        MappedNeighbors(file, pos + num_index_bytes, num_edges);
+    std::shared_ptr<DestID_*> index =
+        MappedIndex(offsets, num_nodes, neighs.get());
+    std::shared_ptr<DestID_*> inv_index;
+    std::shared_ptr<DestID_> inv_neighs;
+    if (directed && invert) {
+      pos += num_index_bytes + num_neigh_section_bytes;
+      inv_neighs = MappedNeighbors(file, pos + num_index_bytes, num_edges);
+      inv_index = MappedIndex(file->data() + pos, num_nodes, inv_neighs.get());
+    }
+    t.Stop();
+    PrintTime("Map Time", t.Seconds());
+    if (directed)
+      return CSRGraph<NodeID_, DestID_, invert>(num_nodes, index, neighs,
+                                                inv_index, inv_neighs, false);
+    else
+      return CSRGraph<NodeID_, DestID_, invert>(num_nodes, index, neighs);
+  }
+
+ private:
+  // Neighbors are used straight from the mapping when they are suitably
+  // aligned (mappable layout), the deleter then only drops the reference to
+  // the mapping. GAPBS files store them at an odd offset, those get copied.
+  std::shared_ptr<DestID_> MappedNeighbors(std::shared_ptr<MappedFile> file,
+                                           size_t offset, SGOffset num_edges) {
+    const char *src = file->data() + offset;
+    if (reinterpret_cast<uintptr_t>(src) % alignof(DestID_) == 0) {
+      DestID_ *neighs = reinterpret_cast<DestID_*>(const_cast<char*>(src));
+      return std::shared_ptr<DestID_>(neighs, [file](DestID_*) {});
+    }
+    DestID_ *neighs = HugePageAllocator::Allocate<DestID_>(num_edges);
+    const size_t kCopyBlock = 1 << 20;
+    size_t num_bytes = num_edges * sizeof(DestID_);
+    int64_t num_blocks = (num_bytes + kCopyBlock - 1) / kCopyBlock;
+    #pragma omp parallel for
+    for (int64_t b = 0; b < num_blocks; b++) {
+      size_t start = b * kCopyBlock;
+      size_t len = std::min(kCopyBlock, num_bytes - start);
+      memcpy(reinterpret_cast<char*>(neighs) + start, src + start, len);
+    }
+    return std::shared_ptr<DestID_>(neighs, HugePageAllocator::Deleter<DestID_>());
+  }
+
+  // offsets are not necessarily aligned in the file, read them bytewise
+  std::shared_ptr<DestID_*> MappedIndex(const char *offsets,
+                                        SGOffset num_nodes, DestID_ *neighs) {
+    DestID_ **index = HugePageAllocator::Allocate<DestID_*>(num_nodes+1);
+    #pragma omp parallel for
+    for (SGOffset n=0; n < num_nodes+1; n++) {
+      SGOffset offset;
+      memcpy(&offset, offsets + n * sizeof(SGOffset), sizeof(SGOffset));
+      index[n] = neighs + offset;
+    }
+    return std::shared_ptr<DestID_*>(index, HugePageAllocator::Deleter<DestID_*>());
+  }
 };
 
 #endif  // READER_H_
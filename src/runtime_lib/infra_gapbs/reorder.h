@@ -0,0 +1,240 @@
+#ifndef REORDER_H_
+#define REORDER_H_
+
+#include <algorithm>
+#include <cinttypes>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+#include "pvector.h"
+
+
+/*
+GraphIt runtime
+Class:  GraphReorder
+
+Relabels the vertices of a CSRGraph so that vertices that are accessed
+together get nearby ids
+ - DEGREE_SORT orders the vertices by decreasing degree
+ - HUB_CLUSTER moves the vertices with more than the average degree to
+   the front and keeps the relative order within both groups, so the
+   locality already present in the input is preserved
+ - RCM is the reverse Cuthill-McKee order, a breadth first order of
+   every component (neighbors visited by increasing degree) reversed
+ - The degree of a vertex of a directed graph counts its out and in
+   edges, RCM traverses the edges in both directions
+ - Relabel rebuilds the out (and in) neighbors, weights move with their
+   edges, and records the permutation in the graph so that ids of the
+   input can be translated with relabeled_id and original_id
+*/
+
+
+enum class VertexOrder {
+  ORIGINAL,
+  DEGREE_SORT,
+  HUB_CLUSTER,
+  RCM
+};
+
+
+template <class NodeID_, class DestID_, bool MakeInverse>
+class GraphReorder {
+  typedef CSRGraph<NodeID_, DestID_, MakeInverse> GraphT;
+
+ public:
+  // new_ids[v] is the id given to vertex v
+  static pvector<NodeID_> Order(const GraphT &g, VertexOrder order) {
+    switch (order) {
+      case VertexOrder::DEGREE_SORT:
+        return DegreeSortOrder(g);
+      case VertexOrder::HUB_CLUSTER:
+        return HubClusterOrder(g);
+      case VertexOrder::RCM:
+        return RCMOrder(g);
+      default:
+        pvector<NodeID_> new_ids(g.num_nodes());
+        #pragma omp parallel for
+        for (NodeID_ n = 0; n < g.num_nodes(); n++)
+          new_ids[n] = n;
+        return new_ids;
+    }
+  }
+
+  static pvector<NodeID_> DegreeSortOrder(const GraphT &g) {
+    typedef std::pair<int64_t, NodeID_> degree_node_p;
+    pvector<degree_node_p> degree_id_pairs(g.num_nodes());
+    #pragma omp parallel for
+    for (NodeID_ n = 0; n < g.num_nodes(); n++)
+      degree_id_pairs[n] = std::make_pair(-Degree(g, n), n);
+    std::sort(degree_id_pairs.begin(), degree_id_pairs.end());
+    pvector<NodeID_> new_ids(g.num_nodes());
+    #pragma omp parallel for
+    for (NodeID_ n = 0; n < g.num_nodes(); n++)
+      new_ids[degree_id_pairs[n].second] = n;
+    return new_ids;
+  }
+
+  static pvector<NodeID_> HubClusterOrder(const GraphT &g) {
+    int64_t num_nodes = g.num_nodes();
+    int64_t total_degree = 0;
+    #pragma omp parallel for reduction(+ : total_degree)
+    for (NodeID_ n = 0; n < num_nodes; n++)
+      total_degree += Degree(g, n);
+    int64_t num_hubs = 0;
+    #pragma omp parallel for reduction(+ : num_hubs)
+    for (NodeID_ n = 0; n < num_nodes; n++)
+      num_hubs += Degree(g, n) * num_nodes > total_degree;
+    pvector<NodeID_> new_ids(num_nodes);
+    NodeID_ next_hub = 0;
+    NodeID_ next_other = num_hubs;
+    for (NodeID_ n = 0; n < num_nodes; n++) {
+      if (Degree(g, n) * num_nodes > total_degree)
+        new_ids[n] = next_hub++;
+      else
+        new_ids[n] = next_other++;
+    }
+    return new_ids;
+  }
+
+  static pvector<NodeID_> RCMOrder(const GraphT &g) {
+    int64_t num_nodes = g.num_nodes();
+    // every component starts from its unvisited vertex of lowest degree
+    pvector<std::pair<int64_t, NodeID_>> by_degree(num_nodes);
+    #pragma omp parallel for
+    for (NodeID_ n = 0; n < num_nodes; n++)
+      by_degree[n] = std::make_pair(Degree(g, n), n);
+    std::sort(by_degree.begin(), by_degree.end());
+    pvector<NodeID_> order(num_nodes);
+    std::vector<bool> visited(num_nodes, false);
+    std::vector<std::pair<int64_t, NodeID_>> neighbors;
+    int64_t head = 0;
+    int64_t tail = 0;
+    for (int64_t i = 0; i < num_nodes; i++) {
+      NodeID_ start = by_degree[i].second;
+      if (visited[start])
+        continue;
+      visited[start] = true;
+      order[tail++] = start;
+      while (head < tail) {
+        NodeID_ u = order[head++];
+        neighbors.clear();
+        for (DestID_ d : g.out_neigh(u))
+          neighbors.push_back(std::make_pair(Degree(g, Target(d)), Target(d)));
+        if (g.directed()) {
+          for (DestID_ d : g.in_neigh(u))
+            neighbors.push_back(std::make_pair(Degree(g, Target(d)), Target(d)));
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+        for (auto &neighbor : neighbors) {
+          if (!visited[neighbor.second]) {
+            visited[neighbor.second] = true;
+            order[tail++] = neighbor.second;
+          }
+        }
+      }
+    }
+    pvector<NodeID_> new_ids(num_nodes);
+    #pragma omp parallel for
+    for (NodeID_ n = 0; n < num_nodes; n++)
+      new_ids[order[n]] = num_nodes - 1 - n;
+    return new_ids;
+  }
+
+  // Rebuilds g with vertex v renamed to new_ids[v], the neighbors of every vertex stay sorted
+  static GraphT Relabel(const GraphT &g, const pvector<NodeID_> &new_ids) {
+    int64_t num_nodes = g.num_nodes();
+    std::shared_ptr<NodeID_> relabeled(new NodeID_[num_nodes], std::default_delete<NodeID_[]>());
+    std::shared_ptr<NodeID_> original(new NodeID_[num_nodes], std::default_delete<NodeID_[]>());
+    // compose with the order g already has, ids stay relative to the input
+    #pragma omp parallel for
+    for (NodeID_ n = 0; n < num_nodes; n++) {
+      relabeled.get()[n] = new_ids[g.relabeled_id(n)];
+      original.get()[new_ids[n]] = g.original_id(n);
+    }
+    DestID_ *out_neighs;
+    DestID_ **out_index = RelabelNeighbors(g, new_ids, false, out_neighs);
+    if (g.directed()) {
+      DestID_ *in_neighs;
+      DestID_ **in_index = RelabelNeighbors(g, new_ids, true, in_neighs);
+      GraphT relabeled_graph(num_nodes, out_index, out_neighs, in_index, in_neighs);
+      relabeled_graph.setVertexOrder(relabeled, original);
+      return relabeled_graph;
+    }
+    GraphT relabeled_graph(num_nodes, out_index, out_neighs);
+    relabeled_graph.setVertexOrder(relabeled, original);
+    return relabeled_graph;
+  }
+
+  // Out edges of g with vertex v renamed to new_ids[v], new_ids may cover more vertices than g
+  static pvector<EdgePair<NodeID_, DestID_>> RenameEdges(const GraphT &g, const pvector<NodeID_> &new_ids) {
+    pvector<SGOffset> offsets = g.VertexOffsets();
+    pvector<EdgePair<NodeID_, DestID_>> edges(offsets[g.num_nodes()]);
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (NodeID_ u = 0; u < g.num_nodes(); u++) {
+      SGOffset pos = offsets[u];
+      for (DestID_ d : g.out_neigh(u))
+        edges[pos++] = EdgePair<NodeID_, DestID_>(new_ids[u], Rename(d, new_ids));
+    }
+    return edges;
+  }
+
+ private:
+  static int64_t Degree(const GraphT &g, NodeID_ n) {
+    return g.directed() ? g.out_degree(n) + g.in_degree(n) : g.out_degree(n);
+  }
+
+  static NodeID_ Target(NodeID_ d) {
+    return d;
+  }
+
+  template <class WeightT_>
+  static NodeID_ Target(const NodeWeight<NodeID_, WeightT_> &d) {
+    return d.v;
+  }
+
+  static NodeID_ Rename(NodeID_ d, const pvector<NodeID_> &new_ids) {
+    return new_ids[d];
+  }
+
+  template <class WeightT_>
+  static NodeWeight<NodeID_, WeightT_> Rename(NodeWeight<NodeID_, WeightT_> d,
+                                              const pvector<NodeID_> &new_ids) {
+    d.v = new_ids[d.v];
+    return d;
+  }
+
+  static DestID_** RelabelNeighbors(const GraphT &g, const pvector<NodeID_> &new_ids,
+                                    bool in_graph, DestID_* &neighs) {
+    int64_t num_nodes = g.num_nodes();
+    pvector<SGOffset> offsets(num_nodes + 1);
+    #pragma omp parallel for
+    for (NodeID_ n = 0; n < num_nodes; n++)
+      offsets[new_ids[n]] = in_graph ? g.in_degree(n) : g.out_degree(n);
+    SGOffset total = 0;
+    for (int64_t n = 0; n < num_nodes; n++) {
+      SGOffset degree = offsets[n];
+      offsets[n] = total;
+      total += degree;
+    }
+    offsets[num_nodes] = total;
+    neighs = HugePageAllocator::Allocate<DestID_>(total);
+    DestID_ **index = GraphT::GenIndex(offsets, neighs);
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (NodeID_ u = 0; u < num_nodes; u++) {
+      DestID_ *out = index[new_ids[u]];
+      if (in_graph) {
+        for (DestID_ d : g.in_neigh(u))
+          *out++ = Rename(d, new_ids);
+      } else {
+        for (DestID_ d : g.out_neigh(u))
+          *out++ = Rename(d, new_ids);
+      }
+      std::sort(index[new_ids[u]], index[new_ids[u] + 1]);
+    }
+    return index;
+  }
+};
+
+#endif  // REORDER_H_
@@ -0,0 +1,242 @@
+#ifndef SEGMENT_CACHE_H_
+#define SEGMENT_CACHE_H_
+
+#include <stdio.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "mapped_file.h"
+#include "segmentgraph.h"
+
+
+/*
+GraphIt runtime
+Class:  SegmentCache
+
+On-disk cache of the segmented subgraphs built by buildPullSegmentedGraphs
+and buildPushSegmentedGraphs
+ - Enabled by pointing GRAPHIT_SEGMENT_CACHE at a directory, the first build
+   of a configuration writes its file there, later runs map it instead of
+   segmenting the graph again
+ - A file is keyed by a hash of the graph, the segment count, the direction
+   (pull or push), the partitioning (fixed or edge aware) and the size of
+   the edge entries (weighted or not), all of which are part of its name and
+   repeated in its header
+ - The header starts with a versioned magic and holds a checksum of the
+   segments, files that do not match their key or checksum are ignored and
+   rewritten
+ - Segments are stored back to back (vertex and edge counts, graphId,
+   vertexArray, edgeArray) with every section padded to 8 bytes, so they are
+   used in place from the mapping; NUMA aware segments are copied to their
+   sockets instead
+ - Files are written to a temporary name and renamed, concurrent jobs never
+   see a partial file
+*/
+
+
+static const char kSegmentCacheMagic[8] = {'G', 'R', 'I', 'T', 'S', 'C', '0', '1'};
+
+struct SegmentCacheKey {
+  uint64_t graph_hash;
+  int64_t num_nodes;
+  int64_t num_edges;
+  int64_t num_segments;
+  // 1 if the segments partition the out edges by destination
+  int64_t push;
+  int64_t edge_aware;
+  // size of an edge entry, tells weighted and unweighted graphs apart
+  int64_t dest_bytes;
+};
+
+struct SegmentCacheHeader {
+  char magic[8];
+  SegmentCacheKey key;
+  uint64_t checksum;
+};
+
+
+static inline uint64_t SegmentCacheMix(uint64_t hash, uint64_t word) {
+  hash ^= word + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  return hash * 0xff51afd7ed558ccdULL;
+}
+
+static inline uint64_t SegmentCacheHash(const char *bytes, size_t size, uint64_t seed) {
+  uint64_t hash = SegmentCacheMix(seed, size);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(word));
+    hash = SegmentCacheMix(hash, word);
+  }
+  uint64_t tail = 0;
+  memcpy(&tail, bytes + i, size - i);
+  return SegmentCacheMix(hash, tail);
+}
+
+
+template <class DataT, class Vertex>
+class SegmentCache {
+  typedef SegmentedGraph<DataT, Vertex> SegmentT;
+
+ public:
+  // empty if GRAPHIT_SEGMENT_CACHE is not set
+  static std::string FileName(const SegmentCacheKey &key) {
+    const char *dir = std::getenv("GRAPHIT_SEGMENT_CACHE");
+    if (dir == nullptr || dir[0] == '\0')
+      return "";
+    char name[160];
+    snprintf(name, sizeof(name), "/%016" PRIx64 "_%s_%s_%" PRId64 "_%" PRId64 ".seg",
+             key.graph_hash, key.push ? "push" : "pull", key.edge_aware ? "edge" : "vertex",
+             key.num_segments, key.dest_bytes);
+    return std::string(dir) + name;
+  }
+
+  // fills the (not yet allocated) segments from the file, false if there is no usable file
+  static bool Load(const std::string &file_name, const SegmentCacheKey &key,
+                   GraphSegments<DataT, Vertex> *graphSegments) {
+    std::ifstream probe(file_name);
+    if (!probe.good())
+      return false;
+    probe.close();
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(file_name);
+    SegmentCacheHeader header;
+    if (!file->contains(0, sizeof(header)))
+      return Ignore(file_name, "truncated header");
+    memcpy(&header, file->data(), sizeof(header));
+    if (memcmp(header.magic, kSegmentCacheMagic, sizeof(kSegmentCacheMagic)) != 0)
+      return Ignore(file_name, "unknown format");
+    if (memcmp(&header.key, &key, sizeof(key)) != 0)
+      return Ignore(file_name, "built for a different graph or schedule");
+
+    // find the sections of every segment before touching the segments
+    std::vector<Sections> segments(key.num_segments);
+    size_t pos = sizeof(header);
+    for (int64_t i = 0; i < key.num_segments; i++) {
+      int64_t counts[2];
+      if (!file->contains(pos, sizeof(counts)))
+        return Ignore(file_name, "truncated segments");
+      memcpy(counts, file->data() + pos, sizeof(counts));
+      if (counts[0] < 0 || counts[1] < 0 || !file->contains(pos, SegmentBytes(counts[0], counts[1])))
+        return Ignore(file_name, "truncated segments");
+      const char *section = file->data() + pos + sizeof(counts);
+      segments[i].numVertices = counts[0];
+      segments[i].numEdges = counts[1];
+      segments[i].graphId = reinterpret_cast<int*>(const_cast<char*>(section));
+      section += Pad(counts[0] * sizeof(int));
+      segments[i].vertexArray = reinterpret_cast<int64_t*>(const_cast<char*>(section));
+      section += Pad((counts[0] + 1) * sizeof(int64_t));
+      segments[i].edgeArray = reinterpret_cast<DataT*>(const_cast<char*>(section));
+      pos += SegmentBytes(counts[0], counts[1]);
+    }
+    if (Checksum(segments) != header.checksum)
+      return Ignore(file_name, "checksum mismatch");
+
+    #pragma omp parallel for
+    for (int64_t i = 0; i < key.num_segments; i++) {
+      SegmentT *sg = graphSegments->getSegmentedGraph(i);
+      const Sections &cached = segments[i];
+      sg->numVertices = cached.numVertices;
+      sg->numEdges = cached.numEdges;
+      if (sg->numa_aware) {
+        // the segments have to live on their sockets, the mapping does not
+        sg->allocate(i);
+        std::copy(cached.graphId, cached.graphId + cached.numVertices, sg->graphId);
+        std::copy(cached.vertexArray, cached.vertexArray + cached.numVertices + 1, sg->vertexArray);
+        std::copy(cached.edgeArray, cached.edgeArray + cached.numEdges, sg->edgeArray);
+      } else {
+        sg->useMapping(file, cached.graphId, cached.vertexArray, cached.edgeArray);
+      }
+    }
+    return true;
+  }
+
+  // writes the built segments, a failure only costs the cache
+  static void Store(const std::string &file_name, const SegmentCacheKey &key,
+                    GraphSegments<DataT, Vertex> *graphSegments) {
+    std::vector<Sections> segments(key.num_segments);
+    for (int64_t i = 0; i < key.num_segments; i++) {
+      SegmentT *sg = graphSegments->getSegmentedGraph(i);
+      segments[i] = {sg->numVertices, sg->numEdges, sg->graphId, sg->vertexArray, sg->edgeArray};
+    }
+    SegmentCacheHeader header;
+    memcpy(header.magic, kSegmentCacheMagic, sizeof(kSegmentCacheMagic));
+    header.key = key;
+    header.checksum = Checksum(segments);
+
+    std::string temp_name = file_name + ".tmp" + std::to_string(getpid());
+    std::ofstream out(temp_name, std::ios::out | std::ios::binary);
+    out.write(reinterpret_cast<char*>(&header), sizeof(header));
+    for (const Sections &segment : segments) {
+      out.write(reinterpret_cast<const char*>(&segment.numVertices), sizeof(int64_t));
+      out.write(reinterpret_cast<const char*>(&segment.numEdges), sizeof(int64_t));
+      WritePadded(out, segment.graphId, segment.numVertices * sizeof(int));
+      WritePadded(out, segment.vertexArray, (segment.numVertices + 1) * sizeof(int64_t));
+      WritePadded(out, segment.edgeArray, segment.numEdges * sizeof(DataT));
+    }
+    out.close();
+    if (!out || rename(temp_name.c_str(), file_name.c_str()) != 0) {
+      std::cerr << "Couldn't write segment cache " << file_name << std::endl;
+      remove(temp_name.c_str());
+    }
+  }
+
+ private:
+  struct Sections {
+    int64_t numVertices;
+    int64_t numEdges;
+    int *graphId;
+    int64_t *vertexArray;
+    DataT *edgeArray;
+  };
+
+  static size_t Pad(size_t bytes) {
+    return (bytes + 7) & ~size_t(7);
+  }
+
+  static size_t SegmentBytes(int64_t num_vertices, int64_t num_edges) {
+    return 2 * sizeof(int64_t) + Pad(num_vertices * sizeof(int))
+        + Pad((num_vertices + 1) * sizeof(int64_t)) + Pad(num_edges * sizeof(DataT));
+  }
+
+  static void WritePadded(std::ofstream &out, const void *data, size_t bytes) {
+    const char padding[8] = {0};
+    out.write(static_cast<const char*>(data), bytes);
+    out.write(padding, Pad(bytes) - bytes);
+  }
+
+  // hashes the segments in parallel and combines them in order
+  static uint64_t Checksum(const std::vector<Sections> &segments) {
+    int64_t num_segments = segments.size();
+    std::vector<uint64_t> hashes(num_segments);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t i = 0; i < num_segments; i++) {
+      const Sections &segment = segments[i];
+      uint64_t hash = SegmentCacheMix(SegmentCacheMix(i, segment.numVertices), segment.numEdges);
+      hash = SegmentCacheHash(reinterpret_cast<const char*>(segment.graphId),
+                              segment.numVertices * sizeof(int), hash);
+      hash = SegmentCacheHash(reinterpret_cast<const char*>(segment.vertexArray),
+                              (segment.numVertices + 1) * sizeof(int64_t), hash);
+      hashes[i] = SegmentCacheHash(reinterpret_cast<const char*>(segment.edgeArray),
+                                   segment.numEdges * sizeof(DataT), hash);
+    }
+    uint64_t checksum = num_segments;
+    for (uint64_t hash : hashes)
+      checksum = SegmentCacheMix(checksum, hash);
+    return checksum;
+  }
+
+  static bool Ignore(const std::string &file_name, const char *reason) {
+    std::cerr << "ignoring segment cache " << file_name << ": " << reason << std::endl;
+    return false;
+  }
+};
+
+#endif  // SEGMENT_CACHE_H_
@@ -1,6 +1,11 @@
+#ifndef SEGMENT_GRAPH_H_
+#define SEGMENT_GRAPH_H_
+
 #include <math.h>
 #include <vector>
 #include <assert.h>
+#include <memory>
+#include "huge_pages.h"
 #ifdef NUMA
 #include <omp.h>
 #include <numa.h>
@@ -23,6 +28,8 @@ private:
   int64_t lastLocalIndex;
   Vertex lastVertex;
   int64_t lastEdgeIndex;
+  // keeps the file alive while the arrays point into its mapping (segment cache)
+  std::shared_ptr<const void> mapping;
 
 public:
   SegmentedGraph(bool numa_aware_) : numa_aware(numa_aware_)
@@ -37,6 +44,8 @@ public:
 
   ~SegmentedGraph()
   {
+    if (mapping != nullptr)
+      return;
 #ifdef NUMA
     if (numa_aware) {
       numa_free(graphId, sizeof(int) * numVertices);
@@ -45,9 +54,9 @@ public:
       return;
     }
 #endif
-    delete[] graphId;
-    delete[] edgeArray;
-    delete[] vertexArray;
+    HugePageAllocator::Free(graphId);
+    HugePageAllocator::Free(edgeArray);
+    HugePageAllocator::Free(vertexArray);
   }
 
 
@@ -65,14 +74,24 @@ public:
       return;
     }
 #endif
-    vertexArray = new int64_t[numVertices + 1]; // start,end of last              
-    edgeArray = new DataT[numEdges];
-    graphId = new int[numVertices];
+    vertexArray = HugePageAllocator::Allocate<int64_t>(numVertices + 1); // start,end of last
+    edgeArray = HugePageAllocator::Allocate<DataT>(numEdges);
+    graphId = HugePageAllocator::Allocate<int>(numVertices);
     vertexArray[numVertices] = numEdges;
     allocated = true;
     lastVertex = -1; // reset lastVertex which is used to point to the dst vertex of the last edge added
   }
 
+  // use arrays that live in a mapped file instead of allocating them
+  void useMapping(std::shared_ptr<const void> file, int *graphId_, int64_t *vertexArray_, DataT *edgeArray_)
+  {
+    mapping = file;
+    graphId = graphId_;
+    vertexArray = vertexArray_;
+    edgeArray = edgeArray_;
+    allocated = true;
+  }
+
   /**
    * Count how many edges we need.
    * @v: dst vertex in pull direction and src vertex in push direction
@@ -160,3 +179,5 @@ GraphSegments(int _numSegments, bool numa_aware): numSegments(_numSegments)
     return segments[id];
   }
 };
+
+#endif  // SEGMENT_GRAPH_H_
@@ -5,6 +5,7 @@
 #define WRITER_H_
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -36,7 +37,9 @@ class WriterBase {
     }
   }
 
-  void WriteSerializedGraph(std::fstream &out) {
+  // aligned = true writes the mappable layout (MappableSGHeader followed by
+  // 8 byte aligned sections) so the reader can use the neighbors in place
+  void WriteSerializedGraph(std::fstream &out, bool aligned = false) {
     if (!std::is_same<NodeID_, SGID>::value) {
       std::cout << "serialized graphs only allowed for 32b IDs" << std::endl;
       std::exit(-4);
@@ -55,20 +58,35 @@ class WriterBase {
       neigh_bytes = edges_to_write * sizeof(SGID);
     else
       neigh_bytes = edges_to_write * sizeof(NodeWeight<NodeID_, SGID>);
-    out.write(reinterpret_cast<char*>(&directed), sizeof(bool));
-    out.write(reinterpret_cast<char*>(&edges_to_write), sizeof(SGOffset));
-    out.write(reinterpret_cast<char*>(&num_nodes), sizeof(SGOffset));
+    const char padding[8] = {0};
+    std::streamsize pad_bytes =
+        aligned ? MappableSGPad(neigh_bytes) - neigh_bytes : 0;
+    if (aligned) {
+      MappableSGHeader header;
+      memcpy(header.magic, kMappableSGMagic, sizeof(kMappableSGMagic));
+      header.directed = directed;
+      header.num_edges = edges_to_write;
+      header.num_nodes = num_nodes;
+      out.write(reinterpret_cast<char*>(&header), sizeof(header));
+    } else {
+      out.write(reinterpret_cast<char*>(&directed), sizeof(bool));
+      out.write(reinterpret_cast<char*>(&edges_to_write), sizeof(SGOffset));
+      out.write(reinterpret_cast<char*>(&num_nodes), sizeof(SGOffset));
+    }
     pvector<SGOffset> offsets = g_.VertexOffsets(false);
     out.write(reinterpret_cast<char*>(offsets.data()), index_bytes);
     out.write(reinterpret_cast<char*>(g_.out_neigh(0).begin()), neigh_bytes);
+    out.write(padding, pad_bytes);
     if (directed) {
       offsets = g_.VertexOffsets(true);
       out.write(reinterpret_cast<char*>(offsets.data()), index_bytes);
       out.write(reinterpret_cast<char*>(g_.in_neigh(0).begin()), neigh_bytes);
+      out.write(padding, pad_bytes);
     }
   }
 
-  void WriteGraph(std::string filename, bool serialized = false) {
+  void WriteGraph(std::string filename, bool serialized = false,
+                  bool aligned = false) {
     if (filename == "") {
       std::cout << "No output filename given (Use -h for help)" << std::endl;
       std::exit(-8);
@@ -79,7 +97,7 @@ class WriterBase {
       std::exit(-5);
     }
     if (serialized)
-      WriteSerializedGraph(file);
+      WriteSerializedGraph(file, aligned);
     else
       WriteEL(file);
     file.close();
@@ -26,6 +26,14 @@
 #include "infra_ligra/ligra/ligra.h"
 
 #include "vertexsubset.h"
+#include "priority_queue.h"
+#include "apply_counters.h"
+#include "adaptive_direction.h"
+#include "frontier_buffer.h"
+#include "numa_placement.h"
+#include "work_stealing.h"
+#include "thread_control.h"
+#include "simd_pull.h"
 
 #include <time.h>
 #include <chrono>
@@ -85,8 +93,80 @@ static WGraph builtin_loadWeightedEdgesFromCSR(const int32_t *data, const int32_
 	CLBase cli(0, NULL);
 	BuilderBase<NodeID, WNode, WeightT> bb(cli);
 	bb.needs_weights_ = false;
-	return bb.MakeGraphFromEL(el);	
+	return bb.MakeGraphFromEL(el);
+}
+
+// relabels a loaded edgeset for schedules with a vertex order, the permutation is kept in the graph
+template <typename DestID_>
+static CSRGraph<NodeID, DestID_> builtin_relabelEdges(CSRGraph<NodeID, DestID_> &edges, VertexOrder order){
+    typedef GraphReorder<NodeID, DestID_, true> Reorder;
+    return Reorder::Relabel(edges, Reorder::Order(edges, order));
+}
+
+// translates a vertex id of the input (argv, literals) to its id in the relabeled edgeset
+template <typename GraphT>
+static NodeID builtin_relabeledVertex(GraphT &edges, NodeID vertex){
+    return edges.relabeled_id(vertex);
+}
+
+// edge updates from a batch edgeset (edges.insertBatch(batch), edges.deleteBatch(batch)),
+// the batch is loaded with the ids of the input and follows the vertex order of edges
+template <typename DestID_>
+static CSRGraph<NodeID, DestID_> batchInVertexOrderOf(CSRGraph<NodeID, DestID_> &edges, CSRGraph<NodeID, DestID_> &batch){
+    pvector<NodeID> new_ids(edges.num_nodes());
+    for (NodeID n = 0; n < edges.num_nodes(); n++)
+        new_ids[n] = edges.relabeled_id(n);
+    pvector<EdgePair<NodeID, DestID_>> el = GraphReorder<NodeID, DestID_, true>::RenameEdges(batch, new_ids);
+    CLBase cli(0, NULL);
+    BuilderBase<NodeID, DestID_, WeightT> bb(cli);
+    bb.needs_weights_ = false;
+    return bb.MakeGraphFromEL(el);
+}
+
+template <typename DestID_>
+static int64_t builtin_insertBatch(CSRGraph<NodeID, DestID_> &edges, CSRGraph<NodeID, DestID_> &batch){
+    if (edges.is_relabeled() && batch.num_nodes() <= edges.num_nodes()) {
+        CSRGraph<NodeID, DestID_> relabeled_batch = batchInVertexOrderOf(edges, batch);
+        return edges.insertEdges(relabeled_batch);
+    }
+    return edges.insertEdges(batch);
+}
+
+template <typename DestID_>
+static int64_t builtin_deleteBatch(CSRGraph<NodeID, DestID_> &edges, CSRGraph<NodeID, DestID_> &batch){
+    if (edges.is_relabeled() && batch.num_nodes() <= edges.num_nodes()) {
+        CSRGraph<NodeID, DestID_> relabeled_batch = batchInVertexOrderOf(edges, batch);
+        return edges.deleteEdges(relabeled_batch);
+    }
+    return edges.deleteEdges(batch);
+}
+
+// vertices touched by a batch (edges.getBatchVertices(batch)), the endpoints of its edges in the ids of edges,
+// seeds the frontier of an incremental recomputation after edges.insertBatch(batch) or edges.deleteBatch(batch)
+template <typename DestID_>
+static VertexSubset<int>* builtin_getBatchVertices(CSRGraph<NodeID, DestID_> &edges, CSRGraph<NodeID, DestID_> &batch){
+    int total_elements = edges.num_nodes();
+    int batch_nodes = std::min<int64_t>(batch.num_nodes(), total_elements);
+    VertexSubset<int> * output = new VertexSubset<NodeID>( total_elements, 0);
+    bool * next0 = newA(bool, total_elements);
+    parallel_for(int v = 0; v < total_elements; v++)
+        next0[v] = 0;
+    parallel_for(NodeID u = 0; u < batch_nodes; u++) {
+        if (batch.out_degree(u) == 0)
+            continue;
+        next0[edges.relabeled_id(u)] = 1;
+        for (DestID_ d : batch.out_neigh(u)) {
+            NodeID v = DynamicDest<NodeID, DestID_>::Target(d);
+            if (v < total_elements)
+                next0[edges.relabeled_id(v)] = 1;
+        }
+    }
+    output->num_vertices_ = sequence::sum(next0, total_elements);
+    output->bool_map_ = next0;
+    output->is_dense = true;
+    return output;
 }
+
 static int builtin_getVertices(Graph &edges){
     return edges.num_nodes();
 }
@@ -145,19 +225,26 @@ static VertexSubset<int>* serialSweepCut(Graph& graph,  VertexSubset<int> * vert
     //reset the size of the vertex array to the best cut, remove the boolean values
     output_vertexset->num_vertices_ = best_cut;
     output_vertexset->bool_map_ = nullptr;
+    if (output_vertexset->bitmap_ != nullptr) {
+        delete output_vertexset->bitmap_;
+        output_vertexset->bitmap_ = nullptr;
+    }
 
     return output_vertexset;
 }
 
 static int getRandomOutNgh(Graph &edges, NodeID v){
+    edges.RequireCSR("getRandomOutNgh");
     return edges.get_random_out_neigh(v);
 }
 
 static int getRandomInNgh(Graph &edges, NodeID v){
+    edges.RequireCSR("getRandomInNgh");
     return edges.get_random_in_neigh(v);
 }
 
 static int* serialMinimumSpanningTree(WGraph &edges, NodeID start){
+    edges.RequireCSR("serialMinimumSpanningTree");
     return minimum_spanning_tree(edges, start);
 }
 
@@ -217,6 +304,21 @@ static float stopTimer(){
 
 }
 
+// performance counters of labeled edgeset applies, emitted by graphitc -c
+template <typename GraphT>
+static void builtin_beginApplyCounter(std::string label, GraphT &g, VertexSubset<NodeID>* from_vertexset,
+                                      std::string direction){
+    ApplyCounters::get().begin(label, g, from_vertexset, direction);
+}
+
+static void builtin_endApplyCounter(VertexSubset<NodeID>* to_vertexset = nullptr){
+    ApplyCounters::get().end(to_vertexset);
+}
+
+static void builtin_recordApplyDirection(std::string direction){
+    ApplyCounters::get().recordDirection(direction);
+}
+
 static char* argv_safe(int index, char** argv, int argc ){
     // if index is less than or equal to argc than return argv[index]
     //else return false or break command
@@ -231,14 +333,22 @@ static char* argv_safe(int index, char** argv, int argc ){
 }
 
 static Graph builtin_transpose(Graph &graph){
+    graph.RequireCSR("transpose");
     // Changing this to use shared pointer instead
     //return CSRGraph<NodeID>(graph.num_nodes(), graph.get_in_index_(), graph.get_in_neighbors_(), graph.get_out_index_(), graph.get_out_neighbors_(), true);
-      return CSRGraph<NodeID>(graph.num_nodes(), graph.in_index_shared_, graph.in_neighbors_shared_, graph.out_index_shared_, graph.out_neighbors_shared_, true);
+      Graph transposed(graph.num_nodes(), graph.in_index_shared_, graph.in_neighbors_shared_, graph.out_index_shared_, graph.out_neighbors_shared_, true);
+      // the transpose of a graph with edge updates shares the updated lists
+      if (graph.dynamic_out_ != nullptr)
+          transposed.setDynamicAdjacency(graph.dynamic_in_, graph.dynamic_out_);
+      return transposed;
 }
 
 
 template<typename APPLY_FUNC> static void builtin_vertexset_apply(VertexSubset<int>* vertex_subset, APPLY_FUNC apply_func){
-   if (vertex_subset->is_dense){
+   if (vertex_subset->is_dense && vertex_subset->bool_map_ == nullptr){
+       // bitvector frontier
+       vertex_subset->forEachInBitmap(apply_func);
+   } else if (vertex_subset->is_dense){
        parallel_for (int v = 0; v < vertex_subset->vertices_range_; v++){
            if(vertex_subset->bool_map_[v]){
                apply_func(v);
@@ -258,10 +368,21 @@ template<typename APPLY_FUNC> static void builtin_vertexset_apply(VertexSubset<i
 }
 
 template<typename OBJECT_TYPE>
-static void deleteObject(OBJECT_TYPE* object) {
+static void deleteObject(OBJECT_TYPE* object, std::true_type) {
    if(object)
        delete object;
 }
+
+// vectors are arrays of scalars (or of fixed size arrays) from the HugePageAllocator
+template<typename OBJECT_TYPE>
+static void deleteObject(OBJECT_TYPE* object, std::false_type) {
+   HugePageAllocator::Free(object);
+}
+
+template<typename OBJECT_TYPE>
+static void deleteObject(OBJECT_TYPE* object) {
+   deleteObject(object, std::is_class<OBJECT_TYPE>());
+}
 template <typename T>
 static VertexSubset<int> * builtin_const_vertexset_filter(T func, int total_elements) {
     VertexSubset<int> * output = new VertexSubset<NodeID>( total_elements, 0);
@@ -285,7 +406,12 @@ static VertexSubset<int> * builtin_vertexset_filter(VertexSubset<int> * input, T
     bool * next0 = newA(bool, total_elements);
     parallel_for(int v = 0; v < total_elements; v++)
         next0[v] = 0;
-    if (input->is_dense) {
+    if (input->is_dense && input->bool_map_ == nullptr) {
+        input->forEachInBitmap([&](NodeID v) {
+            if (func(v))
+                next0[v] = 1;
+        });
+    } else if (input->is_dense) {
         //std::cout << "Vertex subset is dense" << std::endl;
         parallel_for(int v = 0; v < total_elements; v++) {
             if (input->bool_map_[v] && func(v))
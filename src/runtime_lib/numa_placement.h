@@ -0,0 +1,116 @@
+#ifndef GRAPHIT_NUMA_PLACEMENT_H
+#define GRAPHIT_NUMA_PLACEMENT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <unistd.h>
+#include "infra_ligra/ligra/parallel.h"
+#ifdef NUMA
+#include <omp.h>
+#include <numa.h>
+#endif
+
+
+/*
+GraphIt runtime
+Functions:  builtin_numaInterleave, builtin_numaPartition, builtin_numaMarkStale
+
+Placement of the property arrays scheduled with configVectorNUMA(vector, config),
+called right after an array is allocated and before it is initialized
+ - interleaved: the pages are spread round robin over the NUMA nodes, for
+   arrays that every thread reads at random (e.g. the source side of a pull)
+ - partitioned: the array is cut into one contiguous block of vertices per
+   place (socket), and each block lives on its place, matching the static
+   vertex partition of the parallel loops over the vertices
+ - With NUMA, the pages are bound with libnuma before they are touched;
+   without it, the pages are touched in parallel in the same pattern
+   (round robin or in static blocks), so first touch places them close to
+   the threads that use them
+ - The arrays stay allocated as before, the placement only binds their pages
+ - replicated: every socket reads its own copy, the copies are refreshed by
+   the next NUMA aware apply only after the field was written, the writes
+   mark the copies stale with builtin_numaMarkStale
+*/
+
+
+static inline int64_t builtin_numaPageSize() {
+  static const int64_t page_size = sysconf(_SC_PAGESIZE);
+  return page_size;
+}
+
+// writes zeros to the pages of [begin, end), page by page, on the threads given by the schedule
+static inline void builtin_numaTouchPages(char *begin, char *end, bool round_robin) {
+  int64_t page_size = builtin_numaPageSize();
+  int64_t num_pages = (end - begin + page_size - 1) / page_size;
+#if defined(OPENMP) || defined(NUMA)
+  if (round_robin) {
+    #pragma omp parallel for schedule(static, 1)
+    for (int64_t page = 0; page < num_pages; page++)
+      memset(begin + page * page_size, 0, std::min(page_size, (int64_t) (end - begin) - page * page_size));
+  } else {
+    #pragma omp parallel for schedule(static)
+    for (int64_t page = 0; page < num_pages; page++)
+      memset(begin + page * page_size, 0, std::min(page_size, (int64_t) (end - begin) - page * page_size));
+  }
+#else
+  (void) round_robin;
+  parallel_for (int64_t page = 0; page < num_pages; page++)
+    memset(begin + page * page_size, 0, std::min(page_size, (int64_t) (end - begin) - page * page_size));
+#endif
+}
+
+template <typename T>
+static void builtin_numaInterleave(T *array, int64_t num_elements) {
+  char *begin = reinterpret_cast<char*>(array);
+  char *end = reinterpret_cast<char*>(array + num_elements);
+#ifdef NUMA
+  // only whole pages can be bound, the partial pages at the ends stay first touch
+  int64_t page_size = builtin_numaPageSize();
+  char *first_page = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(begin) + page_size - 1) & ~(page_size - 1));
+  char *last_page = reinterpret_cast<char*>(reinterpret_cast<uintptr_t>(end) & ~(page_size - 1));
+  if (numa_available() >= 0 && first_page < last_page)
+    numa_interleave_memory(first_page, last_page - first_page, numa_all_nodes_ptr);
+#endif
+  builtin_numaTouchPages(begin, end, true);
+}
+
+template <typename T>
+static void builtin_numaPartition(T *array, int64_t num_elements) {
+  char *begin = reinterpret_cast<char*>(array);
+  char *end = reinterpret_cast<char*>(array + num_elements);
+#ifdef NUMA
+  int num_places = omp_get_num_places();
+  if (numa_available() >= 0 && num_places > 1) {
+    int64_t page_size = builtin_numaPageSize();
+    uintptr_t first_page = (reinterpret_cast<uintptr_t>(begin) + page_size - 1) & ~(page_size - 1);
+    uintptr_t last_page = reinterpret_cast<uintptr_t>(end) & ~(page_size - 1);
+    int64_t block_size = (num_elements + num_places - 1) / num_places;
+    for (int place = 0; place < num_places; place++) {
+      // the whole pages that start inside the block of the place
+      uintptr_t block_begin = reinterpret_cast<uintptr_t>(array + std::min(num_elements, place * block_size));
+      uintptr_t block_end = reinterpret_cast<uintptr_t>(array + std::min(num_elements, (place + 1) * block_size));
+      block_begin = std::max(first_page, (block_begin + page_size - 1) & ~(page_size - 1));
+      block_end = std::min(last_page, (block_end + page_size - 1) & ~(page_size - 1));
+      if (block_begin < block_end)
+        numa_tonode_memory(reinterpret_cast<void*>(block_begin), block_end - block_begin, place);
+    }
+  }
+#endif
+  builtin_numaTouchPages(begin, end, false);
+}
+
+// called after every write to a replicated field, possibly from many threads at once,
+// the flag is only stored when it changes so that its cache line stays shared
+static inline void builtin_numaMarkStale(std::atomic<bool> &stale) {
+  if (!stale.load(std::memory_order_relaxed))
+    stale.store(true, std::memory_order_relaxed);
+}
+
+// true if the copies have to be refreshed, called outside of the parallel loops
+static inline bool builtin_numaTakeStale(std::atomic<bool> &stale) {
+  return stale.exchange(false, std::memory_order_relaxed);
+}
+
+#endif //GRAPHIT_NUMA_PLACEMENT_H
@@ -0,0 +1,236 @@
+#ifndef GRAPHIT_PRIORITY_QUEUE_H
+#define GRAPHIT_PRIORITY_QUEUE_H
+
+#include <cinttypes>
+#include <limits>
+#include <vector>
+#include "infra_gapbs/bucket.h"
+#include "infra_gapbs/platform_atomics.h"
+#include "infra_ligra/ligra/utils.h"
+#include "vertexsubset.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+/*
+GraphIt runtime
+Class:  BucketPriorityQueue
+
+Parallel bucketed priority queue used by ordered edgeset apply operators
+(applyUpdatePriority), following delta-stepping
+ - A vertex v lives in bucket priorities[v] / delta, priorities is the
+   vector the apply function updates (e.g. SP for sssp)
+ - Only a window of kOpenBuckets buckets is materialized, vertices beyond
+   it go to a single overflow bucket that is redistributed once the window
+   is drained, so sparse or very large priorities cost no memory
+ - Vertices are never removed when their priority changes, a vertex is
+   simply inserted again; dequeueReadySet drops entries whose priority now
+   maps to another bucket than the one being processed (stale copies of
+   vertices that moved to an earlier bucket), and duplicates
+ - A priority that drops below the bucket being processed (negative edge
+   weights) moves the current bucket back to it; below the window (or after
+   a coarse delta passed over a smaller key) the window moves down to start
+   at its bucket and the open buckets are bucketed again
+ - The bucket being processed stays current until it is empty, so vertices
+   updated into it by the traversal are processed again (light edges)
+*/
+
+
+template <typename PriorityT_>
+class BucketPriorityQueue {
+ public:
+  static const int64_t kOpenBuckets = 128;
+
+  BucketPriorityQueue(PriorityT_ *priorities, int64_t num_vertices,
+                      PriorityT_ delta)
+      : priorities_(priorities), num_vertices_(num_vertices), delta_(delta),
+        window_start_(0), current_(0), num_pending_(0),
+        open_buckets_(kOpenBuckets) {
+    if (delta_ <= 0) {
+      std::cout << "priority update delta has to be positive" << std::endl;
+      std::exit(-1);
+    }
+    in_ready_set_ = new uint8_t[num_vertices_];
+    parallel_for (int64_t v = 0; v < num_vertices_; v++)
+      in_ready_set_[v] = 0;
+  }
+
+  ~BucketPriorityQueue() {
+    delete[] in_ready_set_;
+  }
+
+  BucketPriorityQueue(const BucketPriorityQueue&) = delete;
+  BucketPriorityQueue& operator=(const BucketPriorityQueue&) = delete;
+
+  int64_t getBucket(NodeID v) const {
+    return static_cast<int64_t>(priorities_[v] / delta_);
+  }
+
+  // the index of the bucket returned by the last dequeueReadySet
+  int64_t getCurrentBucket() const { return current_; }
+
+  bool finished() const { return num_pending_ == 0; }
+
+  // Buckets each vertex of the subset by its current priority
+  void insert(VertexSubset<NodeID> *vertices) {
+    vertices->toSparse();
+    insertVertices(vertices->dense_vertex_set_, vertices->size());
+  }
+
+  // Returns the vertices of the lowest non empty bucket as a sparse subset.
+  // The caller owns the returned subset. It is empty only when finished().
+  VertexSubset<NodeID>* dequeueReadySet() {
+    while (num_pending_ != 0) {
+      while (current_ < window_start_ + kOpenBuckets &&
+             open_buckets_[current_ - window_start_].empty())
+        current_++;
+      if (current_ == window_start_ + kOpenBuckets) {
+        advanceWindow();
+        continue;
+      }
+      Bucket<NodeID> ready;
+      ready.swap(open_buckets_[current_ - window_start_]);
+      num_pending_ -= ready.size();
+      VertexSubset<NodeID> *ready_set = filterBucket(ready, current_);
+      if (ready_set->size() != 0)
+        return ready_set;
+      delete ready_set;
+    }
+    return new VertexSubset<NodeID>(num_vertices_, 0);
+  }
+
+ private:
+  PriorityT_ *priorities_;
+  int64_t num_vertices_;
+  PriorityT_ delta_;
+  int64_t window_start_;
+  int64_t current_;
+  int64_t num_pending_;
+  std::vector<Bucket<NodeID>> open_buckets_;
+  Bucket<NodeID> overflow_;
+  uint8_t *in_ready_set_;
+
+  // Bucket slot in the window for an insertion, kOpenBuckets is overflow.
+  // insertVertices lowers the window before inserting below it.
+  int64_t getSlot(int64_t bucket) const {
+    if (bucket >= window_start_ + kOpenBuckets)
+      return kOpenBuckets;
+    return bucket - window_start_;
+  }
+
+  void insertVertices(const unsigned int *vertices, int64_t m) {
+    if (m == 0)
+      return;
+    int64_t min_bucket = current_;
+    #pragma omp parallel for reduction(min : min_bucket)
+    for (int64_t i = 0; i < m; i++) {
+      int64_t b = getBucket(vertices[i]);
+      if (b < min_bucket)
+        min_bucket = b;
+    }
+    if (min_bucket < window_start_) {
+      lowerWindow(min_bucket, vertices, m);
+      return;
+    }
+    current_ = min_bucket;
+    // the last local bin collects everything beyond the window
+    #pragma omp parallel
+    {
+      std::vector<std::vector<NodeID>> local_bins(kOpenBuckets + 1);
+      #pragma omp for nowait schedule(static)
+      for (int64_t i = 0; i < m; i++) {
+        NodeID v = vertices[i];
+        local_bins[getSlot(getBucket(v))].push_back(v);
+      }
+      for (int64_t b = 0; b < kOpenBuckets; b++)
+        open_buckets_[b].swap_vector_in(local_bins[b]);
+      overflow_.swap_vector_in(local_bins[kOpenBuckets]);
+    }
+    num_pending_ += m;
+  }
+
+  // Moves the window down to start at bucket and inserts the vertices with
+  // the ones of the open buckets, stale copies among them are bucketed by
+  // their current priority and dropped as duplicates by filterBucket.
+  // overflow_ stays beyond the window, it only moved down.
+  void lowerWindow(int64_t bucket, const unsigned int *vertices, int64_t m) {
+    std::vector<unsigned int> all(vertices, vertices + m);
+    for (Bucket<NodeID> &open : open_buckets_) {
+      num_pending_ -= open.size();
+      for (NodeID v : open)
+        all.push_back(v);
+      open.clear();
+    }
+    window_start_ = bucket;
+    current_ = bucket;
+    insertVertices(all.data(), all.size());
+  }
+
+  // Slides the window to start at the lowest bucket in overflow_ and moves
+  // the entries that fall inside the new window. Entries that now map below
+  // the window were reinserted when their priority dropped and are dropped.
+  void advanceWindow() {
+    Bucket<NodeID> pending;
+    pending.swap(overflow_);
+    num_pending_ -= pending.size();
+    std::vector<unsigned int> vertices;
+    vertices.reserve(pending.size());
+    int64_t min_bucket = std::numeric_limits<int64_t>::max();
+    for (NodeID v : pending) {
+      int64_t b = getBucket(v);
+      if (b >= current_) {
+        vertices.push_back(v);
+        if (b < min_bucket)
+          min_bucket = b;
+      }
+    }
+    if (vertices.empty())
+      return;
+    window_start_ = min_bucket;
+    current_ = min_bucket;
+    insertVertices(vertices.data(), vertices.size());
+  }
+
+  // Keeps the vertices whose priority still maps to bucket, once each
+  VertexSubset<NodeID>* filterBucket(Bucket<NodeID> &ready, int64_t bucket) {
+    int64_t n = ready.size();
+    uintE *candidates = new uintE[n];
+    #pragma omp parallel
+    {
+      int64_t num_threads = 1, thread_id = 0;
+#ifdef _OPENMP
+      num_threads = omp_get_num_threads();
+      thread_id = omp_get_thread_num();
+#endif
+      int64_t begin = n * thread_id / num_threads;
+      int64_t end = n * (thread_id + 1) / num_threads;
+      typename Bucket<NodeID>::iterator it = ready.begin();
+      it += begin;
+      for (int64_t i = begin; i < end; i++, it++) {
+        NodeID v = *it;
+        if (getBucket(v) == bucket &&
+            compare_and_swap(in_ready_set_[v], (uint8_t) 0, (uint8_t) 1))
+          candidates[i] = v;
+        else
+          candidates[i] = UINT_E_MAX;
+      }
+    }
+    unsigned int *members = new unsigned int[n];
+    int64_t m = sequence::filter(candidates, members, n, nonMaxF());
+    delete[] candidates;
+    parallel_for (int64_t i = 0; i < m; i++)
+      in_ready_set_[members[i]] = 0;
+    VertexSubset<NodeID> *ready_set = new VertexSubset<NodeID>(num_vertices_, m);
+    if (ready_set->dense_vertex_set_ == nullptr) {
+      ready_set->dense_vertex_set_ = members;
+    } else {
+      // every vertex is ready, the constructor already built the full set
+      delete[] members;
+    }
+    return ready_set;
+  }
+};
+
+#endif //GRAPHIT_PRIORITY_QUEUE_H
@@ -0,0 +1,469 @@
+#ifndef GRAPHIT_SIMD_PULL_H
+#define GRAPHIT_SIMD_PULL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+
+/*
+GraphIt runtime
+Class:  SimdVector
+
+Vectors of kSimdLanes values for the SIMD pull kernel (configApplyPullKernel
+"simd"): the generated apply function computes the value of kSimdLanes
+in-neighbors at once from gathered vertex data, builtin_simdPullSum and
+builtin_simdPullMin reduce the in-neighbor list of a vertex with it and
+finish the last (fewer than kSimdLanes) in-neighbors with the scalar value
+ - AVX-512 builds gather 16 lanes, AVX2 builds 8 (float, int and double
+   vectors, doubles in two registers); other builds loop over 8 lanes
+ - gather reads base[index] for every lane, with a stride it reads a field of
+   an array of structs (the field address of element 0 and the struct size);
+   int data gathered into a float or double vector is converted
+ - The lanes are added up in a different order than the scalar loop, so
+   floating point sums can differ from it in the last bits
+*/
+
+
+#if defined(__AVX512F__)
+static const int kSimdLanes = 16;
+#else
+static const int kSimdLanes = 8;
+#endif
+
+
+// the in-neighbor ids of the lanes
+class SimdIndex {
+ public:
+#if defined(__AVX512F__)
+  __m512i v;
+
+  static SimdIndex load(const int32_t *ids) {
+    SimdIndex index;
+    index.v = _mm512_loadu_si512(ids);
+    return index;
+  }
+
+  // the ids multiplied by factor (element index of a field in an array of structs)
+  SimdIndex scaled(int32_t factor) const {
+    SimdIndex index = *this;
+    if (factor != 1)
+      index.v = _mm512_mullo_epi32(v, _mm512_set1_epi32(factor));
+    return index;
+  }
+
+  int32_t lane(int i) const {
+    alignas(64) int32_t lanes[kSimdLanes];
+    _mm512_store_si512(lanes, v);
+    return lanes[i];
+  }
+#elif defined(__AVX2__)
+  __m256i v;
+
+  static SimdIndex load(const int32_t *ids) {
+    SimdIndex index;
+    index.v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ids));
+    return index;
+  }
+
+  SimdIndex scaled(int32_t factor) const {
+    SimdIndex index = *this;
+    if (factor != 1)
+      index.v = _mm256_mullo_epi32(v, _mm256_set1_epi32(factor));
+    return index;
+  }
+
+  int32_t lane(int i) const {
+    alignas(32) int32_t lanes[kSimdLanes];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    return lanes[i];
+  }
+#else
+  int32_t v[kSimdLanes];
+
+  static SimdIndex load(const int32_t *ids) {
+    SimdIndex index;
+    for (int i = 0; i < kSimdLanes; i++)
+      index.v[i] = ids[i];
+    return index;
+  }
+
+  SimdIndex scaled(int32_t factor) const {
+    SimdIndex index = *this;
+    for (int i = 0; i < kSimdLanes; i++)
+      index.v[i] *= factor;
+    return index;
+  }
+
+  int32_t lane(int i) const {
+    return v[i];
+  }
+#endif
+};
+
+
+// portable vector, also the vector of the types without a SIMD version
+template <typename T>
+class SimdVector {
+ public:
+  SimdVector() {}
+
+  SimdVector(T value) {
+    for (int i = 0; i < kSimdLanes; i++)
+      lanes_[i] = value;
+  }
+
+  template <typename U>
+  static SimdVector gather(const U *base, const SimdIndex &index, size_t stride = sizeof(U)) {
+    SimdVector result;
+    const char *bytes = reinterpret_cast<const char*>(base);
+    for (int i = 0; i < kSimdLanes; i++)
+      result.lanes_[i] = *reinterpret_cast<const U*>(bytes + (size_t) index.lane(i) * stride);
+    return result;
+  }
+
+  friend SimdVector operator+(const SimdVector &a, const SimdVector &b) {
+    SimdVector result;
+    for (int i = 0; i < kSimdLanes; i++)
+      result.lanes_[i] = a.lanes_[i] + b.lanes_[i];
+    return result;
+  }
+
+  friend SimdVector operator-(const SimdVector &a, const SimdVector &b) {
+    SimdVector result;
+    for (int i = 0; i < kSimdLanes; i++)
+      result.lanes_[i] = a.lanes_[i] - b.lanes_[i];
+    return result;
+  }
+
+  friend SimdVector operator*(const SimdVector &a, const SimdVector &b) {
+    SimdVector result;
+    for (int i = 0; i < kSimdLanes; i++)
+      result.lanes_[i] = a.lanes_[i] * b.lanes_[i];
+    return result;
+  }
+
+  friend SimdVector operator/(const SimdVector &a, const SimdVector &b) {
+    SimdVector result;
+    for (int i = 0; i < kSimdLanes; i++)
+      result.lanes_[i] = a.lanes_[i] / b.lanes_[i];
+    return result;
+  }
+
+  friend SimdVector simdMin(const SimdVector &a, const SimdVector &b) {
+    SimdVector result;
+    for (int i = 0; i < kSimdLanes; i++)
+      result.lanes_[i] = b.lanes_[i] < a.lanes_[i] ? b.lanes_[i] : a.lanes_[i];
+    return result;
+  }
+
+  T sum() const {
+    T total = lanes_[0];
+    for (int i = 1; i < kSimdLanes; i++)
+      total += lanes_[i];
+    return total;
+  }
+
+  T min() const {
+    T smallest = lanes_[0];
+    for (int i = 1; i < kSimdLanes; i++)
+      smallest = lanes_[i] < smallest ? lanes_[i] : smallest;
+    return smallest;
+  }
+
+ private:
+  T lanes_[kSimdLanes];
+};
+
+
+#if defined(__AVX512F__)
+
+template <>
+class SimdVector<float> {
+ public:
+  SimdVector() {}
+
+  SimdVector(float value) : v_(_mm512_set1_ps(value)) {}
+
+  explicit SimdVector(__m512 v) : v_(v) {}
+
+  static SimdVector gather(const float *base, const SimdIndex &index, size_t stride = sizeof(float)) {
+    return SimdVector(_mm512_i32gather_ps(index.scaled(stride / sizeof(float)).v, base, sizeof(float)));
+  }
+
+  static SimdVector gather(const int *base, const SimdIndex &index, size_t stride = sizeof(int)) {
+    __m512i values = _mm512_i32gather_epi32(index.scaled(stride / sizeof(int)).v, base, sizeof(int));
+    return SimdVector(_mm512_cvtepi32_ps(values));
+  }
+
+  friend SimdVector operator+(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm512_add_ps(a.v_, b.v_)); }
+  friend SimdVector operator-(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm512_sub_ps(a.v_, b.v_)); }
+  friend SimdVector operator*(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm512_mul_ps(a.v_, b.v_)); }
+  friend SimdVector operator/(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm512_div_ps(a.v_, b.v_)); }
+  friend SimdVector simdMin(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm512_min_ps(a.v_, b.v_)); }
+
+  float sum() const { return _mm512_reduce_add_ps(v_); }
+  float min() const { return _mm512_reduce_min_ps(v_); }
+
+ private:
+  __m512 v_;
+};
+
+template <>
+class SimdVector<double> {
+ public:
+  SimdVector() {}
+
+  SimdVector(double value) : low_(_mm512_set1_pd(value)), high_(low_) {}
+
+  SimdVector(__m512d low, __m512d high) : low_(low), high_(high) {}
+
+  static SimdVector gather(const double *base, const SimdIndex &index, size_t stride = sizeof(double)) {
+    __m512i ids = index.scaled(stride / sizeof(double)).v;
+    return SimdVector(_mm512_i32gather_pd(_mm512_castsi512_si256(ids), base, sizeof(double)),
+                      _mm512_i32gather_pd(_mm512_extracti64x4_epi64(ids, 1), base, sizeof(double)));
+  }
+
+  static SimdVector gather(const int *base, const SimdIndex &index, size_t stride = sizeof(int)) {
+    __m512i values = _mm512_i32gather_epi32(index.scaled(stride / sizeof(int)).v, base, sizeof(int));
+    return SimdVector(_mm512_cvtepi32_pd(_mm512_castsi512_si256(values)),
+                      _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(values, 1)));
+  }
+
+  friend SimdVector operator+(const SimdVector &a, const SimdVector &b) {
+    return SimdVector(_mm512_add_pd(a.low_, b.low_), _mm512_add_pd(a.high_, b.high_));
+  }
+  friend SimdVector operator-(const SimdVector &a, const SimdVector &b) {
+    return SimdVector(_mm512_sub_pd(a.low_, b.low_), _mm512_sub_pd(a.high_, b.high_));
+  }
+  friend SimdVector operator*(const SimdVector &a, const SimdVector &b) {
+    return SimdVector(_mm512_mul_pd(a.low_, b.low_), _mm512_mul_pd(a.high_, b.high_));
+  }
+  friend SimdVector operator/(const SimdVector &a, const SimdVector &b) {
+    return SimdVector(_mm512_div_pd(a.low_, b.low_), _mm512_div_pd(a.high_, b.high_));
+  }
+  friend SimdVector simdMin(const SimdVector &a, const SimdVector &b) {
+    return SimdVector(_mm512_min_pd(a.low_, b.low_), _mm512_min_pd(a.high_, b.high_));
+  }
+
+  double sum() const { return _mm512_reduce_add_pd(_mm512_add_pd(low_, high_)); }
+  double min() const { return _mm512_reduce_min_pd(_mm512_min_pd(low_, high_)); }
+
+ private:
+  __m512d low_;
+  __m512d high_;
+};
+
+template <>
+class SimdVector<int> {
+ public:
+  SimdVector() {}
+
+  SimdVector(int value) : v_(_mm512_set1_epi32(value)) {}
+
+  explicit SimdVector(__m512i v) : v_(v) {}
+
+  static SimdVector gather(const int *base, const SimdIndex &index, size_t stride = sizeof(int)) {
+    return SimdVector(_mm512_i32gather_epi32(index.scaled(stride / sizeof(int)).v, base, sizeof(int)));
+  }
+
+  friend SimdVector operator+(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm512_add_epi32(a.v_, b.v_)); }
+  friend SimdVector operator-(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm512_sub_epi32(a.v_, b.v_)); }
+  friend SimdVector operator*(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm512_mullo_epi32(a.v_, b.v_)); }
+  friend SimdVector simdMin(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm512_min_epi32(a.v_, b.v_)); }
+
+  int sum() const { return _mm512_reduce_add_epi32(v_); }
+  int min() const { return _mm512_reduce_min_epi32(v_); }
+
+ private:
+  __m512i v_;
+};
+
+#elif defined(__AVX2__)
+
+template <>
+class SimdVector<float> {
+ public:
+  SimdVector() {}
+
+  SimdVector(float value) : v_(_mm256_set1_ps(value)) {}
+
+  explicit SimdVector(__m256 v) : v_(v) {}
+
+  static SimdVector gather(const float *base, const SimdIndex &index, size_t stride = sizeof(float)) {
+    return SimdVector(_mm256_i32gather_ps(base, index.scaled(stride / sizeof(float)).v, sizeof(float)));
+  }
+
+  static SimdVector gather(const int *base, const SimdIndex &index, size_t stride = sizeof(int)) {
+    __m256i values = _mm256_i32gather_epi32(base, index.scaled(stride / sizeof(int)).v, sizeof(int));
+    return SimdVector(_mm256_cvtepi32_ps(values));
+  }
+
+  friend SimdVector operator+(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm256_add_ps(a.v_, b.v_)); }
+  friend SimdVector operator-(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm256_sub_ps(a.v_, b.v_)); }
+  friend SimdVector operator*(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm256_mul_ps(a.v_, b.v_)); }
+  friend SimdVector operator/(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm256_div_ps(a.v_, b.v_)); }
+  friend SimdVector simdMin(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm256_min_ps(a.v_, b.v_)); }
+
+  float sum() const {
+    alignas(32) float lanes[kSimdLanes];
+    _mm256_store_ps(lanes, v_);
+    float total = lanes[0];
+    for (int i = 1; i < kSimdLanes; i++)
+      total += lanes[i];
+    return total;
+  }
+
+  float min() const {
+    alignas(32) float lanes[kSimdLanes];
+    _mm256_store_ps(lanes, v_);
+    float smallest = lanes[0];
+    for (int i = 1; i < kSimdLanes; i++)
+      smallest = lanes[i] < smallest ? lanes[i] : smallest;
+    return smallest;
+  }
+
+ private:
+  __m256 v_;
+};
+
+template <>
+class SimdVector<double> {
+ public:
+  SimdVector() {}
+
+  SimdVector(double value) : low_(_mm256_set1_pd(value)), high_(low_) {}
+
+  SimdVector(__m256d low, __m256d high) : low_(low), high_(high) {}
+
+  static SimdVector gather(const double *base, const SimdIndex &index, size_t stride = sizeof(double)) {
+    __m256i ids = index.scaled(stride / sizeof(double)).v;
+    return SimdVector(_mm256_i32gather_pd(base, _mm256_castsi256_si128(ids), sizeof(double)),
+                      _mm256_i32gather_pd(base, _mm256_extracti128_si256(ids, 1), sizeof(double)));
+  }
+
+  static SimdVector gather(const int *base, const SimdIndex &index, size_t stride = sizeof(int)) {
+    __m256i values = _mm256_i32gather_epi32(base, index.scaled(stride / sizeof(int)).v, sizeof(int));
+    return SimdVector(_mm256_cvtepi32_pd(_mm256_castsi256_si128(values)),
+                      _mm256_cvtepi32_pd(_mm256_extracti128_si256(values, 1)));
+  }
+
+  friend SimdVector operator+(const SimdVector &a, const SimdVector &b) {
+    return SimdVector(_mm256_add_pd(a.low_, b.low_), _mm256_add_pd(a.high_, b.high_));
+  }
+  friend SimdVector operator-(const SimdVector &a, const SimdVector &b) {
+    return SimdVector(_mm256_sub_pd(a.low_, b.low_), _mm256_sub_pd(a.high_, b.high_));
+  }
+  friend SimdVector operator*(const SimdVector &a, const SimdVector &b) {
+    return SimdVector(_mm256_mul_pd(a.low_, b.low_), _mm256_mul_pd(a.high_, b.high_));
+  }
+  friend SimdVector operator/(const SimdVector &a, const SimdVector &b) {
+    return SimdVector(_mm256_div_pd(a.low_, b.low_), _mm256_div_pd(a.high_, b.high_));
+  }
+  friend SimdVector simdMin(const SimdVector &a, const SimdVector &b) {
+    return SimdVector(_mm256_min_pd(a.low_, b.low_), _mm256_min_pd(a.high_, b.high_));
+  }
+
+  double sum() const {
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(low_, high_));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  }
+
+  double min() const {
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_min_pd(low_, high_));
+    double smallest = lanes[0];
+    for (int i = 1; i < 4; i++)
+      smallest = lanes[i] < smallest ? lanes[i] : smallest;
+    return smallest;
+  }
+
+ private:
+  __m256d low_;
+  __m256d high_;
+};
+
+template <>
+class SimdVector<int> {
+ public:
+  SimdVector() {}
+
+  SimdVector(int value) : v_(_mm256_set1_epi32(value)) {}
+
+  explicit SimdVector(__m256i v) : v_(v) {}
+
+  static SimdVector gather(const int *base, const SimdIndex &index, size_t stride = sizeof(int)) {
+    return SimdVector(_mm256_i32gather_epi32(base, index.scaled(stride / sizeof(int)).v, sizeof(int)));
+  }
+
+  friend SimdVector operator+(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm256_add_epi32(a.v_, b.v_)); }
+  friend SimdVector operator-(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm256_sub_epi32(a.v_, b.v_)); }
+  friend SimdVector operator*(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm256_mullo_epi32(a.v_, b.v_)); }
+  friend SimdVector simdMin(const SimdVector &a, const SimdVector &b) { return SimdVector(_mm256_min_epi32(a.v_, b.v_)); }
+
+  int sum() const {
+    alignas(32) int lanes[kSimdLanes];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v_);
+    int total = lanes[0];
+    for (int i = 1; i < kSimdLanes; i++)
+      total += lanes[i];
+    return total;
+  }
+
+  int min() const {
+    alignas(32) int lanes[kSimdLanes];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v_);
+    int smallest = lanes[0];
+    for (int i = 1; i < kSimdLanes; i++)
+      smallest = lanes[i] < smallest ? lanes[i] : smallest;
+    return smallest;
+  }
+
+ private:
+  __m256i v_;
+};
+
+#endif
+
+
+// sum of apply_func.pullValue over the in-neighbors [begin, end), kSimdLanes at a time, then a scalar tail
+template <typename T, typename F>
+static T builtin_simdPullSum(const int32_t *begin, const int32_t *end, F &apply_func) {
+  const int32_t *ngh = begin;
+  T total = 0;
+  if (end - begin >= kSimdLanes) {
+    SimdVector<T> partial(0);
+    for (; end - ngh >= kSimdLanes; ngh += kSimdLanes)
+      partial = partial + apply_func.pullValue(SimdIndex::load(ngh));
+    total = partial.sum();
+  }
+  for (; ngh < end; ngh++)
+    total += apply_func.pullValue(*ngh);
+  return total;
+}
+
+// minimum of apply_func.pullValue over the in-neighbors [begin, end), infinity (or the largest T) if there are none
+template <typename T, typename F>
+static T builtin_simdPullMin(const int32_t *begin, const int32_t *end, F &apply_func) {
+  const T identity = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                          : std::numeric_limits<T>::max();
+  const int32_t *ngh = begin;
+  T smallest = identity;
+  if (end - begin >= kSimdLanes) {
+    SimdVector<T> partial(identity);
+    for (; end - ngh >= kSimdLanes; ngh += kSimdLanes)
+      partial = simdMin(partial, apply_func.pullValue(SimdIndex::load(ngh)));
+    smallest = partial.min();
+  }
+  for (; ngh < end; ngh++) {
+    T value = apply_func.pullValue(*ngh);
+    smallest = value < smallest ? value : smallest;
+  }
+  return smallest;
+}
+
+#endif //GRAPHIT_SIMD_PULL_H
@@ -0,0 +1,384 @@
+#ifndef GRAPHIT_THREAD_CONTROL_H
+#define GRAPHIT_THREAD_CONTROL_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "infra_ligra/ligra/parallel.h"
+
+
+/*
+GraphIt runtime
+Class:  ThreadControl
+
+Thread count and thread placement of generated programs, set through the
+builtin_ functions below or through the command line flags that generated
+main functions consume (and remove from argv) before the program runs:
+  --threads N                   number of worker threads
+  --affinity compact|scatter|none
+                                compact pins consecutive threads to
+                                neighboring hardware threads (filling a
+                                core, then a socket), scatter spreads them
+                                round robin over the sockets and cores
+  --smt on|off                  off only uses the first hardware thread of
+                                every core (and, without --threads, runs one
+                                thread per core)
+  --scaling auto|N,N,...        scaling benchmark: reruns the program once
+                                per thread count (auto: powers of two up to
+                                the available hardware threads) and prints,
+                                as CSV, the time and speedup over the first
+                                count of every labeled apply (programs built
+                                with graphitc -c) and of the whole run
+ - The topology comes from /sys/devices/system/cpu and is restricted to the
+   CPUs the process may run on when it starts
+ - Pinning is done by the threads of the OpenMP team (OpenMP builds); other
+   builds only set the worker count
+ - The workers of the work-stealing schedulers register themselves and are
+   pinned like the OpenMP thread of the same number (the forking thread is
+   number 0) instead of inheriting the CPU of the main thread; without an
+   affinity all pinned threads get back the CPUs of the start
+*/
+
+
+class ThreadControl {
+ public:
+  enum Affinity { kNone, kCompact, kScatter };
+
+  struct Cpu {
+    int id;
+    int package;
+    int core;
+  };
+
+  static ThreadControl &get() {
+    static ThreadControl *control = new ThreadControl();
+    return *control;
+  }
+
+  int numThreads() const {
+    return getWorkers();
+  }
+
+  void setNumThreads(int num_threads) {
+    setWorkers(num_threads);
+    pin();
+  }
+
+  void setAffinity(Affinity affinity, bool smt) {
+    affinity_ = affinity;
+    smt_ = smt;
+    pin();
+  }
+
+  // the CPUs the threads are pinned to, thread i runs on order[i % order.size()]
+  static std::vector<int> orderCpus(const std::vector<Cpu> &cpus, Affinity affinity, bool smt) {
+    // position of every CPU inside its core (hardware thread) and of its core inside its package
+    std::map<std::pair<int, int>, int> siblings;
+    std::map<std::pair<int, int>, int> core_ranks;
+    std::map<int, int> cores_per_package;
+    std::vector<std::tuple<int, int, int, int>> keys;
+    for (const Cpu &cpu : cpus) {
+      std::pair<int, int> core(cpu.package, cpu.core);
+      if (core_ranks.find(core) == core_ranks.end())
+        core_ranks[core] = cores_per_package[cpu.package]++;
+      int sibling = siblings[core]++;
+      if (!smt && sibling > 0)
+        continue;
+      int core_rank = core_ranks[core];
+      if (affinity == kScatter)
+        keys.push_back(std::make_tuple(sibling, core_rank, cpu.package, cpu.id));
+      else
+        keys.push_back(std::make_tuple(cpu.package, core_rank, sibling, cpu.id));
+    }
+    if (affinity != kNone)
+      std::sort(keys.begin(), keys.end());
+    std::vector<int> order;
+    for (auto &key : keys)
+      order.push_back(std::get<3>(key));
+    return order;
+  }
+
+  // the CPUs the process could run on when it started, with their package and core
+  std::vector<Cpu> topology() const {
+    std::vector<Cpu> cpus;
+    for (int id = 0; id < CPU_SETSIZE; id++) {
+      if (!CPU_ISSET(id, &allowed_))
+        continue;
+      std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/topology/";
+      Cpu cpu = {id, readInt(dir + "physical_package_id", 0), readInt(dir + "core_id", id)};
+      cpus.push_back(cpu);
+    }
+    return cpus;
+  }
+
+  // registers the calling thread as worker number slot of a work-stealing scheduler, pinned like OpenMP thread slot
+  void addWorker(int slot) {
+    std::lock_guard<std::mutex> guard(workers_lock_);
+    workers_.push_back(std::make_pair(pthread_self(), slot));
+    if (!order_.empty()) {
+      cpu_set_t set = cpusOf(slot);
+      pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+  }
+
+  // the calling worker thread stops, it is not pinned anymore
+  void removeWorker() {
+    std::lock_guard<std::mutex> guard(workers_lock_);
+    for (auto it = workers_.begin(); it != workers_.end(); ++it) {
+      if (pthread_equal(it->first, pthread_self())) {
+        workers_.erase(it);
+        return;
+      }
+    }
+  }
+
+  // consumes the runtime flags, runs the scaling benchmark instead of the program if asked to
+  void parseFlags(int &argc, char **argv) {
+    std::string scaling;
+    int num_threads = 0;
+    bool affinity_set = false;
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+      std::string flag = argv[i];
+      bool takes_value = flag == "--threads" || flag == "--affinity" || flag == "--smt" || flag == "--scaling";
+      if (!takes_value) {
+        argv[kept++] = argv[i];
+        continue;
+      }
+      if (i + 1 >= argc) {
+        std::cout << flag << " needs a value" << std::endl;
+        std::exit(-1);
+      }
+      std::string value = argv[++i];
+      if (flag == "--threads") {
+        num_threads = std::atoi(value.c_str());
+        if (num_threads < 1) {
+          std::cout << "invalid --threads " << value << std::endl;
+          std::exit(-1);
+        }
+      } else if (flag == "--affinity") {
+        if (value == "compact") {
+          affinity_ = kCompact;
+        } else if (value == "scatter") {
+          affinity_ = kScatter;
+        } else if (value == "none") {
+          affinity_ = kNone;
+        } else {
+          std::cout << "invalid --affinity " << value << ", use compact, scatter or none" << std::endl;
+          std::exit(-1);
+        }
+        affinity_set = true;
+      } else if (flag == "--smt") {
+        if (value != "on" && value != "off") {
+          std::cout << "invalid --smt " << value << ", use on or off" << std::endl;
+          std::exit(-1);
+        }
+        smt_ = value == "on";
+        affinity_set = true;
+      } else {
+        scaling = value;
+      }
+    }
+    argc = kept;
+    argv[argc] = nullptr;
+
+    if (scaling != "") {
+      runScaling(argc, argv, scalingCounts(scaling));
+      std::exit(0);
+    }
+    if (num_threads == 0 && !smt_)
+      num_threads = orderCpus(topology(), affinity_, false).size();
+    if (num_threads > 0)
+      setWorkers(num_threads);
+    if (affinity_set)
+      pin();
+  }
+
+ private:
+  Affinity affinity_;
+  bool smt_;
+  cpu_set_t allowed_;
+  // the CPUs of the pinned threads, empty while nothing is pinned
+  std::vector<int> order_;
+  std::mutex workers_lock_;
+  std::vector<std::pair<pthread_t, int>> workers_;
+
+  ThreadControl() : affinity_(kNone), smt_(true) {
+    CPU_ZERO(&allowed_);
+    if (sched_getaffinity(0, sizeof(allowed_), &allowed_) != 0) {
+      for (int id = 0; id < sysconf(_SC_NPROCESSORS_ONLN) && id < CPU_SETSIZE; id++)
+        CPU_SET(id, &allowed_);
+    }
+  }
+
+  static int readInt(const std::string &file_name, int default_value) {
+    std::ifstream in(file_name);
+    int value;
+    return in >> value ? value : default_value;
+  }
+
+  cpu_set_t cpusOf(int slot) const {
+    if (order_.empty())
+      return allowed_;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(order_[slot % order_.size()], &set);
+    return set;
+  }
+
+  // pins every thread of the OpenMP team and every scheduler worker to its CPU, unpins them without an affinity
+  void pin() {
+    std::lock_guard<std::mutex> guard(workers_lock_);
+    bool pinned = !order_.empty();
+    order_.clear();
+    if (affinity_ != kNone || !smt_)
+      order_ = orderCpus(topology(), affinity_, smt_);
+    if (order_.empty() && !pinned)
+      return;
+#ifdef OPENMP
+    #pragma omp parallel
+    {
+      cpu_set_t set = cpusOf(omp_get_thread_num());
+      sched_setaffinity(0, sizeof(set), &set);
+    }
+#endif
+    for (auto &worker : workers_) {
+      cpu_set_t set = cpusOf(worker.second);
+      pthread_setaffinity_np(worker.first, sizeof(set), &set);
+    }
+  }
+
+  std::vector<int> scalingCounts(const std::string &counts) const {
+    std::vector<int> result;
+    if (counts == "auto") {
+      int max_threads = orderCpus(topology(), affinity_, smt_).size();
+      for (int t = 1; t < max_threads; t *= 2)
+        result.push_back(t);
+      result.push_back(std::max(max_threads, 1));
+      return result;
+    }
+    std::stringstream in(counts);
+    std::string count;
+    while (std::getline(in, count, ',')) {
+      if (std::atoi(count.c_str()) < 1) {
+        std::cout << "invalid --scaling " << counts << ", use auto or a list like 1,2,4" << std::endl;
+        std::exit(-1);
+      }
+      result.push_back(std::atoi(count.c_str()));
+    }
+    return result;
+  }
+
+  // runs the program with num_threads threads, returns its wall time and fills the seconds per labeled apply
+  double runOnce(int argc, char **argv, int num_threads, std::vector<std::string> &labels,
+                 std::map<std::string, double> &seconds) const {
+    char counters[] = "/tmp/graphit_scaling_XXXXXX.csv";
+    int fd = mkstemps(counters, 4);
+    if (fd < 0) {
+      std::cout << "could not create a file for the apply counters" << std::endl;
+      std::exit(-1);
+    }
+    close(fd);
+    std::string threads = std::to_string(num_threads);
+    std::vector<const char*> args = {argv[0], "--threads", threads.c_str(),
+                                     "--affinity", affinity_ == kCompact ? "compact" : (affinity_ == kScatter ? "scatter" : "none"),
+                                     "--smt", smt_ ? "on" : "off"};
+    for (int i = 1; i < argc; i++)
+      args.push_back(argv[i]);
+    args.push_back(nullptr);
+
+    std::cout.flush();
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+      // the program output is dropped, only the report is printed
+      if (freopen("/dev/null", "w", stdout) == nullptr)
+        _exit(-1);
+      setenv("GRAPHIT_APPLY_COUNTERS", counters, 1);
+      execv("/proc/self/exe", const_cast<char* const*>(args.data()));
+      _exit(-1);
+    }
+    int status = -1;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      std::cout << "scaling run with " << num_threads << " threads failed" << std::endl;
+      std::remove(counters);
+      std::exit(-1);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // label,round,seconds,... as written by ApplyCounters::writeCSV
+    std::ifstream in(counters);
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line)) {
+      std::stringstream fields(line);
+      std::string label, round, time;
+      std::getline(fields, label, ',');
+      std::getline(fields, round, ',');
+      std::getline(fields, time, ',');
+      if (std::find(labels.begin(), labels.end(), label) == labels.end())
+        labels.push_back(label);
+      seconds[label] += std::atof(time.c_str());
+    }
+    std::remove(counters);
+    return elapsed.count();
+  }
+
+  void runScaling(int argc, char **argv, const std::vector<int> &counts) const {
+    std::vector<std::string> labels;
+    std::vector<std::map<std::string, double>> seconds(counts.size());
+    for (size_t c = 0; c < counts.size(); c++)
+      seconds[c]["total"] = runOnce(argc, argv, counts[c], labels, seconds[c]);
+    labels.push_back("total");
+
+    std::cout << "label,threads,seconds,speedup" << std::endl;
+    for (const std::string &label : labels) {
+      for (size_t c = 0; c < counts.size(); c++) {
+        double time = seconds[c][label];
+        double base = seconds[0][label];
+        std::cout << label << "," << counts[c] << "," << time << "," << (time > 0 ? base / time : 0) << std::endl;
+      }
+    }
+  }
+};
+
+
+// generated main functions call this first, with their argc and argv
+static void builtin_parseRuntimeFlags(int &argc, char **argv) {
+  ThreadControl::get().parseFlags(argc, argv);
+}
+
+static int builtin_getNumThreads() {
+  return ThreadControl::get().numThreads();
+}
+
+static void builtin_setNumThreads(int num_threads) {
+  ThreadControl::get().setNumThreads(num_threads);
+}
+
+// affinity is "compact", "scatter" or "none", smt false keeps one hardware thread per core
+static void builtin_setAffinity(std::string affinity, bool smt = true) {
+  if (affinity != "compact" && affinity != "scatter" && affinity != "none") {
+    std::cout << "invalid affinity " << affinity << ", use compact, scatter or none" << std::endl;
+    std::exit(-1);
+  }
+  ThreadControl::get().setAffinity(affinity == "compact" ? ThreadControl::kCompact :
+                                   (affinity == "scatter" ? ThreadControl::kScatter : ThreadControl::kNone), smt);
+}
+
+#endif //GRAPHIT_THREAD_CONTROL_H
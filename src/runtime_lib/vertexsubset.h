@@ -8,7 +8,10 @@
 #include <cinttypes>
 #include <iostream>
 #include <type_traits>
+#include <algorithm>
+#include "infra_gapbs/bitmap.h"
 #include "infra_gapbs/sliding_queue.h"
+#include "frontier_pool.h"
 #include "infra_ligra/ligra/parallel.h"
 #include "infra_ligra/ligra/utils.h"
 
@@ -34,21 +37,29 @@ struct VertexSubset {
     VertexSubset(VertexSubset* input_vert_set)
         : num_vertices_(input_vert_set->num_vertices_),
             vertices_range_(input_vert_set->vertices_range_),
-            is_dense(input_vert_set->is_dense){
+            is_dense(input_vert_set->is_dense),
+            dense_vertex_set_(nullptr), bitmap_(nullptr), bool_map_(nullptr), sliding_queue_(nullptr){
             if (input_vert_set->dense_vertex_set_ != nullptr){
-                dense_vertex_set_ = newA(unsigned int, num_vertices_);
+                dense_vertex_set_ = FrontierPool::allocate<unsigned int>(num_vertices_);
                 parallel_for (int i = 0; i < num_vertices_; i++){
                     dense_vertex_set_[i] = input_vert_set->dense_vertex_set_[i];
                 }
             }
 
-            if (bool_map_ != nullptr){
-                bool_map_ = newA(bool, vertices_range_);
+            if (input_vert_set->bool_map_ != nullptr){
+                bool_map_ = FrontierPool::allocate<bool>(vertices_range_);
                 parallel_for (int i = 0; i < vertices_range_; i++){
                     bool_map_[i] = input_vert_set->bool_map_[i];
                 }
             }
 
+            if (input_vert_set->bitmap_ != nullptr){
+                bitmap_ = new Bitmap(vertices_range_);
+                parallel_for (long w = 0; w < (long) bitmap_->num_words(); w++){
+                    bitmap_->set_word(w, input_vert_set->bitmap_->get_word(w));
+                }
+            }
+
     }
 
     //set every vertex to true in the vertex subset
@@ -63,10 +74,10 @@ struct VertexSubset {
             //try not to initialize unncessary data structures, this can be expensive for PageRank, which returns full set
             bitmap_ = new Bitmap(vertices_range);
             bitmap_->set_all();
-            bool_map_ = newA(bool, vertices_range);
+            bool_map_ = FrontierPool::allocate<bool>(vertices_range);
             parallel_for(int i = 0; i < vertices_range; i++) bool_map_[i] = 1;
 
-            dense_vertex_set_ = new unsigned int[vertices_range];
+            dense_vertex_set_ = FrontierPool::allocate<unsigned int>(vertices_range);
 // don't need this for now
 //            sliding_queue_ = new SlidingQueue<NodeID>(vertices_range);
             parallel_for (NodeID i = 0; i< vertices_range; i++){
@@ -93,11 +104,12 @@ struct VertexSubset {
 
     // delete the contents
      ~VertexSubset(){
-	if(dense_vertex_set_)
+	// buffers from the frontier pool are recycled by the next iterations
+	if(dense_vertex_set_ && !FrontierPool::release(dense_vertex_set_))
 		delete[] dense_vertex_set_;
 	if(bitmap_)
 		delete bitmap_;
-	if(bool_map_)
+	if(bool_map_ && !FrontierPool::release(bool_map_))
 		delete[] bool_map_;
     }
 
@@ -122,6 +134,8 @@ struct VertexSubset {
     bool contains(NodeID_ v){
         if (bool_map_ != nullptr)
             return bool_map_[v];
+        else if (bitmap_ != nullptr)
+            return bitmap_->get_bit(v);
         else {
             toDense();
             return bool_map_[v];
@@ -174,7 +188,7 @@ struct VertexSubset {
 //        }
 
         if (bool_map_ == NULL) {
-            bool_map_ = newA(bool,vertices_range_);
+            bool_map_ = FrontierPool::allocate<bool>(vertices_range_);
             {parallel_for(long i=0;i<vertices_range_;i++) bool_map_[i] = 0;}
 
             if (tmp.size() != 0){
@@ -182,6 +196,8 @@ struct VertexSubset {
                     //bitmap_->set_bit(node);
                     bool_map_[node] = 1;
                 }
+            } else if (dense_vertex_set_ == nullptr && bitmap_ != nullptr){
+                forEachInBitmap([&](NodeID_ v) { bool_map_[v] = 1; });
             } else if (num_vertices_ > 0){
                 {parallel_for(long i=0;i<num_vertices_;i++) bool_map_[dense_vertex_set_[i]] = 1;}
             }
@@ -221,12 +237,14 @@ struct VertexSubset {
     // converts to sparse but keeps dense representation if there
     void toSparse() {
         if (dense_vertex_set_ == nullptr && tmp.size() > 0) {
-            dense_vertex_set_ = new unsigned int[num_vertices_];
+            dense_vertex_set_ = FrontierPool::allocate<unsigned int>(num_vertices_);
             for (int i = 0; i < num_vertices_; i++) {
                 dense_vertex_set_[i] = tmp[i];
             }
 
-        }else if (dense_vertex_set_ == nullptr && num_vertices_ > 0){
+        } else if (dense_vertex_set_ == nullptr && bool_map_ == nullptr && num_vertices_ > 0) {
+            bitmapToSparse();
+        } else if (dense_vertex_set_ == nullptr && num_vertices_ > 0){
 
                 _seq<uintE> R = sequence::packIndex<uintE>(bool_map_,vertices_range_);
                 if (num_vertices_ != R.n) {
@@ -239,7 +257,7 @@ struct VertexSubset {
         }
 
 //        } else if (dense_vertex_set_ == nullptr && num_vertices_ > 0){
-//            //vertices are stored as bitvector
+//            //vertices are stored as bitvector (now done by bitmapToSparse)
 //            dense_vertex_set_ = new unsigned int[num_vertices_];
 //            int j = 0;
 //            for (unsigned int i = 0; i < vertices_range_; i++){
@@ -252,6 +270,96 @@ struct VertexSubset {
 
     }
 
+    // builds the bit-packed dense representation (bitmap_, one bit per vertex) if it is not there yet
+    void toBitmap() {
+        if (bitmap_ != nullptr)
+            return;
+        bitmap_ = new Bitmap(vertices_range_);
+        if (bool_map_ != nullptr) {
+            // every word is assembled by a single iteration, no atomics needed
+            long num_words = bitmap_->num_words();
+            parallel_for (long w = 0; w < num_words; w++) {
+                uint64_t word = 0;
+                long end = std::min((w + 1) * 64, (long) vertices_range_);
+                for (long v = w * 64; v < end; v++) {
+                    if (bool_map_[v])
+                        word |= (uint64_t) 1 << (v - w * 64);
+                }
+                bitmap_->set_word(w, word);
+            }
+        } else {
+            bitmap_->reset();
+            if (tmp.size() != 0) {
+                for (NodeID node : tmp)
+                    bitmap_->set_bit(node);
+            } else if (num_vertices_ > 0) {
+                parallel_for (long i = 0; i < num_vertices_; i++)
+                    bitmap_->set_bit_atomic(dense_vertex_set_[i]);
+            }
+        }
+    }
+
+    // makes the bitmap the only representation of the subset (used by dense traversals that
+    // produce a bitvector frontier), the size is computed with popcount
+    void setBitmap(Bitmap * bitmap) {
+        if (bitmap_ != nullptr && bitmap_ != bitmap)
+            delete bitmap_;
+        bitmap_ = bitmap;
+        num_vertices_ = bitmap->count();
+        is_dense = true;
+    }
+
+    // calls f on every vertex in the bitmap, a 64-bit word at a time, skipping empty words
+    template <typename F>
+    void forEachInBitmap(F f) {
+        long num_words = bitmap_->num_words();
+        parallel_for (long w = 0; w < num_words; w++) {
+            uint64_t word = bitmap_->get_word(w);
+            while (word != 0) {
+                f(w * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+private:
+    // number of words whose vertices are written out by one iteration of bitmapToSparse
+    static const long kWordsPerBlock = 1024;
+
+    // builds the sparse array from the bitmap: count the vertices in each block of words,
+    // scan the counts, then every block writes its vertices starting at its offset
+    void bitmapToSparse() {
+        long num_words = bitmap_->num_words();
+        long num_blocks = (num_words + kWordsPerBlock - 1) / kWordsPerBlock;
+        long *block_offsets = newA(long, num_blocks);
+        parallel_for (long b = 0; b < num_blocks; b++) {
+            long count = 0;
+            long end = std::min((b + 1) * kWordsPerBlock, num_words);
+            for (long w = b * kWordsPerBlock; w < end; w++)
+                count += __builtin_popcountll(bitmap_->get_word(w));
+            block_offsets[b] = count;
+        }
+        long total = sequence::plusScan(block_offsets, block_offsets, num_blocks);
+        if (num_vertices_ != total) {
+            cout << "num_vertices_: " << num_vertices_ << " bitmap count: " << total << endl;
+            cout << "bad stored value of m" << endl;
+            abort();
+        }
+        dense_vertex_set_ = FrontierPool::allocate<unsigned int>(num_vertices_);
+        parallel_for (long b = 0; b < num_blocks; b++) {
+            long pos = block_offsets[b];
+            long end = std::min((b + 1) * kWordsPerBlock, num_words);
+            for (long w = b * kWordsPerBlock; w < end; w++) {
+                uint64_t word = bitmap_->get_word(w);
+                while (word != 0) {
+                    dense_vertex_set_[pos++] = w * 64 + __builtin_ctzll(word);
+                    word &= word - 1;
+                }
+            }
+        }
+        free(block_offsets);
+    }
+
 };
 
 #endif //GRAPHIT_VERTEXSUBSET_H
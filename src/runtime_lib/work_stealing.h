@@ -0,0 +1,359 @@
+#ifndef GRAPHIT_WORK_STEALING_H
+#define GRAPHIT_WORK_STEALING_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "infra_ligra/ligra/parallel.h"
+#include "thread_control.h"
+
+
+/*
+GraphIt runtime
+Class:  WorkStealingScheduler
+
+Fork-join task scheduler of the runtime, so the recursive (cilk_spawn style)
+parallelism of the generated code and the runtime runs in parallel without
+Cilk: builtin_parallelInvoke and builtin_parallelFor use it in OpenMP builds
+(Cilk builds keep cilk_spawn, serial builds run the tasks in order)
+ - Every worker owns a Chase-Lev deque of task pointers: it pushes and pops
+   its forked tasks at the bottom without locking, idle workers steal the
+   oldest (largest) task from the top of a random victim with a CAS
+ - A forked task lives on the stack of its forking thread, it holds a
+   reference to the lambda and a plain function pointer that calls it, so a
+   fork allocates nothing
+ - A worker waiting for a stolen task steals and runs other tasks meanwhile,
+   so nested parallelism never blocks a worker
+ - builtin_parallelFor splits lazily: a range is only halved (and the upper
+   half offered for stealing) while the worker's deque is empty, otherwise it
+   keeps running grain sized chunks itself
+ - Threads outside the pool (the main thread, OpenMP threads) get their own
+   deque the first time they fork
+ - GRAPHIT_NUM_WORKERS sets the number of workers of the runtime's
+   scheduler, the default is getWorkers() (the OpenMP thread count); idle
+   workers park on a condition variable until a task is forked, a fork only
+   takes the lock to wake them while some worker sleeps
+ - A deque holds kDequeCapacity tasks, a fork into a full deque runs both
+   halves on the forking thread
+ - graphitc -w runs the parallel vertex loops of the generated applies with
+   builtin_parallelFor instead of the parallel_for macro
+*/
+
+
+class WorkStealingScheduler {
+ public:
+  static WorkStealingScheduler &get() {
+    // never destroyed, the workers run until the process exits
+    static WorkStealingScheduler *scheduler = new WorkStealingScheduler(defaultWorkers());
+    return *scheduler;
+  }
+
+  // a scheduler of its own with num_workers workers, the calling thread counts as one of them
+  explicit WorkStealingScheduler(int num_workers)
+      : id_(nextId()), num_deques_(0), pending_(0), sleeping_(0), stop_(false) {
+    for (int i = 0; i < kMaxDeques; i++)
+      deques_[i] = nullptr;
+    num_workers_ = std::max(1, std::min(num_workers, kMaxDeques / 2));
+    int largest = largestPool().load();
+    while (largest < num_workers_ && !largestPool().compare_exchange_weak(largest, num_workers_)) {}
+    for (int i = 1; i < num_workers_; i++)
+      workers_.push_back(std::thread([this, i] { workerLoop(i); }));
+  }
+
+  // waits for the workers to stop, all forked tasks have to be joined
+  ~WorkStealingScheduler() {
+    {
+      std::lock_guard<std::mutex> guard(sleep_lock_);
+      stop_ = true;
+    }
+    wakeup_.notify_all();
+    for (std::thread &worker : workers_)
+      worker.join();
+    for (int i = 0; i < num_deques_.load(); i++)
+      delete deques_[i].load();
+  }
+
+  WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+  WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+  int numWorkers() const {
+    return num_workers_;
+  }
+
+  // number of the calling thread in the pool it belongs to (1 and up), -1 for threads outside the pools
+  static int workerNumber() {
+    return currentWorker();
+  }
+
+  // bound on workerNumber(), also for the runtime's scheduler before its first fork creates it
+  static int maxWorkers() {
+    return std::max(largestPool().load(), defaultWorkers());
+  }
+
+  // runs f and g in parallel, returns once both are done
+  template <typename F, typename G>
+  void invoke(const F &f, const G &g) {
+    Deque &deque = ownDeque();
+    FunctionTask<G> task(g);
+    pending_++;
+    if (!deque.push(&task)) {
+      pending_--;
+      f();
+      g();
+      return;
+    }
+    wakeWorker();
+    f();
+    // the tasks f forked are joined, so the bottom task is g unless it was stolen
+    if (deque.pop() != nullptr) {
+      pending_--;
+      g();
+      return;
+    }
+    // g was stolen, help until its thief is done
+    while (!task.done.load(std::memory_order_acquire)) {
+      if (!runOneTask(deque))
+        std::this_thread::yield();
+    }
+  }
+
+  // runs body(i) for i in [begin, end), chunks of at most grain iterations run serially
+  template <typename Body>
+  void parallelFor(int64_t begin, int64_t end, int64_t grain, const Body &body) {
+    Deque &deque = ownDeque();
+    if (grain < 1)
+      grain = 1;
+    while (end - begin > grain) {
+      if (deque.empty()) {
+        int64_t mid = begin + (end - begin) / 2;
+        invoke([&] { parallelFor(begin, mid, grain, body); },
+               [&] { parallelFor(mid, end, grain, body); });
+        return;
+      }
+      for (int64_t i = begin; i < begin + grain; i++)
+        body(i);
+      begin += grain;
+    }
+    for (int64_t i = begin; i < end; i++)
+      body(i);
+  }
+
+ private:
+  static const int kMaxDeques = 1024;
+  static const long kDequeCapacity = 1024;
+
+  // a forked task, it lives on the stack of the forking thread until it is joined
+  struct Task {
+    explicit Task(void (*run)(Task *)) : run(run), done(false) {}
+    void (*run)(Task *);
+    std::atomic<bool> done;
+  };
+
+  template <typename G>
+  struct FunctionTask : Task {
+    explicit FunctionTask(const G &g) : Task(&FunctionTask::call), g(g) {}
+    static void call(Task *task) {
+      static_cast<FunctionTask *>(task)->g();
+    }
+    const G &g;
+  };
+
+  // Chase-Lev deque with a fixed capacity, push and pop only by its owner, steal by anyone
+  class Deque {
+   public:
+    Deque() : top_(0), bottom_(0) {}
+
+    // false if the deque is full
+    bool push(Task *task) {
+      long bottom = bottom_.load(std::memory_order_relaxed);
+      if (bottom - top_.load(std::memory_order_acquire) >= kDequeCapacity)
+        return false;
+      tasks_[bottom % kDequeCapacity].store(task, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return true;
+    }
+
+    // the newest task, nullptr if the deque is empty or a thief took the last one
+    Task *pop() {
+      long bottom = bottom_.load(std::memory_order_relaxed) - 1;
+      bottom_.store(bottom, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      long top = top_.load(std::memory_order_relaxed);
+      if (top > bottom) {
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+      }
+      Task *task = tasks_[bottom % kDequeCapacity].load(std::memory_order_relaxed);
+      if (top == bottom) {
+        // the last task, the owner races the thieves for it
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+          task = nullptr;
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+      }
+      return task;
+    }
+
+    // the oldest task, nullptr if the deque is empty or another thread took it first
+    Task *steal() {
+      long top = top_.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      long bottom = bottom_.load(std::memory_order_acquire);
+      if (top >= bottom)
+        return nullptr;
+      Task *task = tasks_[top % kDequeCapacity].load(std::memory_order_relaxed);
+      if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+      return task;
+    }
+
+    bool empty() const {
+      return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::atomic<long> top_;
+    // the owner and the thieves write different ends, keep them off one cache line
+    char padding_[64];
+    std::atomic<long> bottom_;
+    std::atomic<Task *> tasks_[kDequeCapacity];
+  };
+
+  // identifies the scheduler in the deque ids of the threads
+  long id_;
+  int num_workers_;
+  // the thread that forks takes part in the work, the pool provides the other workers
+  std::vector<std::thread> workers_;
+  // allocated by the first fork of their thread
+  std::atomic<Deque *> deques_[kMaxDeques];
+  std::atomic<int> num_deques_;
+  // forked tasks that nobody has started yet
+  std::atomic<long> pending_;
+  // workers parked on wakeup_
+  std::atomic<int> sleeping_;
+  std::atomic<bool> stop_;
+  std::mutex sleep_lock_;
+  std::condition_variable wakeup_;
+
+  static long nextId() {
+    static std::atomic<long> next_id(0);
+    return next_id++;
+  }
+
+  static int &currentWorker() {
+    static thread_local int number = -1;
+    return number;
+  }
+
+  static std::atomic<int> &largestPool() {
+    static std::atomic<int> largest(0);
+    return largest;
+  }
+
+  static int defaultWorkers() {
+    const char *workers = std::getenv("GRAPHIT_NUM_WORKERS");
+    return workers != nullptr && std::atoi(workers) > 0 ? std::atoi(workers) : getWorkers();
+  }
+
+  Deque &ownDeque() {
+    // deque of the thread in every scheduler it forked in, the last one is looked up first
+    static thread_local std::vector<std::pair<long, int>> deque_ids;
+    for (auto it = deque_ids.rbegin(); it != deque_ids.rend(); ++it) {
+      if (it->first == id_)
+        return *deques_[it->second].load(std::memory_order_relaxed);
+    }
+    int deque_id = num_deques_++;
+    if (deque_id >= kMaxDeques) {
+      std::cout << "too many threads fork work-stealing tasks" << std::endl;
+      std::exit(-1);
+    }
+    Deque *deque = new Deque();
+    deques_[deque_id].store(deque, std::memory_order_release);
+    deque_ids.push_back(std::make_pair(id_, deque_id));
+    return *deque;
+  }
+
+  // wakes a parked worker for a new task. The fork raises pending_ before it reads sleeping_ and a worker
+  // counts itself in sleeping_ before it reads pending_, so at least one of them sees the other
+  void wakeWorker() {
+    if (sleeping_.load() > 0) {
+      std::lock_guard<std::mutex> guard(sleep_lock_);
+      wakeup_.notify_one();
+    }
+  }
+
+  // runs a task stolen from another deque, false if there was none. The own deque is left to the
+  // frames that forked into it, they expect to pop their task back unless a thief took it
+  bool runOneTask(Deque &own) {
+    Task *task = nullptr;
+    int num_deques = num_deques_.load();
+    static thread_local unsigned seed = std::hash<std::thread::id>()(std::this_thread::get_id());
+    int start = (seed = seed * 1103515245 + 12345) % num_deques;
+    for (int i = 0; i < num_deques && task == nullptr; i++) {
+      Deque *victim = deques_[(start + i) % num_deques].load(std::memory_order_acquire);
+      if (victim != nullptr && victim != &own)
+        task = victim->steal();
+    }
+    if (task == nullptr)
+      return false;
+    pending_--;
+    task->run(task);
+    // the forking thread may return (and free the task) as soon as it sees done
+    task->done.store(true, std::memory_order_release);
+    return true;
+  }
+
+  void workerLoop(int slot) {
+    currentWorker() = slot;
+    ThreadControl::get().addWorker(slot);
+    Deque &deque = ownDeque();
+    while (!stop_.load()) {
+      if (runOneTask(deque))
+        continue;
+      std::unique_lock<std::mutex> guard(sleep_lock_);
+      sleeping_++;
+      wakeup_.wait(guard, [this] { return pending_.load() > 0 || stop_.load(); });
+      sleeping_--;
+    }
+    ThreadControl::get().removeWorker();
+  }
+};
+
+
+// runs f and g in parallel (as cilk_spawn f(); g(); cilk_sync; would)
+template <typename F, typename G>
+static void builtin_parallelInvoke(const F &f, const G &g) {
+#if defined(CILK) || defined(CILKP)
+  cilk_spawn f();
+  g();
+  cilk_sync;
+#elif defined(OPENMP)
+  WorkStealingScheduler::get().invoke(f, g);
+#else
+  f();
+  g();
+#endif
+}
+
+// parallel loop over [begin, end) with lazy binary splitting, for loops whose body is a lambda
+template <typename Body>
+static void builtin_parallelFor(int64_t begin, int64_t end, const Body &body, int64_t grain = 256) {
+#if defined(CILK) || defined(CILKP)
+  cilk_for (int64_t i = begin; i < end; i++)
+    body(i);
+#elif defined(OPENMP)
+  WorkStealingScheduler::get().parallelFor(begin, end, grain, body);
+#else
+  for (int64_t i = begin; i < end; i++)
+    body(i);
+#endif
+}
+
+#endif //GRAPHIT_WORK_STEALING_H
@@ -0,0 +1,74 @@
+//
+// Parsing throughput of the text edge list readers
+//
+// usage: reader_benchmark <graph.el | graph.wel | graph.mtx> [trials]
+// Compares the parallel parser used by Reader::ReadFile against the
+// sequential iostream readers and reports GB/s for both.
+//
+
+#include <iostream>
+#include <string>
+#include "intrinsics.h"
+
+using namespace std;
+
+template <typename ReaderT>
+size_t parseStream(ReaderT &r, const string &filename, const string &suffix) {
+    ifstream in(filename);
+    bool needs_weights;
+    if (suffix == ".el")
+        return r.ReadInEL(in).size();
+    if (suffix == ".wel")
+        return r.ReadInWEL(in).size();
+    return r.ReadInMTX(in, needs_weights).size();
+}
+
+template <typename ReaderT>
+size_t parseParallel(ReaderT &r, const string &filename, const string &suffix) {
+    MappedFile file(filename);
+    bool needs_weights;
+    if (suffix == ".el")
+        return r.ParseEL(file).size();
+    if (suffix == ".wel")
+        return r.ParseWEL(file).size();
+    return r.ParseMTX(file, needs_weights).size();
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cout << "usage: " << argv[0] << " <graph.el|graph.wel|graph.mtx> [trials]" << endl;
+        return 1;
+    }
+    string filename = argv[1];
+    int trials = argc > 2 ? atoi(argv[2]) : 3;
+    Reader<NodeID, WNode, WeightT> r(filename);
+    string suffix = r.GetSuffix();
+    if (suffix != ".el" && suffix != ".wel" && suffix != ".mtx") {
+        cout << "only .el, .wel and .mtx files are supported" << endl;
+        return 1;
+    }
+    double gigabytes = MappedFile(filename).size() / 1e9;
+
+    double stream_best = 1e30, parallel_best = 1e30;
+    size_t stream_edges = 0, parallel_edges = 0;
+    for (int t = 0; t < trials; t++) {
+        Timer timer;
+        timer.Start();
+        stream_edges = parseStream(r, filename, suffix);
+        timer.Stop();
+        stream_best = min(stream_best, timer.Seconds());
+
+        timer.Start();
+        parallel_edges = parseParallel(r, filename, suffix);
+        timer.Stop();
+        parallel_best = min(parallel_best, timer.Seconds());
+    }
+    if (stream_edges != parallel_edges) {
+        cout << "edge count mismatch: " << stream_edges << " vs " << parallel_edges << endl;
+        return 1;
+    }
+    printf("edges:               %zu\n", parallel_edges);
+    printf("iostream:            %3.5lf s  %3.3lf GB/s\n", stream_best, gigabytes / stream_best);
+    printf("parallel:            %3.5lf s  %3.3lf GB/s\n", parallel_best, gigabytes / parallel_best);
+    return 0;
+}
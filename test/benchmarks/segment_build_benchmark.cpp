@@ -0,0 +1,73 @@
+//
+// Construction time of the segmented subgraphs
+//
+// usage: segment_build_benchmark <graph file> [segments] [trials]
+// Builds the pull segments of the graph with the serial and the parallel
+// construction, checks that both give the same segments and reports the
+// time of each.
+//
+
+#include <iostream>
+#include <string>
+#include "intrinsics.h"
+
+using namespace std;
+
+typedef GraphSegments<NodeID, NodeID> Segments;
+
+Segments *buildSegments(Graph &g, int num_segments, bool parallel) {
+    Segments *segments = new Segments(num_segments, false);
+    g.fillSegments(segments, g.segmentBoundaries(num_segments, false, true), true, parallel);
+    return segments;
+}
+
+bool sameSegments(Segments *a, Segments *b) {
+    for (int i = 0; i < a->numSegments; i++) {
+        auto sa = a->getSegmentedGraph(i);
+        auto sb = b->getSegmentedGraph(i);
+        if (sa->numVertices != sb->numVertices || sa->numEdges != sb->numEdges)
+            return false;
+        if (!equal(sa->graphId, sa->graphId + sa->numVertices, sb->graphId) ||
+            !equal(sa->vertexArray, sa->vertexArray + sa->numVertices + 1, sb->vertexArray) ||
+            !equal(sa->edgeArray, sa->edgeArray + sa->numEdges, sb->edgeArray))
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cout << "usage: " << argv[0] << " <graph file> [segments] [trials]" << endl;
+        return 1;
+    }
+    Graph g = builtin_loadEdgesFromFile(argv[1]);
+    int num_segments = argc > 2 ? atoi(argv[2]) : 16;
+    int trials = argc > 3 ? atoi(argv[3]) : 3;
+
+    double serial_best = 1e30, parallel_best = 1e30;
+    for (int t = 0; t < trials; t++) {
+        Timer timer;
+        timer.Start();
+        Segments *serial = buildSegments(g, num_segments, false);
+        timer.Stop();
+        serial_best = min(serial_best, timer.Seconds());
+
+        timer.Start();
+        Segments *parallel = buildSegments(g, num_segments, true);
+        timer.Stop();
+        parallel_best = min(parallel_best, timer.Seconds());
+
+        bool same = sameSegments(serial, parallel);
+        delete serial;
+        delete parallel;
+        if (!same) {
+            cout << "parallel segments differ from the serial build" << endl;
+            return 1;
+        }
+    }
+    printf("edges:               %" PRId64 "\n", g.num_edges_directed());
+    printf("segments:            %d\n", num_segments);
+    printf("serial:              %3.5lf s\n", serial_best);
+    printf("parallel:            %3.5lf s\n", parallel_best);
+    return 0;
+}
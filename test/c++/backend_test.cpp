@@ -210,6 +210,25 @@ TEST_F(BackendTest, ExportReturnConstantSizeVector) {
 }
 
 
+TEST_F(BackendTest, ExportFunctionsSharingConstants) {
+    istringstream is("element Vertex end\n"
+                     "element Edge end\n"
+                     "const edges : edgeset{Edge}(Vertex,Vertex);\n"
+                     "const vertices : vertexset{Vertex};\n"
+                     "const calls : int = 0;\n"
+                     "export func set_graph(input_edges : edgeset{Edge}(Vertex,Vertex)) "
+                     "      edges = input_edges;"
+                     "      vertices = edges.getVertices();"
+                     "      calls += 1;"
+                     " end\n"
+                     "export func update(batch : edgeset{Edge}(Vertex,Vertex)) -> output : int "
+                     "      edges.insertBatch(batch);"
+                     "      calls += 1;"
+                     "      output = calls;"
+                     " end");
+    EXPECT_EQ (0, basicTest(is));
+}
+
 TEST_F(BackendTest, ExportSimpleVertexSetLoadInFunction) {
     istringstream is("element Vertex end\n"
                      "element Edge end\n"
@@ -10,6 +10,7 @@
 #include <graphit/frontend/error.h>
 #include <graphit/utils/exec_cmd.h>
 #include <graphit/frontend/high_level_schedule.h>
+#include <graphit/frontend/schedule_interpreter.h>
 #include <graphit/midend/mir.h>
 
 using namespace std;
@@ -835,6 +836,133 @@ TEST_F(HighLevelScheduleTest, BFSPushParallelSchedule) {
 }
 
 
+TEST_F(HighLevelScheduleTest, BFSPushParallelThreadLocalFrontier) {
+    istringstream is (bfs_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+
+    program->configApplyDirection("s1", "SparsePush")
+            ->configApplyParallelization("s1", "dynamic-vertex-parallel")
+            ->configApplyFrontierOutput("s1", "thread-local-buffers");
+    //generate c++ code successfully
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+    mir::FuncDecl::Ptr main_func_decl = mir_context_->getFunction("main");
+    mir::WhileStmt::Ptr while_stmt = mir::to<mir::WhileStmt>((*(main_func_decl->body->stmts))[2]);
+    mir::AssignStmt::Ptr assign_stmt = mir::to<mir::AssignStmt>((*(while_stmt->body->stmts))[0]);
+    EXPECT_EQ(true, mir::isa<mir::PushEdgeSetApplyExpr>(assign_stmt->expr));
+    EXPECT_EQ(true, mir::to<mir::EdgeSetApplyExpr>(assign_stmt->expr)->use_thread_local_frontier);
+}
+
+TEST_F(HighLevelScheduleTest, BFSPushEdgeParallelSchedule) {
+    istringstream is (bfs_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+
+    program->configApplyDirection("s1", "SparsePush")
+            ->configApplyParallelization("s1", "edge-parallel", 256)
+            ->setApply("s1", "disable_deduplication");
+    //generate c++ code successfully
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+    mir::FuncDecl::Ptr main_func_decl = mir_context_->getFunction("main");
+    mir::WhileStmt::Ptr while_stmt = mir::to<mir::WhileStmt>((*(main_func_decl->body->stmts))[2]);
+    mir::AssignStmt::Ptr assign_stmt = mir::to<mir::AssignStmt>((*(while_stmt->body->stmts))[0]);
+    EXPECT_EQ(true, mir::isa<mir::PushEdgeSetApplyExpr>(assign_stmt->expr));
+    mir::PushEdgeSetApplyExpr::Ptr apply_expr = mir::to<mir::PushEdgeSetApplyExpr>(assign_stmt->expr);
+    EXPECT_EQ(true, apply_expr->is_parallel);
+    EXPECT_EQ(true, apply_expr->use_push_edge_based_load_balance);
+    EXPECT_EQ(256, apply_expr->push_edge_based_load_balance_grain_size);
+}
+
+TEST_F(HighLevelScheduleTest, BFSPushEdgeParallelGrainSize1024) {
+    istringstream is (bfs_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+
+    // an explicit 1024 is kept, only the default grain size is left to the compiler
+    program->configApplyDirection("s1", "SparsePush")
+            ->configApplyParallelization("s1", "edge-parallel", 1024);
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+    mir::FuncDecl::Ptr main_func_decl = mir_context_->getFunction("main");
+    mir::WhileStmt::Ptr while_stmt = mir::to<mir::WhileStmt>((*(main_func_decl->body->stmts))[2]);
+    mir::AssignStmt::Ptr assign_stmt = mir::to<mir::AssignStmt>((*(while_stmt->body->stmts))[0]);
+    mir::PushEdgeSetApplyExpr::Ptr apply_expr = mir::to<mir::PushEdgeSetApplyExpr>(assign_stmt->expr);
+    EXPECT_EQ(true, apply_expr->use_push_edge_based_load_balance);
+    EXPECT_EQ(1024, apply_expr->push_edge_based_load_balance_grain_size);
+}
+
+
+TEST_F(HighLevelScheduleTest, BFSHybridDenseByteCompressedSchedule) {
+    istringstream is (bfs_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+
+    program->configApplyDirection("s1", "SparsePush-DensePull")
+            ->configApplyParallelization("s1", "dynamic-vertex-parallel")
+            ->configApplyEdgeLayout("s1", "byte-compressed");
+    //generate c++ code successfully
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+    mir::FuncDecl::Ptr main_func_decl = mir_context_->getFunction("main");
+    mir::WhileStmt::Ptr while_stmt = mir::to<mir::WhileStmt>((*(main_func_decl->body->stmts))[2]);
+    mir::AssignStmt::Ptr assign_stmt = mir::to<mir::AssignStmt>((*(while_stmt->body->stmts))[0]);
+    EXPECT_EQ(true, mir::isa<mir::HybridDenseEdgeSetApplyExpr>(assign_stmt->expr));
+    mir::HybridDenseEdgeSetApplyExpr::Ptr apply_expr = mir::to<mir::HybridDenseEdgeSetApplyExpr>(assign_stmt->expr);
+    EXPECT_EQ("ByteCode", apply_expr->compressed_edge_code);
+    EXPECT_EQ("ByteCode", mir_context_->edgeset_to_compressed_edge_code["edges"]);
+    // the only apply over edges is compressed, so the CSR arrays are freed after the compressed build
+    EXPECT_EQ(0, mir_context_->edgesets_with_csr_uses.count("edges"));
+}
+
+
+TEST_F(HighLevelScheduleTest, BFSHybridDenseApplyCounters) {
+    istringstream is (bfs_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+
+    program->configApplyDirection("s1", "SparsePush-DensePull");
+    graphit::Midend *me = new graphit::Midend(context_, program->getSchedule());
+    me->emitMIR(mir_context_);
+    graphit::Backend *be = new graphit::Backend(mir_context_);
+    std::ostringstream generated;
+    EXPECT_EQ (0, be->emitCPP(generated, "", true));
+    // the labeled apply is bracketed by the counters and the hybrid apply reports its direction
+    std::string code = generated.str();
+    EXPECT_NE(std::string::npos, code.find("builtin_beginApplyCounter(\"s1\", edges, frontier, \"hybrid\");"));
+    EXPECT_NE(std::string::npos, code.find("builtin_endApplyCounter(frontier);"));
+    EXPECT_NE(std::string::npos, code.find("builtin_recordApplyDirection(\"pull\");"));
+    EXPECT_NE(std::string::npos, code.find("builtin_recordApplyDirection(\"push\");"));
+}
+
+
+TEST_F(HighLevelScheduleTest, SSSPPushRCMVertexOrderSchedule) {
+    istringstream is (sssp_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+
+    program->configApplyDirection("s1", "SparsePush")
+            ->configApplyParallelization("s1", "dynamic-vertex-parallel")
+            ->configApplyVertexOrder("s1", "rcm");
+    graphit::Midend *me = new graphit::Midend(context_, program->getSchedule());
+    me->emitMIR(mir_context_);
+    graphit::Backend *be = new graphit::Backend(mir_context_);
+    std::ostringstream generated;
+    EXPECT_EQ (0, be->emitCPP(generated));
+    EXPECT_EQ("VertexOrder::RCM", mir_context_->edgeset_to_vertex_order["edges"]);
+    // the edgeset is relabeled after loading and the source vertex of main is translated
+    std::string code = generated.str();
+    EXPECT_NE(std::string::npos, code.find("edges = builtin_relabelEdges(edges, VertexOrder::RCM);"));
+    EXPECT_NE(std::string::npos, code.find("builtin_addVertex(frontier, builtin_relabeledVertex(edges, (0) ) )"));
+    EXPECT_NE(std::string::npos, code.find("SP[builtin_relabeledVertex(edges, (0) ) ] = (0) ;"));
+    // the apply function keeps working on relabeled ids
+    EXPECT_EQ(std::string::npos, code.find("builtin_relabeledVertex(edges, src"));
+}
+
+
 TEST_F(HighLevelScheduleTest, BFSPushSlidingQueueSchedule) {
     istringstream is (bfs_str_);
     fe_->parseStream(is, context_, errors_);
@@ -942,6 +1070,41 @@ TEST_F(HighLevelScheduleTest, CCHybridDenseTwoSegments) {
     EXPECT_EQ(true, mir::isa<mir::HybridDenseEdgeSetApplyExpr>(assign_stmt->expr));
 }
 
+TEST_F(HighLevelScheduleTest, CCHybridDenseDirectionThreshold) {
+    istringstream is (cc_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+
+    program->configApplyDirection("s1", "SparsePush-DensePull")->configApplyParallelization("s1", "dynamic-vertex-parallel")->configApplyDirectionThreshold("s1", 10);
+    //generate c++ code successfully
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+    mir::FuncDecl::Ptr main_func_decl = mir_context_->getFunction("main");
+    mir::WhileStmt::Ptr while_stmt = mir::to<mir::WhileStmt>((*(main_func_decl->body->stmts))[3]);
+    mir::AssignStmt::Ptr assign_stmt = mir::to<mir::AssignStmt>((*(while_stmt->body->stmts))[0]);
+    EXPECT_EQ(true, mir::isa<mir::HybridDenseEdgeSetApplyExpr>(assign_stmt->expr));
+    mir::EdgeSetApplyExpr::Ptr apply_expr = mir::to<mir::EdgeSetApplyExpr>(assign_stmt->expr);
+    EXPECT_EQ(10, apply_expr->direction_threshold);
+    EXPECT_EQ(false, apply_expr->adaptive_direction);
+}
+
+TEST_F(HighLevelScheduleTest, CCHybridDenseAdaptiveDirection) {
+    istringstream is (cc_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+
+    program->configApplyDirection("s1", "SparsePush-DensePull")->configApplyParallelization("s1", "dynamic-vertex-parallel")->configApplyDirectionThreshold("s1", "adaptive");
+    //generate c++ code successfully
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+    mir::FuncDecl::Ptr main_func_decl = mir_context_->getFunction("main");
+    mir::WhileStmt::Ptr while_stmt = mir::to<mir::WhileStmt>((*(main_func_decl->body->stmts))[3]);
+    mir::AssignStmt::Ptr assign_stmt = mir::to<mir::AssignStmt>((*(while_stmt->body->stmts))[0]);
+    mir::EdgeSetApplyExpr::Ptr apply_expr = mir::to<mir::EdgeSetApplyExpr>(assign_stmt->expr);
+    EXPECT_EQ(20, apply_expr->direction_threshold);
+    EXPECT_EQ(true, apply_expr->adaptive_direction);
+}
+
 TEST_F(HighLevelScheduleTest, CCHybridDenseBitvectorFrontierSchedule) {
     istringstream is (cc_str_);
     fe_->parseStream(is, context_, errors_);
@@ -1076,6 +1239,19 @@ TEST_F(HighLevelScheduleTest, PRPullParallelTwoSegments) {
 }
 
 
+TEST_F(HighLevelScheduleTest, PRPullParallelEdgeAwareSegments) {
+    istringstream is (pr_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+    // Set the pull parameter to 2 segments with about the same number of edges
+    program->configApplyDirection("l1:s1", "DensePull")->configApplyParallelization("l1:s1", "dynamic-vertex-parallel");
+    program->configApplyNumSSG("l1:s1", "edge-aware-vertex-count",  2, "DensePull");
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+    EXPECT_EQ (1, mir_context_->edgeset_to_edge_aware_segment_labels["edges"].count("l1:s1"));
+}
+
+
 TEST_F(HighLevelScheduleTest, PRPullParallelRuntimeSegmentArgs) {
     istringstream is (pr_str_);
     fe_->parseStream(is, context_, errors_);
@@ -1117,6 +1293,48 @@ TEST_F(HighLevelScheduleTest, PRPullParallelNumaAware) {
 
 }
 
+TEST_F(HighLevelScheduleTest, PRPullParallelNumaAwareReplicatedField) {
+    istringstream is (pr_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+    program->configApplyDirection("l1:s1", "DensePull")->configApplyParallelization("l1:s1", "dynamic-vertex-parallel");
+    program->configApplyNumSSG("l1:s1", "fixed-vertex-count",  2, "DensePull");
+    program->configApplyNUMA("l1:s1", "static-parallel", "DensePull");
+    program->configVectorNUMA("out_degrees", "replicated")->configVectorNUMA("new_rank", "replicated");
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+
+    // new_rank is written by the apply, only out_degrees is read from the copies
+    EXPECT_EQ (1, mir_context_->edgeset_to_label_to_merge_reduce["edges"].size());
+    auto merge_reduce = mir_context_->edgeset_to_label_to_merge_reduce["edges"].begin()->second;
+    EXPECT_EQ ("new_rank", merge_reduce->field_name);
+    EXPECT_EQ (1, merge_reduce->replicated_fields.size());
+    EXPECT_EQ ("out_degrees", merge_reduce->replicated_fields[0]);
+}
+
+TEST_F(HighLevelScheduleTest, PRPullParallelVectorNUMAPlacement) {
+    istringstream is (pr_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+    program->configApplyDirection("l1:s1", "DensePull")->configApplyParallelization("l1:s1", "dynamic-vertex-parallel");
+    program->configVectorNUMA("old_rank", "interleaved")->configVectorNUMA("new_rank", "partitioned");
+    program->configVectorNUMA("error", "first-touch");
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+
+    EXPECT_EQ (2, mir_context_->vector_to_numa_placement.size());
+    EXPECT_EQ ("builtin_numaInterleave", mir_context_->vector_to_numa_placement["old_rank"]);
+    EXPECT_EQ ("builtin_numaPartition", mir_context_->vector_to_numa_placement["new_rank"]);
+}
+
+TEST_F(HighLevelScheduleTest, PRPullParallelVectorNUMAUnsupportedPlacement) {
+    istringstream is (pr_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+    EXPECT_ANY_THROW (program->configVectorNUMA("old_rank", "striped"));
+}
+
 TEST_F(HighLevelScheduleTest, PRPullVertexsetParallel) {
     istringstream is (pr_str_);
     fe_->parseStream(is, context_, errors_);
@@ -1139,6 +1357,40 @@ TEST_F(HighLevelScheduleTest, PRPullVertexsetParallel) {
 
 }
 
+TEST_F(HighLevelScheduleTest, PRPullParallelSimdKernel) {
+    istringstream is (pr_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+    program->configApplyDirection("l1:s1", "DensePull")->configApplyParallelization("l1:s1", "dynamic-vertex-parallel");
+    program->configApplyPullKernel("l1:s1", "simd");
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+
+    mir::FuncDecl::Ptr main_func_decl = mir_context_->getFunction("main");
+    mir::ForStmt::Ptr for_stmt = mir::to<mir::ForStmt>((*(main_func_decl->body->stmts))[0]);
+    mir::ExprStmt::Ptr expr_stmt = mir::to<mir::ExprStmt>((*(for_stmt->body->stmts))[0]);
+    EXPECT_EQ(true, mir::isa<mir::PullEdgeSetApplyExpr>(expr_stmt->expr));
+    EXPECT_EQ(true, mir::to<mir::EdgeSetApplyExpr>(expr_stmt->expr)->use_simd_pull);
+
+    // new_rank[dst] += old_rank[src] / out_degrees[src] is reduced in float
+    EXPECT_EQ (1, mir_context_->function_to_simd_pull_reduce.count("updateEdge"));
+    mir::SimdPullReduce::Ptr reduce = mir_context_->function_to_simd_pull_reduce["updateEdge"];
+    EXPECT_EQ (mir::ReduceStmt::ReductionOp::SUM, reduce->reduce_op);
+    EXPECT_EQ (mir::ScalarType::Type::FLOAT, reduce->scalar_type->type);
+    EXPECT_EQ ("src", reduce->src_name);
+}
+
+TEST_F(HighLevelScheduleTest, PRSimdKernelUnsupportedSchedule) {
+    istringstream is (pr_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+    EXPECT_ANY_THROW (program->configApplyPullKernel("l1:s1", "avx"));
+    // only the pull direction reduces in-neighbors
+    program->configApplyDirection("l1:s1", "SparsePush")->configApplyPullKernel("l1:s1", "simd");
+    EXPECT_ANY_THROW (basicTestWithSchedule(program));
+}
+
 
 TEST_F(HighLevelScheduleTest, PRPushParallel) {
     istringstream is (pr_str_);
@@ -1559,6 +1811,42 @@ TEST_F(HighLevelScheduleTest, SSSPPushParallelSlidingQueueSchedule) {
     EXPECT_EQ (0,  basicTestWithSchedule(program_schedule_node));
 }
 
+TEST_F(HighLevelScheduleTest, SSSPDeltaSteppingSchedule) {
+    istringstream is ("element Vertex end\n"
+                              "element Edge end\n"
+                              "const edges : edgeset{Edge}(Vertex,Vertex, int) = load (\"../test/graphs/test.wel\");\n"
+                              "const vertices : vertexset{Vertex} = edges.getVertices();\n"
+                              "const SP : vector{Vertex}(int) = 2147483647; %should be INT_MAX \n"
+                              "func updateEdge(src : Vertex, dst : Vertex, weight : int)\n"
+                              "    SP[dst] min= (SP[src] + weight);\n"
+                              "end\n"
+                              "func main() \n"
+                              "    var frontier : vertexset{Vertex} = new vertexset{Vertex}(0);\n"
+                              "    frontier.addVertex(0); %add source vertex \n"
+                              "    SP[0] = 0;\n"
+                              "    #s1# edges.from(frontier).applyUpdatePriority(updateEdge, SP);\n"
+                              "end");
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program_schedule_node
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+    // the direction is ignored, ordered applies always push from the current bucket
+    program_schedule_node->configApplyDirection("s1", "DensePull")
+            ->configApplyParallelization("s1", "dynamic-vertex-parallel")
+            ->configApplyPriorityUpdateDelta("s1", 4);
+    fe_->parseStream(is, context_, errors_);
+
+    EXPECT_EQ (0,  basicTestWithSchedule(program_schedule_node));
+
+    mir::FuncDecl::Ptr main_func_decl = mir_context_->getFunction("main");
+    mir::ExprStmt::Ptr expr_stmt = mir::to<mir::ExprStmt>((*(main_func_decl->body->stmts))[3]);
+
+    EXPECT_EQ(true, mir::isa<mir::PushEdgeSetApplyExpr>(expr_stmt->expr));
+    mir::PushEdgeSetApplyExpr::Ptr apply_expr = mir::to<mir::PushEdgeSetApplyExpr>(expr_stmt->expr);
+    EXPECT_EQ(true, apply_expr->is_ordered);
+    EXPECT_EQ(true, apply_expr->is_parallel);
+    EXPECT_EQ(4, apply_expr->priority_update_delta);
+    EXPECT_EQ("SP", apply_expr->tracking_field);
+}
+
 
 TEST_F(HighLevelScheduleTest, SimpleParallelVertexSetApply){
     istringstream is("element Vertex end\n"
@@ -1653,6 +1941,60 @@ TEST_F(HighLevelScheduleTest, PageRankDeltaSparsePushParallel) {
     EXPECT_EQ (0, basicTestWithSchedule(program));
 }
 
+TEST_F(HighLevelScheduleTest, PageRankDeltaHybridDenseForwardTwoSegments) {
+    istringstream is (prd_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+    program->configApplyDirection("s1", "SparsePush-DensePush")->configApplyParallelization("s1", "dynamic-vertex-parallel")->configApplyNumSSG("s1", "fixed-vertex-count",  2, "DensePush");
+
+    // generate c++ code successfully
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+    EXPECT_EQ (1, mir_context_->edgeset_to_push_segment_labels.size());
+}
+
+TEST_F(HighLevelScheduleTest, PageRankDeltaDensePushSegmentsRejected) {
+    istringstream is (prd_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+    // only the DensePush half of SparsePush-DensePush reads push segments, a push apply would ignore them
+    program->configApplyDirection("s1", "SparsePush");
+    EXPECT_ANY_THROW (program->configApplyNumSSG("s1", "fixed-vertex-count", 2, "DensePush"));
+    EXPECT_ANY_THROW (program->configApplyNumSSG("s1", "fixed-vertex-count", "argv[2]", "DensePush"));
+    program->configApplyDirection("s1", "SparsePush-DensePull");
+    EXPECT_ANY_THROW (program->configApplyNumSSG("s1", "fixed-vertex-count", 2, "DensePush"));
+}
+
+TEST_F(HighLevelScheduleTest, PageRankDeltaHybridDenseForwardEdgeAwareParallel) {
+    istringstream is (prd_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+    program->configApplyDirection("s1", "SparsePush-DensePush")->configApplyParallelization("s1", "dynamic-vertex-parallel");
+    program->configApplyParallelization("s1", "edge-aware-dynamic-vertex-parallel", 64, "DensePush");
+
+    // generate c++ code successfully
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+    EXPECT_EQ (ApplySchedule::PushLoadBalance::EDGE_BASED, (*program->getSchedule()->apply_schedules)["s1"].dense_push_load_balance_type);
+    EXPECT_EQ (ApplySchedule::PullLoadBalance::VERTEX_BASED, (*program->getSchedule()->apply_schedules)["s1"].pull_load_balance_type);
+    EXPECT_EQ (64, (*program->getSchedule()->apply_schedules)["s1"].dense_push_load_balance_edge_grain_size);
+}
+
+TEST_F(HighLevelScheduleTest, PageRankDeltaHybridDenseForwardEdgeAwareParallelGrainSize1024) {
+    istringstream is (prd_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+    program->configApplyDirection("s1", "SparsePush-DensePush")->configApplyParallelization("s1", "dynamic-vertex-parallel");
+    // an explicit 1024 is kept, only the default grain size is left to the compiler
+    program->configApplyParallelization("s1", "edge-aware-dynamic-vertex-parallel", 1024, "DensePush");
+
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+    EXPECT_EQ (ApplySchedule::PushLoadBalance::EDGE_BASED, (*program->getSchedule()->apply_schedules)["s1"].dense_push_load_balance_type);
+    EXPECT_EQ (1024, (*program->getSchedule()->apply_schedules)["s1"].dense_push_load_balance_edge_grain_size);
+}
+
 TEST_F(HighLevelScheduleTest, PageRankDeltaPullParallelFuseFields) {
     istringstream is (prd_str_);
     fe_->parseStream(is, context_, errors_);
@@ -1815,3 +2157,55 @@ TEST_F(HighLevelScheduleTest, ExportCFWithScheduleTest){
             ->configApplyParallelization("s1", "dynamic-vertex-parallel");
     EXPECT_EQ (0, basicTestWithSchedule(program));
 }
+
+TEST_F(HighLevelScheduleTest, InterpretedScheduleMatchesCompiledSchedule) {
+    istringstream is(bfs_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+
+    std::vector<ParseError> schedule_errors;
+    ScheduleInterpreter interpreter(program, &schedule_errors);
+    EXPECT_TRUE (interpreter.interpret(
+            "    program->configApplyDirection(\"s1\", \"SparsePush-DensePull\") // hybrid\n"
+            "        ->configApplyParallelization(\"s1\", \"dynamic-vertex-parallel\")\n"
+            "        ->configApplyDenseVertexSet(\"s1\",\"bitvector\", \"src-vertexset\", \"DensePull\");\n"
+            "    /* segments */ program->configApplyNumSSG(\"s1\", \"fixed-vertex-count\", 10, \"DensePull\");\n"));
+    EXPECT_EQ (0, schedule_errors.size());
+
+    auto schedule = (*program->getSchedule()->apply_schedules)["s1"];
+    EXPECT_EQ (ApplySchedule::DirectionType::HYBRID_DENSE, schedule.direction_type);
+    EXPECT_EQ (ApplySchedule::ParType::Parallel, schedule.parallel_type);
+    EXPECT_EQ (ApplySchedule::PullFrontierType::BITVECTOR, schedule.pull_frontier_type);
+    EXPECT_EQ (10, schedule.num_segment);
+
+    EXPECT_EQ (0, basicTestWithSchedule(program));
+}
+
+TEST_F(HighLevelScheduleTest, InterpretedScheduleReportsErrors) {
+    istringstream is(bfs_str_);
+    fe_->parseStream(is, context_, errors_);
+    fir::high_level_schedule::ProgramScheduleNode::Ptr program
+            = std::make_shared<fir::high_level_schedule::ProgramScheduleNode>(context_);
+
+    std::vector<ParseError> schedule_errors;
+    ScheduleInterpreter interpreter(program, &schedule_errors);
+    EXPECT_FALSE (interpreter.interpret("program->configApplyDirection(\"s1\", 3);", 12));
+    EXPECT_EQ (1, schedule_errors.size());
+    EXPECT_EQ (12, schedule_errors[0].getFirstLine());
+
+    schedule_errors.clear();
+    EXPECT_FALSE (interpreter.interpret("program->configApplyDirection(\"s1\", \"DensePull\")"));
+    EXPECT_EQ (1, schedule_errors.size());
+}
+
+TEST_F(HighLevelScheduleTest, SplitScheduleBlock) {
+    istringstream is("element Vertex end\n"
+                     "func main() end\n"
+                     "schedule:\n"
+                     "    program->configApplyDirection(\"s1\", \"DensePull\");\n");
+    std::string algorithm, schedule;
+    EXPECT_EQ (3, splitScheduleBlock(is, algorithm, schedule));
+    EXPECT_EQ ("element Vertex end\nfunc main() end\n\n", algorithm);
+    EXPECT_EQ ("    program->configApplyDirection(\"s1\", \"DensePull\");\n", schedule);
+}
@@ -113,6 +113,171 @@ TEST_F(RuntimeLibTest, VertexSubsetSimpleTest) {
 
 }
 
+TEST_F(RuntimeLibTest, VertexSubsetBitmapTest) {
+    // spans several words, with empty words in between
+    int range = 1000;
+    auto sparse = new VertexSubset<int>(range, 0);
+    for (int v = 3; v < range; v = v + 97)
+        sparse->addVertex(v);
+    sparse->toSparse();
+    sparse->toBitmap();
+
+    // a frontier produced as a bitvector only
+    Bitmap * bits = new Bitmap(range);
+    bits->reset();
+    for (int v = 3; v < range; v = v + 97)
+        bits->set_bit(v);
+    auto dense = new VertexSubset<int>(range, 0);
+    dense->setBitmap(bits);
+
+    EXPECT_EQ(sparse->size(), dense->size());
+    EXPECT_EQ(true, dense->contains(100));
+    EXPECT_EQ(false, dense->contains(101));
+
+    int count = 0;
+    builtin_vertexset_apply(dense, [&](int v) { __sync_fetch_and_add(&count, 1); });
+    EXPECT_EQ(sparse->size(), count);
+
+    dense->toSparse();
+    for (int i = 0; i < dense->size(); i++)
+        EXPECT_EQ(sparse->dense_vertex_set_[i], dense->dense_vertex_set_[i]);
+
+    dense->toDense();
+    for (int v = 0; v < range; v++)
+        EXPECT_EQ(sparse->bitmap_->get_bit(v), dense->bool_map_[v]);
+
+    // the full set does not count the bits past the end of the last word
+    auto full = new VertexSubset<int>(range, range);
+    EXPECT_EQ(range, full->bitmap_->count());
+
+    delete sparse;
+    delete dense;
+    delete full;
+}
+
+TEST_F(RuntimeLibTest, BucketPriorityQueueTest) {
+    int priorities[4] = {50, 52, 0, 0};
+    BucketPriorityQueue<int> pq(priorities, 4, 10);
+    auto frontier = new VertexSubset<int>(4, 0);
+    frontier->addVertex(0);
+    frontier->addVertex(1);
+    pq.insert(frontier);
+    delete frontier;
+
+    // vertex 1 moves to bucket 3, its copy left in bucket 5 is stale
+    priorities[1] = 31;
+    frontier = new VertexSubset<int>(4, 0);
+    frontier->addVertex(1);
+    pq.insert(frontier);
+    delete frontier;
+    VertexSubset<int> *ready = pq.dequeueReadySet();
+    EXPECT_EQ (3, pq.getCurrentBucket());
+    EXPECT_EQ (1, ready->size());
+    delete ready;
+
+    // a negative weight moves vertex 0 below the current bucket, it is processed next
+    priorities[0] = 12;
+    frontier = new VertexSubset<int>(4, 0);
+    frontier->addVertex(0);
+    pq.insert(frontier);
+    delete frontier;
+    ready = pq.dequeueReadySet();
+    EXPECT_EQ (1, pq.getCurrentBucket());
+    EXPECT_EQ (1, ready->size());
+    EXPECT_TRUE (ready->contains(0));
+    delete ready;
+
+    // only the stale copies are left
+    ready = pq.dequeueReadySet();
+    EXPECT_EQ (0, ready->size());
+    EXPECT_TRUE (pq.finished());
+    delete ready;
+}
+
+TEST_F(RuntimeLibTest, BucketPriorityQueueBelowWindowTest) {
+    // both vertices are beyond the first window, it moves up to bucket 150
+    int priorities[3] = {1500, 1510, 0};
+    BucketPriorityQueue<int> pq(priorities, 3, 10);
+    auto frontier = new VertexSubset<int>(3, 0);
+    frontier->addVertex(0);
+    frontier->addVertex(1);
+    pq.insert(frontier);
+    delete frontier;
+    VertexSubset<int> *ready = pq.dequeueReadySet();
+    EXPECT_EQ (150, pq.getCurrentBucket());
+    EXPECT_EQ (1, ready->size());
+    EXPECT_TRUE (ready->contains(0));
+    delete ready;
+
+    // smaller keys than the window holds, the window moves back down to them
+    priorities[1] = 5;
+    priorities[2] = 20;
+    frontier = new VertexSubset<int>(3, 0);
+    frontier->addVertex(1);
+    frontier->addVertex(2);
+    pq.insert(frontier);
+    delete frontier;
+    ready = pq.dequeueReadySet();
+    EXPECT_EQ (0, pq.getCurrentBucket());
+    EXPECT_EQ (1, ready->size());
+    EXPECT_TRUE (ready->contains(1));
+    delete ready;
+    ready = pq.dequeueReadySet();
+    EXPECT_EQ (2, pq.getCurrentBucket());
+    EXPECT_EQ (1, ready->size());
+    EXPECT_TRUE (ready->contains(2));
+    delete ready;
+
+    // the copy of vertex 1 left in bucket 151 is stale
+    ready = pq.dequeueReadySet();
+    EXPECT_EQ (0, ready->size());
+    EXPECT_TRUE (pq.finished());
+    delete ready;
+}
+
+TEST_F(RuntimeLibTest, FrontierPoolRecycleTest) {
+    bool * first = FrontierPool::allocate<bool>(100000);
+    EXPECT_EQ(true, FrontierPool::release(first));
+    // the same size class gets the released buffer back
+    bool * second = FrontierPool::allocate<bool>(90000);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(true, FrontierPool::release(second));
+
+    // large buffers use finer classes, a request only slightly larger does not share the buffer
+    char * large = FrontierPool::allocate<char>(5 << 20);
+    EXPECT_EQ(true, FrontierPool::release(large));
+    char * larger = FrontierPool::allocate<char>(7 << 20);
+    EXPECT_NE(large, larger);
+    char * same_class = FrontierPool::allocate<char>((5 << 20) - 4096);
+    EXPECT_EQ(large, same_class);
+    FrontierPool::release(larger);
+    FrontierPool::release(same_class);
+
+    // buffers that do not come from the pool are left to the caller
+    bool * other = newA(bool, 100);
+    EXPECT_EQ(false, FrontierPool::release(other));
+    free(other);
+
+    // a full vertexset hands its buffers back to the pool when deleted
+    auto full = new VertexSubset<int>(5000, 5000);
+    unsigned int * dense = full->dense_vertex_set_;
+    delete full;
+    unsigned int * reused = FrontierPool::allocate<unsigned int>(5000);
+    EXPECT_EQ(dense, reused);
+    FrontierPool::release(reused);
+}
+
+TEST_F(RuntimeLibTest, OutOffsetsTest) {
+    Graph g = builtin_loadEdgesFromFile("../../test/graphs/test.el");
+    EXPECT_EQ(nullptr, g.get_out_offsets_());
+    g.SetUpOutOffsets();
+    SGOffset * offsets = g.get_out_offsets_();
+    EXPECT_EQ(0, offsets[0]);
+    for (NodeID v = 0; v < g.num_nodes(); v++)
+        EXPECT_EQ(g.out_degree(v), offsets[v + 1] - offsets[v]);
+    EXPECT_EQ(g.num_edges_directed(), offsets[g.num_nodes()]);
+}
+
 TEST_F(RuntimeLibTest, GetRandomOutNeighborTest) {
     Graph g = builtin_loadEdgesFromFile("../../test/graphs/test.el");
     NodeID ngh = g.get_random_out_neigh(1);
@@ -146,3 +311,643 @@ TEST_F(RuntimeLibTest, SweepCutTest) {
 
     EXPECT_EQ (vset_cut->size() , 2);
 }
+
+TEST_F(RuntimeLibTest, MapSerializedGraphTest) {
+    Reader<NodeID> r("../../test/graphs/4.sg");
+    Graph read_g = r.ReadSerializedGraph();
+    Graph mapped_g = builtin_loadEdgesFromFile("../../test/graphs/4.sg");
+    EXPECT_EQ (read_g.num_nodes(), mapped_g.num_nodes());
+    EXPECT_EQ (read_g.num_edges(), mapped_g.num_edges());
+    for (NodeID n = 0; n < read_g.num_nodes(); n++) {
+        EXPECT_EQ (read_g.out_degree(n), mapped_g.out_degree(n));
+        EXPECT_EQ (read_g.in_degree(n), mapped_g.in_degree(n));
+        for (int i = 0; i < read_g.out_degree(n); i++)
+            EXPECT_EQ (read_g.out_neigh(n).begin()[i], mapped_g.out_neigh(n).begin()[i]);
+    }
+}
+
+TEST_F(RuntimeLibTest, MapAlignedSerializedGraphTest) {
+    Graph g = builtin_loadEdgesFromFile("../../test/graphs/4.el");
+    WriterBase<NodeID> w(g);
+    w.WriteGraph("4_mappable.sg", true, true);
+    Graph mapped_g = builtin_loadEdgesFromFile("4_mappable.sg");
+    EXPECT_EQ (g.num_nodes(), mapped_g.num_nodes());
+    EXPECT_EQ (g.num_edges(), mapped_g.num_edges());
+    for (NodeID n = 0; n < g.num_nodes(); n++) {
+        EXPECT_EQ (g.out_degree(n), mapped_g.out_degree(n));
+        EXPECT_EQ (g.in_degree(n), mapped_g.in_degree(n));
+        for (int i = 0; i < g.in_degree(n); i++)
+            EXPECT_EQ (g.in_neigh(n).begin()[i], mapped_g.in_neigh(n).begin()[i]);
+    }
+    std::remove("4_mappable.sg");
+}
+
+TEST_F(RuntimeLibTest, ParallelTextParserTest) {
+    Reader<NodeID, WNode, WeightT> r("../../test/graphs/4.wel");
+    std::ifstream in("../../test/graphs/4.wel");
+    auto expected = r.ReadInWEL(in);
+    auto parsed = r.ParseWEL(MappedFile("../../test/graphs/4.wel"));
+    EXPECT_EQ (expected.size(), parsed.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ (expected[i].u, parsed[i].u);
+        EXPECT_EQ (expected[i].v.v, parsed[i].v.v);
+        EXPECT_EQ (expected[i].v.w, parsed[i].v.w);
+    }
+
+    Reader<NodeID> mtx_reader("../../test/graphs/4.mtx");
+    std::ifstream mtx_in("../../test/graphs/4.mtx");
+    bool expected_needs_weights, parsed_needs_weights;
+    auto expected_mtx = mtx_reader.ReadInMTX(mtx_in, expected_needs_weights);
+    auto parsed_mtx = mtx_reader.ParseMTX(MappedFile("../../test/graphs/4.mtx"), parsed_needs_weights);
+    EXPECT_EQ (expected_needs_weights, parsed_needs_weights);
+    EXPECT_EQ (expected_mtx.size(), parsed_mtx.size());
+    for (size_t i = 0; i < expected_mtx.size(); i++) {
+        EXPECT_EQ (expected_mtx[i].u, parsed_mtx[i].u);
+        EXPECT_EQ (expected_mtx[i].v, parsed_mtx[i].v);
+    }
+}
+
+TEST_F(RuntimeLibTest, CompressedGraphTest) {
+    WGraph g = builtin_loadWeightedEdgesFromFile("../../test/graphs/4.wel");
+    g.buildCompressedGraph<NibbleCode>();
+    for (NodeID n = 0; n < g.num_nodes(); n++) {
+        std::vector<WNode> expected(g.out_neigh(n).begin(), g.out_neigh(n).end());
+        std::vector<WNode> decoded;
+        for (WNode d : g.compressed_out_neigh<NibbleCode>(n))
+            decoded.push_back(d);
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ (expected.size(), decoded.size());
+        for (size_t i = 0; i < expected.size() && i < decoded.size(); i++) {
+            EXPECT_EQ (expected[i].v, decoded[i].v);
+            EXPECT_EQ (expected[i].w, decoded[i].w);
+        }
+    }
+
+    // large gaps and negative first deltas take several units
+    Graph h = builtin_loadEdgesFromFile("../../test/graphs/test.el");
+    h.buildCompressedGraph<ByteCode>();
+    for (NodeID n = 0; n < h.num_nodes(); n++) {
+        std::vector<NodeID> decoded;
+        for (NodeID d : h.compressed_in_neigh<ByteCode>(n))
+            decoded.push_back(d);
+        EXPECT_EQ (std::vector<NodeID>(h.in_neigh(n).begin(), h.in_neigh(n).end()), decoded);
+    }
+    uint8_t buffer[16] = {0};
+    int64_t end = ByteCode::Encode(buffer, 0, ZigZagEncode(-1000000));
+    int64_t pos = 0;
+    EXPECT_EQ (-1000000, ZigZagDecode(ByteCode::Decode(buffer, pos)));
+    EXPECT_EQ (end, pos);
+    end = NibbleCode::Encode(buffer, 1, 123456789);
+    pos = 1;
+    EXPECT_EQ (123456789u, NibbleCode::Decode(buffer, pos));
+    EXPECT_EQ (end, pos);
+}
+
+TEST_F(RuntimeLibTest, CompressedGraphReleaseCSRTest) {
+    Graph csr = builtin_loadEdgesFromFile("../../test/graphs/test.el");
+    Graph g = builtin_loadEdgesFromFile("../../test/graphs/test.el");
+    g.buildCompressedGraph<ByteCode>(true);
+    EXPECT_EQ (false, g.has_csr());
+    EXPECT_EQ (nullptr, g.get_out_index_());
+    EXPECT_EQ (nullptr, g.get_out_neighbors_());
+    EXPECT_EQ (nullptr, g.get_in_index_());
+    EXPECT_EQ (nullptr, g.get_in_neighbors_());
+    EXPECT_EQ (nullptr, g.out_neighbors_shared_);
+    EXPECT_EQ (nullptr, g.in_neighbors_shared_);
+    EXPECT_EQ (csr.num_edges(), g.num_edges());
+    // degrees and edge offsets now come from the compressed lists
+    g.SetUpOutOffsets();
+    for (NodeID n = 0; n < g.num_nodes(); n++) {
+        EXPECT_EQ (csr.out_degree(n), g.out_degree(n));
+        EXPECT_EQ (csr.in_degree(n), g.in_degree(n));
+        EXPECT_EQ (csr.get_offsets_()[n + 1], g.get_offsets_()[n + 1]);
+        EXPECT_EQ (g.get_out_offsets_()[n] + g.out_degree(n), g.get_out_offsets_()[n + 1]);
+        std::vector<NodeID> decoded;
+        for (NodeID d : g.compressed_out_neigh<ByteCode>(n))
+            decoded.push_back(d);
+        std::vector<NodeID> expected(csr.out_neigh(n).begin(), csr.out_neigh(n).end());
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ (expected, decoded);
+    }
+}
+
+TEST_F(RuntimeLibTest, RelabelGraphTest) {
+    WGraph g = builtin_loadWeightedEdgesFromFile("../../test/graphs/4.wel");
+    for (VertexOrder order : {VertexOrder::DEGREE_SORT, VertexOrder::HUB_CLUSTER, VertexOrder::RCM}) {
+        WGraph h = builtin_relabelEdges(g, order);
+        EXPECT_EQ (g.num_edges(), h.num_edges());
+        for (NodeID n = 0; n < g.num_nodes(); n++) {
+            NodeID r = h.relabeled_id(n);
+            EXPECT_EQ (n, h.original_id(r));
+            // every weighted edge keeps its weight under the new ids, in both directions
+            std::vector<WNode> expected;
+            for (WNode d : g.out_neigh(n))
+                expected.push_back(WNode(h.relabeled_id(d.v), d.w));
+            std::sort(expected.begin(), expected.end());
+            EXPECT_EQ (expected, std::vector<WNode>(h.out_neigh(r).begin(), h.out_neigh(r).end()));
+            EXPECT_EQ (g.in_degree(n), h.in_degree(r));
+        }
+    }
+
+    // degree sort puts the vertices of highest total degree first
+    Graph t = builtin_loadEdgesFromFile("../../test/graphs/test.el");
+    Graph d = builtin_relabelEdges(t, VertexOrder::DEGREE_SORT);
+    for (NodeID n = 1; n < d.num_nodes(); n++)
+        EXPECT_GE (d.out_degree(n - 1) + d.in_degree(n - 1), d.out_degree(n) + d.in_degree(n));
+    // a second order composes with the first one
+    Graph c = builtin_relabelEdges(d, VertexOrder::RCM);
+    for (NodeID n = 0; n < t.num_nodes(); n++) {
+        EXPECT_EQ (n, c.original_id(c.relabeled_id(n)));
+        EXPECT_EQ (t.out_degree(n), c.out_degree(c.relabeled_id(n)));
+    }
+}
+
+TEST_F(RuntimeLibTest, SortedBuildTest) {
+    typedef EdgePair<NodeID, WNode> Edge;
+    pvector<Edge> el;
+    NodeID edges[][3] = {{3, 1, 5}, {0, 2, 4}, {3, 1, 2}, {2, 2, 7}, {1, 0, 3}, {3, 0, 1}, {3, 1, 9}, {0, 2, 4}};
+    for (auto &e : edges)
+        el.push_back(Edge(e[0], WNode(e[1], e[2])));
+    pvector<Edge> el_copy(el.begin(), el.end());
+    CLBase cli(0, NULL);
+    BuilderBase<NodeID, WNode, WeightT> sorted_builder(cli);
+    sorted_builder.needs_weights_ = false;
+    WGraph sorted = sorted_builder.MakeSortedGraphFromEL(el);
+    BuilderBase<NodeID, WNode, WeightT> squish_builder(cli);
+    squish_builder.needs_weights_ = false;
+    WGraph unsquished = squish_builder.MakeGraphFromEL(el_copy);
+    WGraph squished = squish_builder.SquishGraph(unsquished);
+
+    // the self loop and the redundant edges are gone, the lowest weight of redundant edges is kept
+    EXPECT_EQ (4, sorted.num_edges());
+    EXPECT_EQ (std::vector<WNode>({WNode(0, 1), WNode(1, 2)}),
+               std::vector<WNode>(sorted.out_neigh(3).begin(), sorted.out_neigh(3).end()));
+    EXPECT_EQ (2, sorted.out_neigh(3).begin()[1].w);
+    for (NodeID n = 0; n < sorted.num_nodes(); n++) {
+        std::vector<WNode> out(sorted.out_neigh(n).begin(), sorted.out_neigh(n).end());
+        std::vector<WNode> in(sorted.in_neigh(n).begin(), sorted.in_neigh(n).end());
+        EXPECT_EQ (std::vector<WNode>(squished.out_neigh(n).begin(), squished.out_neigh(n).end()), out);
+        EXPECT_EQ (std::vector<WNode>(squished.in_neigh(n).begin(), squished.in_neigh(n).end()), in);
+        for (size_t i = 0; i < out.size(); i++)
+            EXPECT_EQ (squished.out_neigh(n).begin()[i].w, out[i].w);
+        for (size_t i = 0; i < in.size(); i++)
+            EXPECT_EQ (squished.in_neigh(n).begin()[i].w, in[i].w);
+    }
+}
+
+TEST_F(RuntimeLibTest, DynamicGraphTest) {
+    Graph g = builtin_loadEdgesFromFile("../../test/graphs/test.el");
+    Graph batch = builtin_loadEdgesFromFile("../../test/graphs/test_batch.el");
+    // (1, 2) is already present and the self loop is dropped when the batch is loaded
+    EXPECT_EQ (2, builtin_insertBatch(g, batch));
+    EXPECT_EQ (9, g.num_edges());
+    EXPECT_EQ (std::vector<NodeID>({0, 3, 4}), std::vector<NodeID>(g.out_neigh(2).begin(), g.out_neigh(2).end()));
+    EXPECT_EQ (std::vector<NodeID>({4}), std::vector<NodeID>(g.in_neigh(1).begin(), g.in_neigh(1).end()));
+    Graph t = builtin_transpose(g);
+    EXPECT_EQ (g.in_degree(1), t.out_degree(1));
+
+    EXPECT_EQ (3, builtin_deleteBatch(g, batch));
+    EXPECT_EQ (6, g.num_edges());
+    EXPECT_EQ (std::vector<NodeID>({3, 4}), std::vector<NodeID>(g.out_neigh(1).begin(), g.out_neigh(1).end()));
+    EXPECT_EQ (0, t.in_degree(0));
+    EXPECT_EQ (6, g.get_offsets_()[g.num_nodes()]);
+
+    // the weight of an edge that is already present is overwritten
+    WGraph w = builtin_loadWeightedEdgesFromFile("../../test/graphs/test.wel");
+    WGraph w_batch = builtin_loadWeightedEdgesFromFile("../../test/graphs/test_batch.wel");
+    EXPECT_EQ (1, builtin_insertBatch(w, w_batch));
+    EXPECT_EQ (8, w.num_edges());
+    EXPECT_EQ (9, w.out_neigh(1).begin()[0].w);
+    EXPECT_EQ (9, w.in_neigh(2).begin()[0].w);
+    EXPECT_EQ (4, w.in_neigh(1).begin()[0].w);
+}
+
+TEST_F(RuntimeLibTest, DynamicMappedGraphTest) {
+    // the lists of a mapped graph are read only and shared with its copies, updates copy them first
+    Graph g = builtin_loadEdgesFromFile("../../test/graphs/4.el");
+    WriterBase<NodeID> w(g);
+    w.WriteGraph("4_dynamic.sg", true, true);
+    Graph mapped_g = builtin_loadEdgesFromFile("4_dynamic.sg");
+    Graph copy = mapped_g;
+    std::ofstream("4_dynamic_batch.el") << "0 13" << std::endl;
+    Graph batch = builtin_loadEdgesFromFile("4_dynamic_batch.el");
+    int64_t num_edges = mapped_g.num_edges();
+
+    EXPECT_EQ (1, builtin_deleteBatch(mapped_g, batch));
+    EXPECT_EQ (num_edges - 1, mapped_g.num_edges());
+    EXPECT_EQ (g.out_degree(0) - 1, mapped_g.out_degree(0));
+    EXPECT_EQ (std::vector<NodeID>(g.out_neigh(0).begin(), g.out_neigh(0).end()),
+               std::vector<NodeID>(copy.out_neigh(0).begin(), copy.out_neigh(0).end()));
+    EXPECT_EQ (1, builtin_insertBatch(mapped_g, batch));
+    // already present, merged without growing the list
+    EXPECT_EQ (0, builtin_insertBatch(mapped_g, batch));
+    EXPECT_EQ (num_edges, mapped_g.num_edges());
+    EXPECT_EQ (std::vector<NodeID>(g.out_neigh(0).begin(), g.out_neigh(0).end()),
+               std::vector<NodeID>(mapped_g.out_neigh(0).begin(), mapped_g.out_neigh(0).end()));
+
+    // a list that is still mapped, the edge is present
+    std::ofstream("4_dynamic_batch.el") << "7 12" << std::endl;
+    Graph present = builtin_loadEdgesFromFile("4_dynamic_batch.el");
+    EXPECT_EQ (0, builtin_insertBatch(mapped_g, present));
+    EXPECT_EQ (g.out_degree(7), mapped_g.out_degree(7));
+    std::remove("4_dynamic.sg");
+    std::remove("4_dynamic_batch.el");
+}
+
+TEST_F(RuntimeLibTest, BatchVerticesTest) {
+    Graph g = builtin_loadEdgesFromFile("../../test/graphs/test.el");
+    Graph batch = builtin_loadEdgesFromFile("../../test/graphs/test_batch.el");
+    // the self loop (3, 3) is dropped when the batch is loaded
+    VertexSubset<int> * touched = builtin_getBatchVertices(g, batch);
+    EXPECT_EQ (4, builtin_getVertexSetSize(touched));
+    EXPECT_EQ (5, touched->getVerticesRange());
+    EXPECT_EQ (false, touched->contains(3));
+    EXPECT_EQ (true, touched->contains(4));
+    delete touched;
+
+    // graphs from python (CSR arrays) keep their lists as given, the updates sort them
+    int32_t indptr[] = {0, 3, 4, 4};
+    NodeID indices[] = {2, 1, 2, 0};
+    Graph csr_batch = builtin_loadEdgesFromCSR(indptr, indices, 3, 4);
+    EXPECT_EQ (std::vector<NodeID>({2, 1, 2}), std::vector<NodeID>(csr_batch.out_neigh(0).begin(), csr_batch.out_neigh(0).end()));
+    EXPECT_EQ (3, builtin_insertBatch(g, csr_batch));
+}
+
+TEST_F(RuntimeLibTest, UnsortedCSRUpdateTest) {
+    // a self loop, a duplicate edge and lists out of order
+    int32_t indptr[] = {0, 4, 5, 6};
+    NodeID indices[] = {2, 0, 1, 2, 0, 1};
+    Graph g = builtin_loadEdgesFromCSR(indptr, indices, 3, 6);
+    EXPECT_EQ (4, g.out_degree(0));
+
+    // the first update sorts the lists and drops the duplicate, the self loop stays
+    int32_t batch_indptr[] = {0, 0, 2, 2};
+    NodeID batch_indices[] = {2, 0};
+    Graph batch = builtin_loadEdgesFromCSR(batch_indptr, batch_indices, 3, 2);
+    EXPECT_EQ (1, builtin_insertBatch(g, batch));
+    EXPECT_EQ (std::vector<NodeID>({0, 1, 2}), std::vector<NodeID>(g.out_neigh(0).begin(), g.out_neigh(0).end()));
+    EXPECT_EQ (std::vector<NodeID>({0, 2}), std::vector<NodeID>(g.out_neigh(1).begin(), g.out_neigh(1).end()));
+    EXPECT_EQ (std::vector<NodeID>({0, 1}), std::vector<NodeID>(g.in_neigh(2).begin(), g.in_neigh(2).end()));
+
+    int32_t delete_indptr[] = {0, 2, 2, 2};
+    NodeID delete_indices[] = {2, 2};
+    Graph deleted = builtin_loadEdgesFromCSR(delete_indptr, delete_indices, 3, 2);
+    EXPECT_EQ (1, builtin_deleteBatch(g, deleted));
+    EXPECT_EQ (std::vector<NodeID>({0, 1}), std::vector<NodeID>(g.out_neigh(0).begin(), g.out_neigh(0).end()));
+}
+
+TEST_F(RuntimeLibTest, EdgeAwareSegmentsTest) {
+    Graph g = builtin_loadEdgesFromFile("../../test/graphs/test.el");
+    // vertex 1 is the source of three of the seven edges
+    EXPECT_EQ (std::vector<NodeID>({0, 2, 4, 5}), g.segmentBoundaries(3, false, true));
+    EXPECT_EQ (std::vector<NodeID>({0, 2, 3, 5}), g.segmentBoundaries(3, true, true));
+    g.buildPullSegmentedGraphs("s1", 3, false, true);
+    EXPECT_EQ (3, g.getSegmentedGraph("s1", 0)->numEdges);
+    EXPECT_EQ (2, g.getSegmentedGraph("s1", 1)->numEdges);
+    EXPECT_EQ (2, g.getSegmentedGraph("s1", 2)->numEdges);
+
+    // by destination, equal vertex ranges would put five edges into the second segment
+    g.buildPushSegmentedGraphs("s2", 2, false, true);
+    EXPECT_EQ (4, g.getSegmentedGraph("s2", 0)->numEdges);
+    EXPECT_EQ (3, g.getSegmentedGraph("s2", 1)->numEdges);
+}
+
+TEST_F(RuntimeLibTest, ParallelSegmentBuildTest) {
+    Graph g = builtin_loadEdgesFromFile("../../test/graphs/4.el");
+    for (bool pull : {true, false}) {
+        GraphSegments<NodeID, NodeID> serial(3, false);
+        GraphSegments<NodeID, NodeID> parallel(3, false);
+        g.fillSegments(&serial, g.segmentBoundaries(3, true, pull), pull, false);
+        g.fillSegments(&parallel, g.segmentBoundaries(3, true, pull), pull, true);
+        for (int i = 0; i < 3; i++) {
+            auto s = serial.getSegmentedGraph(i);
+            auto p = parallel.getSegmentedGraph(i);
+            EXPECT_EQ (s->numEdges, p->numEdges);
+            EXPECT_EQ (std::vector<int>(s->graphId, s->graphId + s->numVertices),
+                       std::vector<int>(p->graphId, p->graphId + p->numVertices));
+            EXPECT_EQ (std::vector<int64_t>(s->vertexArray, s->vertexArray + s->numVertices + 1),
+                       std::vector<int64_t>(p->vertexArray, p->vertexArray + p->numVertices + 1));
+            EXPECT_EQ (std::vector<NodeID>(s->edgeArray, s->edgeArray + s->numEdges),
+                       std::vector<NodeID>(p->edgeArray, p->edgeArray + p->numEdges));
+        }
+    }
+}
+
+TEST_F(RuntimeLibTest, SegmentCacheTest) {
+    char cache_dir[] = "segment_cache_XXXXXX";
+    ASSERT_NE (nullptr, mkdtemp(cache_dir));
+    setenv("GRAPHIT_SEGMENT_CACHE", cache_dir, 1);
+    Graph g = builtin_loadEdgesFromFile("../../test/graphs/4.el");
+    g.buildPullSegmentedGraphs("built", 3);
+    SegmentCacheKey key = {g.contentHash(), g.num_nodes(), g.num_edges_directed(), 3, 0, 0, sizeof(NodeID)};
+    std::string cache_file = SegmentCache<NodeID, NodeID>::FileName(key);
+    std::ifstream written(cache_file);
+    EXPECT_EQ (true, written.good());
+
+    // the second build maps the file, a build with other parameters gets a file of its own
+    g.buildPullSegmentedGraphs("mapped", 3);
+    g.buildPullSegmentedGraphs("other", 2);
+    for (int i = 0; i < 3; i++) {
+        auto built = g.getSegmentedGraph("built", i);
+        auto mapped = g.getSegmentedGraph("mapped", i);
+        EXPECT_EQ (built->numEdges, mapped->numEdges);
+        EXPECT_EQ (std::vector<int>(built->graphId, built->graphId + built->numVertices),
+                   std::vector<int>(mapped->graphId, mapped->graphId + mapped->numVertices));
+        EXPECT_EQ (std::vector<NodeID>(built->edgeArray, built->edgeArray + built->numEdges),
+                   std::vector<NodeID>(mapped->edgeArray, mapped->edgeArray + mapped->numEdges));
+    }
+    EXPECT_EQ (g.num_edges_directed(), g.getSegmentedGraph("other", 0)->numEdges + g.getSegmentedGraph("other", 1)->numEdges);
+
+    // a file that does not pass its checksum is rebuilt
+    {
+        std::fstream corrupt(cache_file, std::ios::in | std::ios::out | std::ios::binary);
+        corrupt.seekp(sizeof(SegmentCacheHeader) + 2 * sizeof(int64_t));
+        corrupt.put(127);
+    }
+    g.buildPullSegmentedGraphs("rebuilt", 3);
+    EXPECT_EQ (std::vector<NodeID>(g.getSegmentedGraph("built", 0)->graphId, g.getSegmentedGraph("built", 0)->graphId + 1),
+               std::vector<NodeID>(g.getSegmentedGraph("rebuilt", 0)->graphId, g.getSegmentedGraph("rebuilt", 0)->graphId + 1));
+
+    unsetenv("GRAPHIT_SEGMENT_CACHE");
+    std::system((std::string("rm -rf ") + cache_dir).c_str());
+}
+
+TEST_F(RuntimeLibTest, AdaptiveDirectionTest) {
+    AdaptiveDirection direction(20);
+    // no measurements yet, the threshold decides
+    EXPECT_FALSE(direction.chooseDense(50, 2000, 2000));
+    EXPECT_TRUE(direction.chooseDense(150, 2000, 2000));
+
+    // a dense round costs 1 per unit of work, a sparse one 10
+    direction.record(true, 2000, 2000);
+    direction.record(false, 100, 1000);
+    EXPECT_FALSE(direction.chooseDense(150, 2000, 2000));
+    EXPECT_TRUE(direction.chooseDense(250, 2000, 2000));
+
+    // later rounds weigh half, sparse rounds now cost 6
+    direction.record(false, 100, 200);
+    EXPECT_TRUE(direction.chooseDense(350, 2000, 2000));
+    EXPECT_FALSE(direction.chooseDense(300, 2000, 2000));
+}
+
+TEST_F(RuntimeLibTest, FrontierBufferTest) {
+    FrontierBuffer<uintE> buffer;
+    long size;
+    uintE *empty = buffer.merge(&size);
+    EXPECT_EQ (0, size);
+    FrontierPool::release(empty);
+
+    parallel_for (int v = 0; v < 1000; v++) {
+        if (v % 3 == 0) buffer.local().push_back(v);
+    }
+    uintE *merged = buffer.merge(&size);
+    EXPECT_EQ (334, size);
+    std::vector<uintE> vertices(merged, merged + size);
+    std::sort(vertices.begin(), vertices.end());
+    for (long i = 0; i < size; i++)
+        EXPECT_EQ ((uintE) (3 * i), vertices[i]);
+    FrontierPool::release(merged);
+}
+
+TEST_F(RuntimeLibTest, NumaPlacementTest) {
+    // the placement happens before the initialization, the arrays come back zeroed and keep their size
+    int64_t num_elements = 3 * builtin_numaPageSize() / sizeof(float) + 5;
+    float *interleaved = new float[num_elements];
+    builtin_numaInterleave(interleaved, num_elements);
+    float *partitioned = new float[num_elements];
+    builtin_numaPartition(partitioned, num_elements);
+    for (int64_t i = 0; i < num_elements; i++) {
+        EXPECT_EQ (0, interleaved[i]);
+        EXPECT_EQ (0, partitioned[i]);
+    }
+    delete[] interleaved;
+    delete[] partitioned;
+}
+
+TEST_F(RuntimeLibTest, HugePageAllocatorTest) {
+    // arrays of at least one huge page start on a huge page boundary
+    size_t num_elements = 3 * HugePageAllocator::kHugePageSize / sizeof(int) + 7;
+    int *large = HugePageAllocator::Allocate<int>(num_elements);
+    EXPECT_EQ (0, reinterpret_cast<uintptr_t>(large) % HugePageAllocator::kHugePageSize);
+    parallel_for (size_t i = 0; i < num_elements; i++) large[i] = i;
+    EXPECT_EQ ((int) num_elements - 1, large[num_elements - 1]);
+    EXPECT_LE (HugePageAllocator::BackedBytes(large, num_elements * sizeof(int)), num_elements * sizeof(int));
+    HugePageAllocator::Free(large);
+
+    int *small = HugePageAllocator::Allocate<int>(16);
+    small[15] = 15;
+    EXPECT_EQ (15, small[15]);
+    HugePageAllocator::Free(small);
+
+    std::shared_ptr<double> shared(HugePageAllocator::Allocate<double>(num_elements),
+                                   HugePageAllocator::Deleter<double>());
+    shared.get()[num_elements - 1] = 1.0;
+    EXPECT_EQ (1.0, shared.get()[num_elements - 1]);
+}
+
+static long parallelSum(const std::vector<long> &values, long begin, long end) {
+    if (end - begin <= 16) {
+        long sum = 0;
+        for (long i = begin; i < end; i++) sum += values[i];
+        return sum;
+    }
+    long mid = begin + (end - begin) / 2, left = 0, right = 0;
+    builtin_parallelInvoke([&] { left = parallelSum(values, begin, mid); },
+                           [&] { right = parallelSum(values, mid, end); });
+    return left + right;
+}
+
+TEST_F(RuntimeLibTest, WorkStealingTest) {
+    // every index is visited exactly once, also by loops nested in the loop body
+    std::vector<std::atomic<int>> visits(10000);
+    for (auto &visit : visits) visit = 0;
+    builtin_parallelFor(0, 100, [&] (int64_t i) {
+        WorkStealingScheduler::get().parallelFor(i * 100, (i + 1) * 100, 7, [&] (int64_t j) { visits[j]++; });
+    }, 3);
+    for (auto &visit : visits)
+        EXPECT_EQ (1, visit.load());
+
+    std::vector<long> values(10000);
+    for (long i = 0; i < 10000; i++) values[i] = i;
+    EXPECT_EQ (10000L * 9999 / 2, parallelSum(values, 0, 10000));
+    long left = 0, right = 0;
+    WorkStealingScheduler::get().invoke([&] { left = parallelSum(values, 0, 5000); },
+                                        [&] { right = parallelSum(values, 5000, 10000); });
+    EXPECT_EQ (10000L * 9999 / 2, left + right);
+}
+
+// waits (at most a few seconds) until flag is set by another thread
+static bool waitFor(const std::atomic<bool> &flag) {
+    for (int i = 0; i < 5000 && !flag.load(); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return flag.load();
+}
+
+TEST_F(RuntimeLibTest, WorkStealingPoolTest) {
+    // a pool of its own, graphit_test runs the runtime's scheduler with one worker
+    WorkStealingScheduler scheduler(3);
+    EXPECT_EQ (3, scheduler.numWorkers());
+    // the workers go to sleep first, the fork has to wake one up
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // g is stolen while f waits for it, and forks a task that f's thread takes while joining
+    std::thread::id forker = std::this_thread::get_id();
+    std::atomic<bool> g_started(false), inner_started(false);
+    std::thread::id g_thread, inner_thread;
+    bool g_saw_inner = false;
+    scheduler.invoke([&] { EXPECT_TRUE (waitFor(g_started)); },
+                     [&] {
+                         g_thread = std::this_thread::get_id();
+                         g_started = true;
+                         scheduler.invoke([&] { g_saw_inner = waitFor(inner_started); },
+                                          [&] { inner_thread = std::this_thread::get_id(); inner_started = true; });
+                     });
+    EXPECT_NE (forker, g_thread);
+    EXPECT_TRUE (g_saw_inner);
+    EXPECT_NE (g_thread, inner_thread);
+
+    // every index once, and the loop is shared with the workers
+    std::vector<std::atomic<int>> visits(100000);
+    for (auto &visit : visits) visit = 0;
+    std::mutex lock;
+    std::set<std::thread::id> threads;
+    scheduler.parallelFor(0, 100000, 64, [&] (int64_t i) {
+        visits[i]++;
+        if (i % 64 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+            std::lock_guard<std::mutex> guard(lock);
+            threads.insert(std::this_thread::get_id());
+        }
+    });
+    for (auto &visit : visits)
+        EXPECT_EQ (1, visit.load());
+    EXPECT_LT (1, threads.size());
+
+    // forks nested deeper than a deque holds run on the forking thread
+    std::atomic<int> calls(0);
+    std::function<void(int)> chain = [&] (int depth) {
+        calls++;
+        if (depth > 0)
+            scheduler.invoke([&] { chain(depth - 1); }, [&] { calls++; });
+    };
+    chain(3000);
+    EXPECT_EQ (6001, calls.load());
+}
+
+TEST_F(RuntimeLibTest, ThreadControlTest) {
+    // two packages of two cores with two hardware threads each, siblings are numbered 4 apart
+    std::vector<ThreadControl::Cpu> cpus;
+    for (int id = 0; id < 8; id++)
+        cpus.push_back({id, (id % 4) / 2, id % 2});
+    EXPECT_EQ (std::vector<int>({0, 4, 1, 5, 2, 6, 3, 7}),
+               ThreadControl::orderCpus(cpus, ThreadControl::kCompact, true));
+    EXPECT_EQ (std::vector<int>({0, 2, 1, 3, 4, 6, 5, 7}),
+               ThreadControl::orderCpus(cpus, ThreadControl::kScatter, true));
+    EXPECT_EQ (std::vector<int>({0, 1, 2, 3}), ThreadControl::orderCpus(cpus, ThreadControl::kCompact, false));
+    EXPECT_EQ (std::vector<int>({0, 2, 1, 3}), ThreadControl::orderCpus(cpus, ThreadControl::kScatter, false));
+
+    // the flags change the whole process, the later tests get the workers and the CPUs back
+    int num_workers = builtin_getNumThreads();
+    cpu_set_t allowed;
+    ASSERT_EQ (0, sched_getaffinity(0, sizeof(allowed), &allowed));
+
+    // the runtime flags are removed, the arguments of the program keep their positions
+    char *argv[] = {(char*) "prog", (char*) "--threads", (char*) "2", (char*) "graph.el",
+                    (char*) "--affinity", (char*) "compact", (char*) "10", nullptr};
+    int argc = 7;
+    builtin_parseRuntimeFlags(argc, argv);
+    EXPECT_EQ (3, argc);
+    EXPECT_EQ (std::string("graph.el"), argv[1]);
+    EXPECT_EQ (std::string("10"), argv[2]);
+    EXPECT_EQ (nullptr, argv[3]);
+    EXPECT_FALSE (ThreadControl::get().topology().empty());
+
+    // the scheduler workers are pinned to their own CPU, not to the one of the forking thread
+    std::vector<int> order = ThreadControl::orderCpus(ThreadControl::get().topology(), ThreadControl::kCompact, true);
+    WorkStealingScheduler scheduler(2);
+    std::thread::id forking = std::this_thread::get_id();
+    std::mutex lock;
+    std::vector<cpu_set_t> worker_cpus;
+    auto collect = [&] (int64_t) {
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+        cpu_set_t worker;
+        pthread_getaffinity_np(pthread_self(), sizeof(worker), &worker);
+        std::lock_guard<std::mutex> guard(lock);
+        if (std::this_thread::get_id() != forking)
+            worker_cpus.push_back(worker);
+    };
+    scheduler.parallelFor(0, 1000, 1, collect);
+    for (cpu_set_t &worker : worker_cpus) {
+        EXPECT_EQ (1, CPU_COUNT(&worker));
+        EXPECT_TRUE (CPU_ISSET(order[1 % order.size()], &worker));
+    }
+
+    builtin_setAffinity("none");
+    builtin_setNumThreads(num_workers);
+    EXPECT_EQ (num_workers, builtin_getNumThreads());
+    cpu_set_t main_cpus;
+    ASSERT_EQ (0, sched_getaffinity(0, sizeof(main_cpus), &main_cpus));
+    EXPECT_TRUE (CPU_EQUAL(&allowed, &main_cpus));
+    worker_cpus.clear();
+    scheduler.parallelFor(0, 1000, 1, collect);
+    for (cpu_set_t &worker : worker_cpus)
+        EXPECT_TRUE (CPU_EQUAL(&allowed, &worker));
+}
+
+struct SimdPullTestVertex {
+    float rank;
+    int degree;
+};
+
+// the members graphitc generates for rank[src] / degree[src] over an array of structs, and for an int vector
+struct SimdPullTestFunc {
+    SimdPullTestVertex *vertices;
+    int *labels;
+
+    float pullValue (NodeID src) {
+        return vertices[src].rank / vertices[src].degree;
+    }
+    SimdVector<float> pullValue (const SimdIndex &src) {
+        return SimdVector<float>::gather(&vertices[0].rank, src, sizeof(vertices[0]))
+               / SimdVector<float>::gather(&vertices[0].degree, src, sizeof(vertices[0]));
+    }
+};
+
+struct SimdPullTestMinFunc {
+    int *labels;
+
+    int pullValue (NodeID src) {
+        return labels[src] - 1;
+    }
+    SimdVector<int> pullValue (const SimdIndex &src) {
+        return SimdVector<int>::gather(labels, src) - 1;
+    }
+};
+
+TEST_F(RuntimeLibTest, SimdPullTest) {
+    std::vector<SimdPullTestVertex> vertices(100);
+    std::vector<int> labels(100);
+    for (int i = 0; i < 100; i++) {
+        vertices[i].rank = i;
+        vertices[i].degree = 2;
+        labels[i] = 1000 - 7 * i;
+    }
+    // in-neighbors in a scattered order, two full vectors and a scalar tail
+    std::vector<NodeID> neighbors;
+    for (int i = 0; i < 2 * kSimdLanes + 3; i++)
+        neighbors.push_back((i * 37) % 100);
+    float expected_sum = 0;
+    int expected_min = 1000;
+    for (NodeID s : neighbors) {
+        expected_sum += s / 2.0f;
+        expected_min = std::min(expected_min, labels[s] - 1);
+    }
+
+    SimdPullTestFunc sum_func = {vertices.data(), labels.data()};
+    EXPECT_EQ (expected_sum, builtin_simdPullSum<float>(neighbors.data(), neighbors.data() + neighbors.size(), sum_func));
+    EXPECT_EQ (0.0f, builtin_simdPullSum<float>(neighbors.data(), neighbors.data(), sum_func));
+    SimdPullTestMinFunc min_func = {labels.data()};
+    EXPECT_EQ (expected_min, builtin_simdPullMin<int>(neighbors.data(), neighbors.data() + neighbors.size(), min_func));
+    EXPECT_EQ (std::numeric_limits<int>::max(), builtin_simdPullMin<int>(neighbors.data(), neighbors.data(), min_func));
+    EXPECT_EQ (labels[37] - 1, builtin_simdPullMin<int>(neighbors.data() + 1, neighbors.data() + 2, min_func));
+}
@@ -0,0 +1,4 @@
+1 2
+4 1
+3 3
+2 0
@@ -87,6 +87,13 @@ class TestGraphitCompiler(unittest.TestCase):
         self.assertEqual(len(ranks), 4)
         self.assertTrue(abs(np.sum(ranks)-1.0) < 0.001)
 
+    def test_pybind_cc_incremental(self):
+        module = graphit.compile_and_load(GRAPHIT_SOURCE_DIRECTORY + "/apps/cc_incremental_export.gt")
+        graph = csr_matrix(([1, 1, 1, 1, 1, 1], [1, 0, 3, 2, 5, 4], [0, 1, 2, 3, 4, 5, 6]))
+        self.assertEqual(list(module.set_graph(graph)), [0, 0, 2, 2, 4, 4])
+        batch = csr_matrix(([1, 1], [2, 1], [0, 0, 1, 2, 2, 2, 2]))
+        self.assertEqual(list(module.insert_edges(batch)), [0, 0, 0, 0, 4, 4])
+
     def test_pybind_pr_with_vector_input(self):
         module = graphit.compile_and_load(self.root_test_input_dir + "export_pagerank_with_vector_input.gt")
         graph = csr_matrix(([0, 0, 0, 0, 0, 0], [1, 2, 3, 0, 0, 0], [0, 3, 4, 5, 6]))
@@ -311,6 +311,9 @@ class TestGraphitCompiler(unittest.TestCase):
     def test_simple_edgeset_transpose(self):
         self.basic_compile_exec_test("simple_edgeset_transpose.gt")
 
+    def test_simple_edgeset_insert_batch_expect(self):
+        self.expect_output_val("simple_edgeset_insert_batch.gt", 3215)
+
     def test_sssp_with_tracking(self):
         self.basic_compile_exec_test("sssp.gt")
 
@@ -81,13 +81,13 @@ class TestGraphitCompiler(unittest.TestCase):
 
     # compiles the program with a separate input algorithm file and input schedule file
     # allows us to unit test various different schedules with the same algorithm
-    def basic_compile_test_with_separate_algo_schedule_files(self, input_algo_file, input_schedule_file):
+    def basic_compile_test_with_separate_algo_schedule_files(self, input_algo_file, input_schedule_file, graphitc_flags=""):
         input_algos_path = GRAPHIT_SOURCE_DIRECTORY + '/test/input/'
         input_schedules_path = GRAPHIT_SOURCE_DIRECTORY + '/test/input_with_schedules/'
         print ("current directory: " + os.getcwd())
         algo_file = input_algos_path + input_algo_file
         schedule_file = input_schedules_path + input_schedule_file
-        compile_cmd = "python graphitc.py -a " + algo_file + " -f " + schedule_file + " -o test.cpp"
+        compile_cmd = "python graphitc.py -a " + algo_file + " -f " + schedule_file + " -o test.cpp" + graphitc_flags
         print (compile_cmd)
         subprocess.check_call(compile_cmd, shell=True)
         cpp_compile_cmd = self.cpp_compiler + " -g -std=c++11 -I "+self.include_path+ " " + self.numa_flags + " test.cpp -o test.o"
@@ -185,9 +185,10 @@ class TestGraphitCompiler(unittest.TestCase):
 
 
 
-    def bfs_verified_test(self, input_file_name, use_separate_algo_file=False):
+    def bfs_verified_test(self, input_file_name, use_separate_algo_file=False, graphitc_flags=""):
         if use_separate_algo_file:
-            self.basic_compile_test_with_separate_algo_schedule_files("bfs_with_filename_arg.gt", input_file_name)
+            self.basic_compile_test_with_separate_algo_schedule_files("bfs_with_filename_arg.gt", input_file_name,
+                                                                      graphitc_flags)
         else:
             self.basic_compile_test(input_file_name)
         os.chdir("..");
@@ -252,9 +253,9 @@ class TestGraphitCompiler(unittest.TestCase):
         self.assertEqual(test_flag, True)
         os.chdir("bin")
 
-    def sssp_verified_test(self, input_file_name, use_separate_algo_file=True):
+    def sssp_verified_test(self, input_file_name, use_separate_algo_file=True, algo_file_name="sssp.gt"):
         if use_separate_algo_file:
-            self.basic_compile_test_with_separate_algo_schedule_files("sssp.gt", input_file_name)
+            self.basic_compile_test_with_separate_algo_schedule_files(algo_file_name, input_file_name)
         else:
             self.basic_compile_test(input_file_name)
         os.chdir("..");
@@ -274,9 +275,10 @@ class TestGraphitCompiler(unittest.TestCase):
         self.assertEqual(test_flag, True)
         os.chdir("bin")
 
-    def pr_verified_test(self, input_file_name, use_separate_algo_file=False, use_segment_argv=False):
+    def pr_verified_test(self, input_file_name, use_separate_algo_file=False, use_segment_argv=False, graphitc_flags=""):
         if use_separate_algo_file:
-            self.basic_compile_test_with_separate_algo_schedule_files("pagerank_with_filename_arg.gt", input_file_name)
+            self.basic_compile_test_with_separate_algo_schedule_files("pagerank_with_filename_arg.gt", input_file_name,
+                                                                      graphitc_flags)
         else:
             self.basic_compile_test(input_file_name)
 
@@ -398,12 +400,58 @@ class TestGraphitCompiler(unittest.TestCase):
     def test_bfs_hybrid_dense_parallel_cas_segment_verified(self):
         self.bfs_verified_test("bfs_hybrid_dense_parallel_cas_segment.gt", True)
 
+    def test_bfs_hybrid_dense_parallel_adaptive_verified(self):
+        self.bfs_verified_test("bfs_hybrid_dense_parallel_adaptive.gt", True)
+
     def test_bfs_push_parallel_cas_verified(self):
         self.bfs_verified_test("bfs_push_parallel_cas.gt", True)
 
     def test_bfs_pull_parallel_verified(self):
         self.bfs_verified_test("bfs_pull_parallel.gt", True)
 
+    def test_bfs_push_edge_parallel_cas_verified(self):
+        self.bfs_verified_test("bfs_push_edge_parallel_cas.gt", True)
+
+    def test_bfs_push_parallel_thread_local_frontier_verified(self):
+        self.bfs_verified_test("bfs_push_parallel_thread_local_frontier.gt", True)
+
+    def test_bfs_push_parallel_thread_local_frontier_work_stealing_verified(self):
+        self.bfs_verified_test("bfs_push_parallel_thread_local_frontier.gt", True, " -w")
+
+    def test_bfs_hybrid_dense_parallel_byte_compressed_verified(self):
+        self.bfs_verified_test("bfs_hybrid_dense_parallel_byte_compressed.gt", True)
+
+    def test_bfs_hybrid_dense_apply_counters(self):
+        self.basic_compile_test_with_separate_algo_schedule_files("bfs_with_filename_arg.gt",
+                                                                  "bfs_hybrid_dense_parallel_cas.gt", " -c")
+        os.chdir("..")
+        if os.path.isfile("counters.csv"):
+            os.remove("counters.csv")
+        cmd = "GRAPHIT_APPLY_COUNTERS=counters.csv ./bin/test.o " + GRAPHIT_SOURCE_DIRECTORY + "/test/graphs/4.el > verifier_input"
+        print (cmd)
+        subprocess.call(cmd, shell=True)
+        with open("counters.csv") as counters:
+            lines = counters.read().rstrip().split("\n")
+        os.chdir("bin")
+        self.assertEqual(lines[0], "label,round,seconds,frontier_in,frontier_out,frontier_edges,direction")
+        self.assertTrue(len(lines) > 1)
+        for line in lines[1:]:
+            fields = line.split(",")
+            self.assertEqual(fields[0], "s1")
+            self.assertTrue(fields[6] in ["push", "pull"])
+
+    def test_bfs_hybrid_dense_scaling(self):
+        self.basic_compile_test_with_separate_algo_schedule_files("bfs_with_filename_arg.gt",
+                                                                  "bfs_hybrid_dense_parallel_cas.gt", " -c")
+        os.chdir("..")
+        cmd = "./bin/test.o --scaling 1,2 --affinity compact " + GRAPHIT_SOURCE_DIRECTORY + "/test/graphs/4.el"
+        print (cmd)
+        lines = self.get_command_output(cmd).rstrip().split("\n")
+        os.chdir("bin")
+        self.assertEqual(lines[0], "label,threads,seconds,speedup")
+        self.assertEqual([line.split(",")[0:2] for line in lines[1:]],
+                         [["s1", "1"], ["s1", "2"], ["total", "1"], ["total", "2"]])
+
     def test_bfs_pull_edge_aware_parallel_verified(self):
         self.bfs_verified_test("bfs_pull_edge_aware_parallel.gt", True)
 
@@ -442,9 +490,24 @@ class TestGraphitCompiler(unittest.TestCase):
     def test_sssp_push_parallel_cas_verified(self):
         self.sssp_verified_test("sssp_push_parallel_cas.gt", True)
 
+    def test_sssp_push_edge_parallel_cas_verified(self):
+        self.sssp_verified_test("sssp_push_edge_parallel_cas.gt", True)
+
+    def test_sssp_push_edge_parallel_thread_local_frontier_verified(self):
+        self.sssp_verified_test("sssp_push_edge_parallel_thread_local_frontier.gt", True)
+
+    def test_sssp_push_parallel_nibble_compressed_verified(self):
+        self.sssp_verified_test("sssp_push_parallel_nibble_compressed.gt", True)
+
+    def test_sssp_push_parallel_rcm_order_verified(self):
+        self.sssp_verified_test("sssp_push_parallel_rcm_order.gt", True)
+
     def test_sssp_hybrid_denseforward_parallel_cas_verified(self):
         self.sssp_verified_test("sssp_hybrid_denseforward_parallel_cas.gt", True)
 
+    def test_sssp_hybrid_denseforward_parallel_threshold_verified(self):
+        self.sssp_verified_test("sssp_hybrid_denseforward_parallel_threshold.gt", True)
+
     def test_sssp_hybrid_dense_parallel_cas_verified(self):
         self.sssp_verified_test("sssp_hybrid_dense_parallel_cas.gt", True)
 
@@ -454,9 +517,15 @@ class TestGraphitCompiler(unittest.TestCase):
     def test_sssp_push_parallel_sliding_queue_verified(self):
         self.sssp_verified_test("sssp_push_parallel_sliding_queue.gt", True)
 
+    def test_sssp_delta_stepping_parallel_verified(self):
+        self.sssp_verified_test("sssp_delta_stepping_parallel.gt", True, "sssp_delta_stepping.gt")
+
     def test_pagerank_parallel_pull_expect(self):
         self.pr_verified_test("pagerank_pull_parallel.gt", True)
 
+    def test_pagerank_parallel_pull_work_stealing_expect(self):
+        self.pr_verified_test("pagerank_pull_parallel.gt", True, False, " -w")
+
     def test_pagerank_parallel_hybrid_dense_expect(self):
         self.pr_verified_test("pagerank_hybrid_dense.gt", True)
 
@@ -466,9 +535,15 @@ class TestGraphitCompiler(unittest.TestCase):
     def test_pagerank_parallel_pull_load_balance_expect(self):
         self.pr_verified_test("pagerank_pull_parallel_load_balance.gt", True)
 
+    def test_pagerank_parallel_pull_simd_expect(self):
+        self.pr_verified_test("pagerank_pull_parallel_simd.gt", True)
+
     def test_pagerank_parallel_pull_segment_expect(self):
         self.pr_verified_test("pagerank_pull_parallel_segment.gt", True)
 
+    def test_pagerank_parallel_pull_edge_aware_segment_expect(self):
+        self.pr_verified_test("pagerank_pull_parallel_edge_aware_segment.gt", True)
+
     def test_pagerank_parallel_pull_segment_argv_expect(self):
         self.pr_verified_test("pagerank_pull_parallel_segment_argv.gt", True, True)
 
@@ -480,6 +555,13 @@ class TestGraphitCompiler(unittest.TestCase):
         if self.numa_flags:
             self.pr_verified_test("pagerank_pull_parallel_numa_one_seg.gt", True)
 
+    def test_pagerank_parallel_pull_numa_placement_expect(self):
+        self.pr_verified_test("pagerank_pull_parallel_numa_placement.gt", True)
+
+    def test_pagerank_parallel_pull_numa_replicated_expect(self):
+        if self.numa_flags:
+            self.pr_verified_test("pagerank_pull_parallel_numa_replicated.gt", True)
+
     def test_cf_parallel_expect(self):
         self.cf_verified_test("cf_pull_parallel.gt", True)
 
@@ -511,6 +593,12 @@ class TestGraphitCompiler(unittest.TestCase):
     def test_prdelta_parallel_hybrid_segment_expect(self):
         self.pr_delta_verified_test("pagerank_delta_hybrid_dense_parallel_segment.gt", True)
 
+    def test_prdelta_parallel_hybrid_denseforward_segment_expect(self):
+        self.pr_delta_verified_test("pagerank_delta_hybrid_denseforward_parallel_segment.gt", True)
+
+    def test_prdelta_parallel_hybrid_denseforward_edge_aware_expect(self):
+        self.pr_delta_verified_test("pagerank_delta_hybrid_denseforward_parallel_edge_aware.gt", True)
+
     def test_prdelta_parallel_hybrid_numa_expect(self):
         if self.numa_flags:
             self.pr_delta_verified_test("pagerank_delta_hybrid_dense_parallel_numa.gt", True)